@@ -0,0 +1,86 @@
+#ifndef ANIMATION_SYSTEM_HH
+#define ANIMATION_SYSTEM_HH
+
+#include "game/headers/animation/animator.hh"
+#include "game/headers/model/model.hh"
+#include "game/headers/renderer/model-renderer.hh"
+#include "game/headers/utility/memory-tracker.hh"
+
+#include "external/glm/glm/glm.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct AnimationSettings {
+	// Instances closer to the camera are evaluated every frame
+	float full_rate_distance{10.0f};
+	// Farther instances are evaluated this often per second at twice the distance, half as often at four times it, and so on
+	float distant_update_rate{30.0f};
+	// Instances are evaluated at least this often per second, however far they are
+	float min_update_rate{5.0f};
+	// Fewer instances due in a frame are evaluated on the calling thread
+	std::size_t parallel_threshold{4u};
+};
+
+struct AnimationStats {
+	std::size_t instance_count;
+	// Instances evaluated by the last update
+	std::size_t evaluated_count;
+	double update_ms;
+};
+
+/**
+ * Animates instances of skinned models, and hands their skinning matrices to the renderer.
+ * Every instance's clips advance each frame, but distant instances are evaluated less often,
+ * so the cost of a crowd grows with how close it is, rather than with its size.
+ */
+class AnimationSystem {
+public:
+	AnimationSystem(ModelRenderer& renderer, AnimationSettings settings = {});
+
+	/**
+	 * Animates a renderer's instance of the model, from the given position.
+	 * Throws std::invalid_argument if the model has no skeleton.
+	 */
+	void addInstance(ModelInstanceId instance, std::shared_ptr<const Model> model, const glm::vec3& position);
+	void removeInstance(ModelInstanceId instance);
+	// The distance from the camera sets how often the instance is evaluated
+	void setInstancePosition(ModelInstanceId instance, const glm::vec3& position);
+
+	// Returns false if the instance is not animated, or its model has no such clip
+	bool play(ModelInstanceId instance, const std::string& clip, float fade_duration = 0.2f, bool loop = true);
+
+	// Call it once per frame, before the renderer draws
+	void update(float frame_seconds, const glm::vec3& camera_position);
+
+	const AnimationStats& getStats() const;
+	const AnimationSettings& getSettings() const;
+private:
+	struct AnimatedInstance {
+		ModelInstanceId instance;
+		Animator animator;
+		glm::vec3 position;
+		float time_since_evaluation;
+	};
+
+	ModelRenderer& renderer_;
+	AnimationSettings settings_;
+
+	// Instances are packed, a removed instance's slot is filled by the last one
+	std::vector<AnimatedInstance> instances_;
+	std::unordered_map<ModelInstanceId, std::size_t> instance_slots_;
+	// Slots evaluated by the current update
+	std::vector<std::size_t> due_slots_;
+
+	AnimationStats stats_{};
+	MemoryRecord memory_;
+
+	// Seconds between evaluations of an instance at the distance
+	float getUpdateInterval(float distance) const;
+	void updateMemoryRecord();
+};
+
+#endif // ANIMATION_SYSTEM_HH
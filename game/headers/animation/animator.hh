@@ -0,0 +1,62 @@
+#ifndef ANIMATOR_HH
+#define ANIMATOR_HH
+
+#include "game/headers/animation/clip-cursor.hh"
+#include "game/headers/animation/pose.hh"
+#include "game/headers/model/model.hh"
+#include "game/headers/model/skeleton.hh"
+
+#include "external/glm/glm/glm.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Plays a skinned model's clips, cross-fading from one clip to the next, and computes the model's skinning matrices.
+ * Advancing is cheap, evaluating samples the clips, so it can be done less often than every frame.
+ */
+class Animator {
+public:
+	// Holds the bind pose until a clip is played
+	explicit Animator(std::shared_ptr<const Model> model);
+
+	/**
+	 * Starts the clip, fading out the current one over the given time.
+	 * Returns false, and keeps playing the current clip, if the model has no such clip.
+	 */
+	bool play(const std::string& name, float fade_duration = 0.2f, bool loop = true, float speed = 1.0f);
+	void advance(float seconds);
+
+	// Samples, and blends the playing clips, and computes the skinning matrices
+	void evaluate();
+	// One per joint of the model's skeleton, valid since the last evaluate()
+	const std::vector<glm::mat4>& getSkinningMatrices() const;
+
+	const std::shared_ptr<const Model>& getModel() const;
+	// Poses, cursors, and matrices
+	std::size_t getMemorySize() const;
+private:
+	struct Playback {
+		const CompressedAnimationClip* clip{nullptr};
+		float time{0.0f};
+		float speed{1.0f};
+		bool loop{true};
+		ClipCursor cursor;
+	};
+
+	std::shared_ptr<const Model> model_;
+	Playback current_;
+	// The clip faded out, until the fade ends
+	Playback previous_;
+	float fade_time_{0.0f};
+	float fade_duration_{0.0f};
+
+	Pose pose_;
+	Pose previous_pose_;
+	std::vector<glm::mat4> joint_transforms_;
+	std::vector<glm::mat4> skinning_matrices_;
+};
+
+#endif // ANIMATOR_HH
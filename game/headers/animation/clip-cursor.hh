@@ -0,0 +1,40 @@
+#ifndef CLIP_CURSOR_HH
+#define CLIP_CURSOR_HH
+
+#include "game/headers/animation/pose.hh"
+#include "game/headers/model/compressed-animation.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Decompresses the keys of a clip around a position into channel arrays, and remembers the key
+ * every track stopped at. Playback moving forward finds its next keys within a few steps, only a jump
+ * backwards, as when a clip loops, or far ahead searches the track.
+ */
+class ClipCursor {
+public:
+	// Restarts from the first keys when the clip is not the one seeked last
+	void seek(const CompressedAnimationClip& clip, float frame_position);
+
+	// Keys at, or before, and after the position, as poses of the clip's skeleton
+	const Pose& getFromKeys() const;
+	const Pose& getToKeys() const;
+	// Weight of the later key, one per joint, padded like a pose's channels
+	const float* getTranslationWeights() const;
+	const float* getRotationWeights() const;
+	const float* getScaleWeights() const;
+
+	std::size_t getMemorySize() const;
+private:
+	const CompressedAnimationClip* clip_{nullptr};
+	// Key at, or before the position, of every joint's translation, rotation, and scale track in turn
+	std::vector<std::uint32_t> keys_;
+	Pose from_keys_;
+	Pose to_keys_;
+	// Translation, rotation, and scale weights, one padded array after the other
+	std::vector<float> weights_;
+};
+
+#endif // CLIP_CURSOR_HH
@@ -0,0 +1,45 @@
+#ifndef POSE_MATH_HH
+#define POSE_MATH_HH
+
+#include "game/headers/animation/clip-cursor.hh"
+#include "game/headers/animation/pose.hh"
+#include "game/headers/model/compressed-animation.hh"
+#include "game/headers/model/skeleton.hh"
+
+#include "external/glm/glm/glm.hpp"
+
+#include <vector>
+
+/**
+ * Pose sampling, blending, and skinning matrices. Blending runs on every channel array
+ * with the widest SIMD vectors the build targets, see simd.hh.
+ */
+namespace pose_math {
+
+	/**
+	 * Decompresses the clip's keys around the time, in seconds, and interpolates them. Looping clips
+	 * wrap around, others hold their first, and last frames. Rotations are normalized linear interpolations.
+	 * The cursor keeps the playback's place in the clip from one sample to the next.
+	 */
+	void sampleClip(const CompressedAnimationClip& clip, float time, bool loop, ClipCursor& cursor, Pose& pose);
+
+	/**
+	 * Interpolates from one pose towards another, the result may be either of them.
+	 * Every pose must have the same number of joints.
+	 */
+	void blendPoses(const Pose& from, const Pose& to, float weight, Pose& result);
+
+	/**
+	 * Computes a skinning matrix per joint, from the pose's joints in the model's space, and the inverse bind matrices.
+	 * Joint transforms is scratch space for the joints' model space transforms, kept by the caller to avoid allocations.
+	 */
+	void computeSkinningMatrices(
+		const Skeleton& skeleton,
+		const Pose& pose,
+		std::vector<glm::mat4>& joint_transforms,
+		std::vector<glm::mat4>& skinning_matrices
+	);
+
+} // namespace pose_math
+
+#endif // POSE_MATH_HH
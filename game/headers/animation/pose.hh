@@ -0,0 +1,36 @@
+#ifndef POSE_HH
+#define POSE_HH
+
+#include "game/headers/model/skeleton.hh"
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Local transforms of every joint of a skeleton, each channel in its own array,
+ * the same layout as a clip's frame. Padding joints hold identity transforms.
+ */
+class Pose {
+public:
+	Pose() = default;
+	// Every joint starts with an identity transform
+	explicit Pose(std::size_t joint_count);
+	// The skeleton's bind pose
+	explicit Pose(const Skeleton& skeleton);
+
+	std::size_t getJointCount() const;
+	std::size_t getPaddedJointCount() const;
+
+	float* getChannel(JointChannel channel);
+	const float* getChannel(JointChannel channel) const;
+
+	JointTransform getJointTransform(std::size_t joint) const;
+	void setJointTransform(std::size_t joint, const JointTransform& transform);
+
+	std::size_t getMemorySize() const;
+private:
+	std::size_t joint_count_{0u};
+	std::vector<float> channels_;
+};
+
+#endif // POSE_HH
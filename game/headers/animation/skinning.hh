@@ -0,0 +1,29 @@
+#ifndef SKINNING_HH
+#define SKINNING_HH
+
+#include "game/headers/model/mesh.hh"
+
+#include "external/glm/glm/glm.hpp"
+
+#include <cstddef>
+
+/**
+ * Skinning on the CPU, the fallback for GPUs which cannot read joint matrices in the vertex shader.
+ */
+namespace skinning {
+
+	/**
+	 * Moves every vertex, and normal by the weighted joint matrices of its skin, texture coordinates are copied.
+	 * Skinning matrices has an entry for every joint of the skeleton.
+	 */
+	void skinVertices(
+		const Vertex* vertices,
+		const VertexSkin* skin,
+		std::size_t vertex_count,
+		const glm::mat4* skinning_matrices,
+		Vertex* skinned_vertices
+	);
+
+} // namespace skinning
+
+#endif // SKINNING_HH
@@ -15,6 +15,10 @@ public:
 private:
 	const BitmapFont& _font;
 	const Shader& _bitmap_shader;
+	ShaderUniform<glm::vec3> _color_uniform;
+	ShaderUniform<int> _tex_uniform;
+	ShaderUniform<glm::mat3> _pos_matrix_uniform;
+	ShaderUniform<glm::mat3> _tex_matrix_uniform;
 	float _screen_width_height;
 	unsigned int _vao;
 	unsigned int _vbo;
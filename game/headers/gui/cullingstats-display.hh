@@ -0,0 +1,28 @@
+#ifndef CULLINGSTATS_DISPLAY_HH
+#define CULLINGSTATS_DISPLAY_HH
+
+#include "external/glm/glm/glm.hpp"
+
+#include "game/headers/gui/element.hh"
+#include "game/headers/gui/font-renderer.hh"
+#include "game/headers/renderer/model-renderer.hh"
+
+#include <string>
+
+class CullingStatsDisplay : public Element {
+public:
+	CullingStatsDisplay(FontRenderer& font_renderer, const ModelRenderer& model_renderer, glm::vec2 pos, float font_size);
+
+	void draw() const override;
+private:
+	FontRenderer& font_renderer_;
+	const ModelRenderer& model_renderer_;
+	glm::vec2 pos_;
+	float font_size_;
+
+	std::string formatStats() const;
+};
+
+#include "game/sources/gui/cullingstats-display.inl"
+
+#endif // CULLINGSTATS_DISPLAY_HH
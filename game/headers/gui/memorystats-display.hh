@@ -0,0 +1,28 @@
+#ifndef MEMORYSTATS_DISPLAY_HH
+#define MEMORYSTATS_DISPLAY_HH
+
+#include "external/glm/glm/glm.hpp"
+
+#include "game/headers/gui/element.hh"
+#include "game/headers/gui/font-renderer.hh"
+#include "game/headers/utility/memory-tracker.hh"
+
+#include <string>
+
+class MemoryStatsDisplay : public Element {
+public:
+	MemoryStatsDisplay(FontRenderer& font_renderer, const MemoryTracker& memory_tracker, glm::vec2 pos, float font_size);
+
+	void draw() const override;
+private:
+	FontRenderer& font_renderer_;
+	const MemoryTracker& memory_tracker_;
+	glm::vec2 pos_;
+	float font_size_;
+
+	static std::string formatUsage(const MemoryUsage& usage, MemoryDomain domain);
+};
+
+#include "game/sources/gui/memorystats-display.inl"
+
+#endif // MEMORYSTATS_DISPLAY_HH
@@ -0,0 +1,55 @@
+#ifndef ANIMATION_COMPRESSOR_HH
+#define ANIMATION_COMPRESSOR_HH
+
+#include "game/headers/model/compressed-animation.hh"
+#include "game/headers/model/skeleton.hh"
+
+#include <cstddef>
+#include <string>
+
+struct AnimationCompressionSettings {
+	// Furthest a skinned vertex may move from where the uncompressed clip puts it, in the model's units
+	float max_error{0.001f};
+	// Distance of the skinned vertices from their joints, errors are measured at points this far away
+	float shell_distance{0.05f};
+};
+
+struct AnimationCompressionReport {
+	std::string clip;
+	std::size_t raw_bytes;
+	std::size_t compressed_bytes;
+	// Every track's frames, and the keys kept of them
+	std::size_t frame_count;
+	std::size_t key_count;
+	// Furthest any joint's shell moved at any frame, in the model's units
+	float max_error;
+
+	float getRatio() const;
+};
+
+/**
+ * Compresses resampled clips: keys are quantized, and every track keeps only the keys its frames cannot
+ * be interpolated without. A joint's tolerance starts as the maximum error divided over the longest chain
+ * of joints through it, scaled by how far its descendants reach, and is relaxed while the clip's
+ * measured error stays within the maximum.
+ */
+namespace animation_compressor {
+
+	CompressedAnimationClip compress(
+		const AnimationClip& clip,
+		const Skeleton& skeleton,
+		const AnimationCompressionSettings& settings,
+		AnimationCompressionReport& report
+	);
+
+	// Furthest any joint's shell is from where the uncompressed clip puts it, at any of the clip's frames
+	float measureError(
+		const AnimationClip& clip,
+		const CompressedAnimationClip& compressed,
+		const Skeleton& skeleton,
+		float shell_distance
+	);
+
+} // namespace animation_compressor
+
+#endif // ANIMATION_COMPRESSOR_HH
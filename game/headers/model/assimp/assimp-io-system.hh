@@ -0,0 +1,45 @@
+#ifndef ASSIMP_IO_SYSTEM_HH
+#define ASSIMP_IO_SYSTEM_HH
+
+#include "external/assimp/include/assimp/IOStream.hpp"
+#include "external/assimp/include/assimp/IOSystem.hpp"
+
+#include "game/headers/utility/virtual-file-system.hh"
+
+#include <cstddef>
+
+/**
+ * Read-only Assimp stream over a file of the virtual file system.
+ */
+class AssimpAssetStream : public Assimp::IOStream {
+public:
+	explicit AssimpAssetStream(AssetFile file);
+
+	std::size_t Read(void* buffer, std::size_t size, std::size_t count) override;
+	std::size_t Write(const void* buffer, std::size_t size, std::size_t count) override;
+	aiReturn Seek(std::size_t offset, aiOrigin origin) override;
+	std::size_t Tell() const override;
+	std::size_t FileSize() const override;
+	void Flush() override;
+private:
+	AssetFile file_;
+	std::size_t position_{0};
+};
+
+/**
+ * Lets Assimp importers read models, and the files they reference, through the virtual file system.
+ * Files can be opened for reading only.
+ */
+class AssimpIOSystem : public Assimp::IOSystem {
+public:
+	explicit AssimpIOSystem(const VirtualFileSystem& file_system);
+
+	bool Exists(const char* path) const override;
+	char getOsSeparator() const override;
+	Assimp::IOStream* Open(const char* path, const char* mode = "rb") override;
+	void Close(Assimp::IOStream* stream) override;
+private:
+	const VirtualFileSystem& file_system_;
+};
+
+#endif // ASSIMP_IO_SYSTEM_HH
@@ -1,6 +1,7 @@
 #ifndef ASSIMP_MODEL_LOADER_HH
 #define ASSIMP_MODEL_LOADER_HH
 
+#include "game/headers/model/animation-compressor.hh"
 #include "game/headers/model/model-loader.hh"
 
 #include "external/assimp/include/assimp/mesh.h"
@@ -11,24 +12,44 @@
 
 #include "game/headers/model/model.hh"
 #include "game/headers/model/mesh.hh"
+#include "game/headers/model/mesh-optimizer.hh"
 
 #include <memory>
 
 class AssimpModelLoader : public ModelLoader {
 public:
-    AssimpModelLoader() = default;
+    // Without the mesh cache, every load imports, and processes the file
+    explicit AssimpModelLoader(bool use_mesh_cache = true, const AnimationCompressionSettings& animation_compression = {});
     std::shared_ptr<Model> loadModel(const std::string& path) override;
 private:
-    Assimp::Importer _importer;
-    std::vector<Texture> _loaded_textures;
-
-    void processNode(std::vector<std::shared_ptr<Mesh>>& meshes, aiNode* node, const aiScene* scene);
-    std::shared_ptr<Mesh> processMesh(const aiMesh* mesh, const aiScene* scene);
-	Triangle processTriangle(const aiFace* ai_triangle, const aiMesh* ai_mesh);
-	void processMaterial(const aiMaterial* ai_mat, Material& material, std::vector<Texture>& textures);
+    bool use_mesh_cache_;
+    AnimationCompressionSettings animation_compression_;
+
+    void processNode(
+		std::vector<std::shared_ptr<Mesh>>& meshes,
+		std::vector<std::uint32_t>& mesh_nodes,
+		TransformHierarchy& transforms,
+		const std::vector<std::shared_ptr<Mesh>>& scene_meshes,
+		const aiNode* node,
+		std::uint32_t parent
+	);
+	// Mesh processing is called from many threads at once, so it must not modify the loader
+    std::shared_ptr<Mesh> processMesh(
+		const aiMesh* mesh,
+		const aiScene* scene,
+		const Skeleton& skeleton,
+		MeshOptimizationReport& report
+	) const;
+	Vertex processVertex(const aiMesh* ai_mesh, unsigned int vertex_index) const;
+	// One entry per vertex of the Assimp mesh, empty if the mesh has no bones
+	std::vector<VertexSkin> processSkin(const aiMesh* ai_mesh, const Skeleton& skeleton) const;
+	void processMaterial(const aiMaterial* ai_mat, Material& material, std::vector<Texture>& textures) const;
 	void processLights(const aiScene* scene, std::vector<Light>& lights);
+	// Joints are the nodes of every mesh's bones, and their ancestors
+	Skeleton processSkeleton(const aiScene* scene) const;
+	std::vector<AnimationClip> processAnimations(const aiScene* scene, const Skeleton& skeleton) const;
 
-    std::vector<Texture> loadMaterialTextures(const aiMaterial* mat, const aiTextureType type, const std::string& type_name);
+    std::vector<Texture> loadMaterialTextures(const aiMaterial* mat, const aiTextureType type, const std::string& type_name) const;
 };
 
 #endif // ASSIMP_MODEL_LOADER_HH
@@ -0,0 +1,80 @@
+#ifndef COMPRESSED_ANIMATION_HH
+#define COMPRESSED_ANIMATION_HH
+
+#include "game/headers/model/skeleton.hh"
+
+#include "external/glm/glm/glm.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// A key of a compressed track, its three quantized components
+struct AnimationKey {
+	std::uint16_t frame;
+	std::uint16_t values[3];
+};
+
+// A run of keys in a compressed clip's key stream, at least one
+struct AnimationTrack {
+	std::uint32_t first_key;
+	std::uint32_t key_count;
+};
+
+/**
+ * A joint's translation, rotation, and scale tracks. Translations, and scales are quantized
+ * to 16 bits per component within the track's range, value = min + quantized * step.
+ */
+struct JointTracks {
+	AnimationTrack translation;
+	AnimationTrack rotation;
+	AnimationTrack scale;
+	glm::vec3 translation_min;
+	glm::vec3 translation_step;
+	glm::vec3 scale_min;
+	glm::vec3 scale_step;
+};
+
+/**
+ * An animation clip with only the keys its poses cannot be interpolated without, in one stream:
+ * every joint's translation, rotation, and scale keys in turn, in frame order.
+ */
+struct CompressedAnimationClip {
+	std::string name;
+	// In seconds
+	float duration;
+	// Of the clip's frames, keys are at whole frames
+	float sample_rate;
+	std::uint32_t frame_count;
+	std::uint32_t joint_count;
+	std::vector<JointTracks> joints;
+	std::vector<AnimationKey> keys;
+
+	/**
+	 * The joint's transform at a position between 0, and the last frame. Searches every track,
+	 * playback samples through a ClipCursor instead.
+	 */
+	JointTransform getJointTransform(std::size_t joint, float frame_position) const;
+
+	std::size_t getMemorySize() const;
+};
+
+/**
+ * Key encodings. Rotations keep their three smallest components in 15 bits each, the index of
+ * the largest one in the top bits of the first two values, and the largest one is recomputed.
+ */
+namespace animation_quantization {
+
+	void quantizeRotation(const glm::vec4& rotation, std::uint16_t (&values)[3]);
+	// Unit quaternion, as x, y, z, w
+	glm::vec4 dequantizeRotation(const std::uint16_t (&values)[3]);
+
+	// Step per quantized unit covering the range, zero for a constant component
+	glm::vec3 getQuantizationStep(const glm::vec3& min, const glm::vec3& max);
+	void quantizeVector(const glm::vec3& value, const glm::vec3& min, const glm::vec3& step, std::uint16_t (&values)[3]);
+	glm::vec3 dequantizeVector(const std::uint16_t (&values)[3], const glm::vec3& min, const glm::vec3& step);
+
+} // namespace animation_quantization
+
+#endif // COMPRESSED_ANIMATION_HH
@@ -0,0 +1,35 @@
+#ifndef MESH_CACHE_HH
+#define MESH_CACHE_HH
+
+#include "game/headers/model/model.hh"
+
+#include <memory>
+#include <string>
+
+/**
+ * Versioned binary cache of processed models, stored next to the source asset.
+ *
+ * A cache is valid for a source file if it was written by the same cache version,
+ * for the same source path, and if the source file's modification time or its
+ * content hash still match. A cache matched by the hash is rewritten with the new
+ * modification time, so the source is hashed only once. Only the source file itself
+ * is tracked, files it references (e.g. OBJ material libraries) are not.
+ */
+namespace mesh_cache {
+
+	std::string getCachePath(const std::string& source_path);
+
+	/**
+	 * Returns nullptr if there is no valid cache for the source file.
+	 */
+	std::shared_ptr<Model> load(const std::string& source_path);
+
+	/**
+	 * Writes the model's cache next to the source file.
+	 * Throws std::runtime_error if the cache cannot be written.
+	 */
+	void store(const std::string& source_path, const Model& model);
+
+} // namespace mesh_cache
+
+#endif // MESH_CACHE_HH
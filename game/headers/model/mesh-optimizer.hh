@@ -0,0 +1,83 @@
+#ifndef MESH_OPTIMIZER_HH
+#define MESH_OPTIMIZER_HH
+
+#include "game/headers/model/mesh.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct VertexCacheStats {
+	std::size_t triangle_count;
+	std::size_t vertex_count;
+	// Vertices which missed the simulated post-transform cache
+	std::size_t transformed_vertex_count;
+
+	// Average cache miss ratio, transformed vertices per triangle: 0.5 at best, 3 at worst
+	float getACMR() const;
+	// Average transform to vertex ratio, transformed vertices per vertex: 1 at best
+	float getATVR() const;
+
+	VertexCacheStats& operator+=(const VertexCacheStats& other);
+};
+
+struct MeshOptimizationReport {
+	VertexCacheStats before;
+	VertexCacheStats after;
+};
+
+/**
+ * Reorders a mesh's triangles and vertices for cheaper drawing. Every pass is deterministic,
+ * the same mesh is always optimized to the same buffers, so the results can be cached.
+ */
+namespace mesh_optimizer {
+
+	// Simulated FIFO cache, the size of a typical desktop GPU's post-transform cache
+	constexpr std::size_t DEFAULT_CACHE_SIZE{16u};
+	// Clusters may be this much less cache efficient than the mesh, for a better overdraw order
+	constexpr float DEFAULT_OVERDRAW_THRESHOLD{1.05f};
+
+	VertexCacheStats analyzeVertexCache(
+		const std::vector<std::uint32_t>& indices,
+		std::size_t vertex_count,
+		std::size_t cache_size = DEFAULT_CACHE_SIZE
+	);
+
+	/**
+	 * Reorders triangles for post-transform cache locality, with Tom Forsyth's
+	 * linear-speed vertex cache optimization.
+	 */
+	void optimizeVertexCache(std::vector<std::uint32_t>& indices, std::size_t vertex_count);
+
+	/**
+	 * Splits cache optimized triangles into clusters, and sorts the clusters so outward facing
+	 * ones are drawn first, which lets them occlude the mesh's other side.
+	 */
+	void optimizeOverdraw(
+		std::vector<std::uint32_t>& indices,
+		const std::vector<Vertex>& vertices,
+		float threshold = DEFAULT_OVERDRAW_THRESHOLD
+	);
+
+	/**
+	 * Reorders vertices by their first use, and drops vertices no triangle uses.
+	 * A non-empty skin is reordered along with its vertices.
+	 */
+	void optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<std::uint32_t>& indices);
+	void optimizeVertexFetch(
+		std::vector<Vertex>& vertices,
+		std::vector<std::uint32_t>& indices,
+		std::vector<VertexSkin>& skin
+	);
+
+	// Runs every pass in order
+	MeshOptimizationReport optimize(std::vector<Vertex>& vertices, std::vector<std::uint32_t>& indices);
+	MeshOptimizationReport optimize(
+		std::vector<Vertex>& vertices,
+		std::vector<std::uint32_t>& indices,
+		std::vector<VertexSkin>& skin
+	);
+
+} // namespace mesh_optimizer
+
+#endif // MESH_OPTIMIZER_HH
@@ -0,0 +1,36 @@
+#ifndef MESH_SIMPLIFIER_HH
+#define MESH_SIMPLIFIER_HH
+
+#include "game/headers/model/mesh.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Quadric error metric simplification by half-edge collapses, every vertex collapses into
+ * one of its neighbours, so simplified meshes only need new indices. Vertices on borders,
+ * and attribute seams never move, which keeps simplified meshes free of cracks.
+ */
+namespace mesh_simplifier {
+
+	constexpr std::size_t DEFAULT_MAX_LOD_COUNT{4u};
+	// Every level has this fraction of the previous level's triangles
+	constexpr float DEFAULT_LOD_REDUCTION{0.5f};
+	// Meshes are not simplified below this many triangles
+	constexpr std::size_t MIN_LOD_TRIANGLE_COUNT{64u};
+
+	/**
+	 * Returns up to max_lod_count levels of detail, from the finest. Stops early
+	 * when the mesh cannot be simplified any further.
+	 */
+	std::vector<MeshLod> generateLods(
+		const std::vector<Vertex>& vertices,
+		const std::vector<std::uint32_t>& indices,
+		std::size_t max_lod_count = DEFAULT_MAX_LOD_COUNT,
+		float reduction = DEFAULT_LOD_REDUCTION
+	);
+
+} // namespace mesh_simplifier
+
+#endif // MESH_SIMPLIFIER_HH
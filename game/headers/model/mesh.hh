@@ -3,6 +3,9 @@
 
 #include "external/glm/glm/glm.hpp"
 
+#include "game/headers/utility/memory-tracker.hh"
+
+#include <cstdint>
 #include <vector>
 #include <string>
 
@@ -12,8 +15,10 @@ struct Vertex {
 	glm::vec2 tex_coords;
 };
 
-struct Triangle {
-	Vertex vertices[3];
+// Joints of the model's skeleton moving a vertex, weights sum to one, unused slots weigh zero
+struct VertexSkin {
+	std::uint16_t joints[4];
+	float weights[4];
 };
 
 struct Material {
@@ -23,6 +28,44 @@ struct Material {
 	float shininess;
 };
 
+struct BoundingBox {
+	glm::vec3 min;
+	glm::vec3 max;
+};
+
+struct BoundingSphere {
+	glm::vec3 center;
+	float radius;
+};
+
+struct MeshLod {
+	// Triangles of the simplified mesh, indexing the full mesh's vertices
+	std::vector<std::uint32_t> indices;
+	// Root mean square distance from the full mesh's surface, in the mesh's units
+	float error;
+};
+
+struct IndexRange {
+	std::uint32_t first_index;
+	std::uint32_t index_count;
+};
+
+// A mesh merged into a static batch, so it can still be culled on its own
+struct Submesh {
+	// In the batch's space
+	BoundingBox bounds;
+	// Its triangles in the full mesh's indices, and then in every coarser level of detail's
+	std::vector<IndexRange> levels;
+};
+
+// Position-only triangles of a mesh, for collision, and spatial queries
+struct CollisionGeometry {
+	// Unique positions, vertices differing only in their normals, or texture coordinates are merged
+	std::vector<glm::vec3> positions;
+	// Three indices per triangle, of the full level of detail
+	std::vector<std::uint32_t> indices;
+};
+
 struct Texture {
 	std::string type;
 	std::string path;
@@ -30,21 +73,74 @@ struct Texture {
 
 class Mesh {
 public:
-	glm::mat4 trans_matrix_{glm::mat4(1.0f)};
-
-	std::vector<Triangle> triangles_;
+	// Unique vertices, referenced by the index buffer
+	std::vector<Vertex> vertices_;
+	// Three indices per triangle
+	std::vector<std::uint32_t> indices_;
 	std::vector<Texture> textures_;
+	// One entry per vertex of a skinned mesh, empty for a rigid one
+	std::vector<VertexSkin> skin_;
 
 	Material material_;
 
+	// Coarser levels of detail, from the finest, level 0 is the full mesh
+	std::vector<MeshLod> lods_;
+
+	// Bounds of the mesh's vertex positions, in the mesh's space
+	BoundingBox bounds_;
+	// Centered on the box, as tight as the vertices allow
+	BoundingSphere bounding_sphere_;
+
+	// Meshes merged into a static batch, empty for other meshes. Kept once the geometry is released.
+	std::vector<Submesh> submeshes_;
+
+	// Meshes which are collided with, or queried, keep a collision copy once their geometry is released
+	bool is_collision_source_{false};
+	// Empty until the geometry of a collision source is released
+	CollisionGeometry collision_;
+
 	/**
-	 * Mesh constructor steals (moves) resources from the given vectors.
+	 * Mesh constructor steals (moves) resources from the given vectors,
+	 * and computes the mesh's bounds, and bounding sphere, which are those of the bind pose for a skinned mesh.
 	 */
 	Mesh(
-		std::vector<Triangle>&& triangles,
+		std::vector<Vertex>&& vertices,
+		std::vector<std::uint32_t>&& indices,
 		std::vector<Texture>&& textures,
-		Material material
+		Material material,
+		std::vector<MeshLod>&& lods = {},
+		std::vector<VertexSkin>&& skin = {}
 	);
+
+	// Skinned meshes are deformed by their model's skeleton, their vertices are in the model's space
+	bool isSkinned() const;
+
+	/**
+	 * Returns true if every index fits into a 16-bit index buffer.
+	 */
+	bool hasShortIndices() const;
+
+	/**
+	 * Frees the vertices, their skin, and the indices of every level of detail, once they live on the GPU.
+	 * Bounds, and level of detail errors are kept. A collision source builds its collision copy first.
+	 */
+	void releaseGeometry();
+	bool isGeometryResident() const;
+
+	// CPU memory of the vertices, indices of every level of detail, and submeshes
+	const MemoryUsage& getMemoryUsage() const;
+	// Call after resizing, or releasing the mesh's vectors
+	void updateMemoryRecord();
+
+	static BoundingBox computeBounds(const std::vector<Vertex>& vertices);
+	static BoundingSphere computeBoundingSphere(const std::vector<Vertex>& vertices, const BoundingBox& bounds);
+private:
+	bool is_geometry_resident_{true};
+	// Remembers a released skin
+	bool is_skinned_{false};
+	MemoryRecord memory_;
+
+	CollisionGeometry buildCollisionGeometry() const;
 };
 
 #endif // MESH_HH
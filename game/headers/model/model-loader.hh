@@ -1,15 +1,59 @@
 #ifndef MODEL_LOADER_HH
 #define MODEL_LOADER_HH
 
+#include "game/headers/model/animation-compressor.hh"
 #include "game/headers/model/model.hh"
+#include "game/headers/model/mesh.hh"
+#include "game/headers/model/mesh-optimizer.hh"
 
+#include <cstdint>
+#include <future>
 #include <memory>
 #include <string>
+#include <vector>
+
+struct ModelLoadOptions {
+	// Meshes keep a collision copy once their geometry is released
+	bool is_collision_source{false};
+	// The model's nodes never move, so its meshes are batched by material, see static-batcher.hh
+	bool is_static{false};
+};
 
 class ModelLoader {
 public:
     virtual ~ModelLoader() {};
+    /**
+     * Implementations must be safe to call from several threads at once.
+     */
     virtual std::shared_ptr<Model> loadModel(const std::string& path) = 0;
+    /**
+     * Loads the model on the game's thread pool, and batches, and marks it as the options ask before it is handed out.
+     * The loader must outlive the returned future.
+     */
+    std::future<std::shared_ptr<Model>> loadModelAsync(const std::string& path, ModelLoadOptions options = {});
+protected:
+	/**
+	 * Reorders the triangles, and vertices for the GPU's caches, generates the levels of detail,
+	 * and creates the mesh. Every loader finishes its meshes this way, so their output is the same.
+	 */
+	static std::shared_ptr<Mesh> buildMesh(
+		std::vector<Vertex>&& vertices,
+		std::vector<std::uint32_t>&& indices,
+		std::vector<Texture>&& textures,
+		const Material& material,
+		MeshOptimizationReport& report
+	);
+	// A skinned mesh's skin has an entry for every vertex, it follows the vertices' new order
+	static std::shared_ptr<Mesh> buildMesh(
+		std::vector<Vertex>&& vertices,
+		std::vector<std::uint32_t>&& indices,
+		std::vector<Texture>&& textures,
+		std::vector<VertexSkin>&& skin,
+		const Material& material,
+		MeshOptimizationReport& report
+	);
+	static void logOptimizationReports(const std::string& path, const std::vector<MeshOptimizationReport>& reports);
+	static void logCompressionReports(const std::string& path, const std::vector<AnimationCompressionReport>& reports);
 };
 
 #endif // MODEL_LOADER_HH
@@ -3,10 +3,15 @@
 
 #include "external/glm/glm/glm.hpp"
 
+#include "game/headers/model/compressed-animation.hh"
 #include "game/headers/model/mesh.hh"
+#include "game/headers/model/skeleton.hh"
+#include "game/headers/model/transform-hierarchy.hh"
 
+#include <cstdint>
 #include <vector>
 #include <memory>
+#include <string>
 
 struct Light {
 	glm::vec3 position;
@@ -19,9 +24,37 @@ struct Light {
 class Model {
 public:
 	std::vector<std::shared_ptr<Mesh>> meshes_;
+	// Node placing every entry of meshes_
+	std::vector<std::uint32_t> mesh_nodes_;
+	TransformHierarchy transforms_;
 	std::vector<Light> lights_;
+	// Empty unless the model has skinned meshes
+	Skeleton skeleton_;
+	std::vector<CompressedAnimationClip> animations_;
 
+	// Places every mesh at a single root node with an identity transform
 	Model(std::vector<std::shared_ptr<Mesh>>&& meshes, std::vector<Light>&& lights);
+	Model(
+		std::vector<std::shared_ptr<Mesh>>&& meshes,
+		std::vector<std::uint32_t>&& mesh_nodes,
+		TransformHierarchy&& transforms,
+		std::vector<Light>&& lights,
+		Skeleton&& skeleton = {},
+		std::vector<CompressedAnimationClip>&& animations = {}
+	);
+
+	// Returns nullptr if there is no such clip
+	const CompressedAnimationClip* findAnimation(const std::string& name) const;
+
+	// CPU memory of the model, and its meshes, a mesh used by several entries is counted once
+	MemoryUsage getMemoryUsage() const;
+
+	// Marks every mesh, so it keeps a collision copy once its geometry is released
+	void setCollisionSource(bool is_collision_source);
+private:
+	MemoryRecord memory_;
+
+	void updateMemoryRecord();
 };
 
 #endif // MODEL_HH
@@ -0,0 +1,41 @@
+#ifndef OBJ_MODEL_LOADER_HH
+#define OBJ_MODEL_LOADER_HH
+
+#include "game/headers/model/model-loader.hh"
+#include "game/headers/model/model.hh"
+#include "game/headers/model/mesh.hh"
+#include "game/headers/model/mesh-optimizer.hh"
+#include "game/headers/model/obj/obj-parser.hh"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+/**
+ * Loads Wavefront OBJ files without Assimp. The file is memory-mapped, and parsed on the game's
+ * thread pool, the resulting models are the same as those of AssimpModelLoader.
+ * Other formats are handed to the fallback loader.
+ */
+class ObjModelLoader : public ModelLoader {
+public:
+	// Without the mesh cache, every load parses, and processes the file
+	explicit ObjModelLoader(std::unique_ptr<ModelLoader> fallback = nullptr, bool use_mesh_cache = true);
+	std::shared_ptr<Model> loadModel(const std::string& path) override;
+
+	static bool isObjFile(const std::string& path);
+private:
+	std::unique_ptr<ModelLoader> fallback_;
+	bool use_mesh_cache_;
+
+	std::shared_ptr<Model> loadObjModel(const std::string& path) const;
+	// Libraries which cannot be read are skipped, their materials get the default values
+	static std::unordered_map<std::string, ObjMaterial> loadMaterials(const std::string& path, const ObjScene& scene);
+	static std::shared_ptr<Mesh> processMesh(
+		const ObjScene& scene,
+		const ObjMesh& mesh,
+		const std::unordered_map<std::string, ObjMaterial>& materials,
+		MeshOptimizationReport& report
+	);
+};
+
+#endif // OBJ_MODEL_LOADER_HH
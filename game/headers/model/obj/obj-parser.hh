@@ -0,0 +1,79 @@
+#ifndef OBJ_PARSER_HH
+#define OBJ_PARSER_HH
+
+#include "external/glm/glm/glm.hpp"
+
+#include "game/headers/model/mesh.hh"
+#include "game/headers/utility/thread-pool.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// A triangle's corner, indexing the scene's attribute arrays
+struct ObjCorner {
+	static constexpr std::uint32_t NO_INDEX{0xffffffffu};
+
+	std::uint32_t position;
+	std::uint32_t tex_coords{NO_INDEX};
+	std::uint32_t normal{NO_INDEX};
+};
+
+// Consecutive faces of an object sharing a material, polygons are split into triangle fans
+struct ObjMesh {
+	std::string material;
+	// Three corners per triangle
+	std::vector<ObjCorner> corners;
+	// Set if any corner has the attribute
+	bool has_tex_coords{false};
+	bool has_normals{false};
+};
+
+struct ObjObject {
+	std::string name;
+	// Empty meshes are kept, so every object is in the same place as in Assimp's import
+	std::vector<ObjMesh> meshes;
+};
+
+struct ObjScene {
+	std::vector<glm::vec3> positions;
+	std::vector<glm::vec2> tex_coords;
+	std::vector<glm::vec3> normals;
+	std::vector<ObjObject> objects;
+	// Paths of the material libraries, as they are written in the file
+	std::vector<std::string> material_libraries;
+};
+
+struct ObjMaterial {
+	Material material;
+	std::vector<Texture> textures;
+};
+
+/**
+ * Parser of Wavefront OBJ, and MTL text, which groups faces into objects, and meshes
+ * the same way Assimp's OBJ importer does.
+ */
+namespace obj_parser {
+
+	// Material of faces before any 'usemtl'
+	constexpr const char* DEFAULT_MATERIAL_NAME{"DefaultMaterial"};
+	// Object of faces before any 'o', or 'g'
+	constexpr const char* DEFAULT_OBJECT_NAME{"defaultobject"};
+
+	// Values of a material which sets nothing, or is not found in any library
+	ObjMaterial getDefaultMaterial();
+
+	/**
+	 * Parses an OBJ file's text. Large files are split into chunks at line boundaries, which are parsed
+	 * in parallel on the pool. Throws std::runtime_error if the text is malformed.
+	 */
+	ObjScene parse(const char* data, std::size_t size, ThreadPool& pool);
+
+	// Parses an MTL file's text, materials are keyed by their names
+	std::unordered_map<std::string, ObjMaterial> parseMaterials(const char* data, std::size_t size);
+
+} // namespace obj_parser
+
+#endif // OBJ_PARSER_HH
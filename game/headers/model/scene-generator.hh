@@ -0,0 +1,79 @@
+#ifndef SCENE_GENERATOR_HH
+#define SCENE_GENERATOR_HH
+
+#include "external/glm/glm/glm.hpp"
+
+#include "game/headers/model/model.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct SceneGeneratorSettings {
+	std::size_t mesh_count{64u};
+	// Every mesh is a rippled grid, which has at least this many triangles
+	std::size_t triangles_per_mesh{512u};
+	// Zero leaves the meshes untextured
+	std::size_t texture_count{4u};
+	std::uint32_t texture_size{256u};
+	std::size_t material_count{8u};
+	std::size_t light_count{4u};
+	// Copies of the whole model, placed side by side
+	std::size_t instance_count{1u};
+	// Meshes are scattered over a square of this size, centered at the model's origin
+	float extent{100.0f};
+	std::uint32_t seed{1u};
+	// Files are written into the directory, and the model's texture paths point there
+	std::string directory{"generated-scene"};
+	std::string name{"scene"};
+};
+
+struct GeneratedTexture {
+	std::string path;
+	std::uint32_t width;
+	std::uint32_t height;
+	// Four channels per pixel, rows from the top
+	std::vector<std::uint8_t> pixels;
+};
+
+struct GeneratedScene {
+	std::shared_ptr<Model> model;
+	std::vector<glm::mat4> instances;
+	std::vector<GeneratedTexture> textures;
+};
+
+/**
+ * Synthetic scenes of any size, for measuring how loading, rendering, and collision scale.
+ * The same settings always generate the same scene.
+ */
+namespace scene_generator {
+
+	/**
+	 * Generates the scene in memory, every mesh has its own node under the root.
+	 * The textures are not written, the renderer can only load them once writeTextures() did.
+	 */
+	GeneratedScene generate(const SceneGeneratorSettings& settings);
+
+	void writeTextures(const GeneratedScene& scene);
+
+	/**
+	 * Writes the scene as an OBJ model with its material library, textures, and instance list, into the settings' directory.
+	 * The nodes' transforms are applied to the written vertices, as OBJ files have no hierarchy, nor lights.
+	 * Returns the model's path. Throws std::runtime_error if a file cannot be written.
+	 */
+	std::string write(const GeneratedScene& scene, const SceneGeneratorSettings& settings);
+
+	// Path of the instance list belonging to a generated model
+	std::string getInstancesPath(const std::string& model_path);
+
+	/**
+	 * Reads an instance list written by write().
+	 * Throws std::runtime_error if the list cannot be read.
+	 */
+	std::vector<glm::mat4> loadInstances(const std::string& path);
+
+} // namespace scene_generator
+
+#endif // SCENE_GENERATOR_HH
@@ -0,0 +1,93 @@
+#ifndef SKELETON_HH
+#define SKELETON_HH
+
+#include "external/glm/glm/glm.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+// A joint's transform relative to its parent
+struct JointTransform {
+	glm::vec3 translation;
+	// Unit quaternion, as x, y, z, w
+	glm::vec4 rotation;
+	glm::vec3 scale;
+
+	glm::mat4 toMatrix() const;
+	// The matrix must not be sheared
+	static JointTransform fromMatrix(const glm::mat4& matrix);
+};
+
+/**
+ * Components of a joint's local transform. Clips, and poses keep every component
+ * of every joint in a separate array, so many joints are processed at once with SIMD.
+ */
+enum class JointChannel : std::size_t {
+	TranslationX,
+	TranslationY,
+	TranslationZ,
+	RotationX,
+	RotationY,
+	RotationZ,
+	RotationW,
+	ScaleX,
+	ScaleY,
+	ScaleZ,
+	Count
+};
+
+constexpr std::size_t JOINT_CHANNEL_COUNT{static_cast<std::size_t>(JointChannel::Count)};
+// Channel arrays are padded to a multiple of the widest SIMD register's floats, with identity transforms
+constexpr std::size_t JOINT_LANES{8u};
+
+inline std::size_t getPaddedJointCount(std::size_t joint_count) {
+	return (joint_count + JOINT_LANES - 1u) / JOINT_LANES * JOINT_LANES;
+}
+
+/**
+ * Joint hierarchy deforming a model's skinned meshes, every joint after its parent.
+ * Skinning matrices take a vertex from the model's space in the bind pose to the model's space in a pose.
+ */
+struct Skeleton {
+	static constexpr std::uint32_t NO_JOINT{std::numeric_limits<std::uint32_t>::max()};
+
+	std::vector<std::string> joint_names;
+	// NO_JOINT for roots
+	std::vector<std::uint32_t> parents;
+	// Local transforms of the bind pose, joints a clip does not animate keep them
+	std::vector<JointTransform> bind_pose;
+	// From the model's space into every joint's space, in the bind pose
+	std::vector<glm::mat4> inverse_binds;
+
+	std::size_t getJointCount() const;
+	bool isEmpty() const;
+	// Returns NO_JOINT if there is no such joint
+	std::uint32_t findJoint(const std::string& name) const;
+
+	// Memory of the joints' names, and transforms
+	std::size_t getMemorySize() const;
+};
+
+/**
+ * Joint transforms resampled at a fixed rate, for every joint of the skeleton, as imported.
+ * Models keep their clips compressed, see animation-compressor.hh.
+ * Frame f holds JOINT_CHANNEL_COUNT arrays of getPaddedJointCount() values, in JointChannel order.
+ */
+struct AnimationClip {
+	std::string name;
+	// In seconds
+	float duration;
+	// Frames per second, the last frame is at the clip's duration
+	float sample_rate;
+	std::uint32_t frame_count;
+	std::uint32_t joint_count;
+	std::vector<float> samples;
+
+	const float* getChannel(std::size_t frame, JointChannel channel) const;
+	float* getChannel(std::size_t frame, JointChannel channel);
+};
+
+#endif // SKELETON_HH
@@ -0,0 +1,33 @@
+#ifndef STATIC_BATCHER_HH
+#define STATIC_BATCHER_HH
+
+#include "game/headers/model/model.hh"
+
+#include <cstddef>
+#include <memory>
+
+struct StaticBatchReport {
+	std::size_t mesh_count;
+	// Meshes of the batched model, each drawn by its own draw calls
+	std::size_t batched_mesh_count;
+	// Meshes merged into the batches
+	std::size_t merged_mesh_count;
+};
+
+/**
+ * Merges a static model's rigid meshes which share a material, and textures, so each set is one
+ * mesh, and one draw. The meshes' node transforms are applied to their vertices, so batches sit at
+ * an identity node, and nodes must not move afterwards. Every merged mesh becomes a submesh of its
+ * batch, with its bounds, and its triangles' ranges in every level of detail, for culling.
+ */
+namespace static_batcher {
+
+	/**
+	 * Returns a new model, sharing the meshes which are not merged, and the lights, skeleton, and
+	 * animations of the given one. Skinned meshes, and meshes whose geometry was released are kept as they are.
+	 */
+	std::shared_ptr<Model> batch(const Model& model, StaticBatchReport& report);
+
+} // namespace static_batcher
+
+#endif // STATIC_BATCHER_HH
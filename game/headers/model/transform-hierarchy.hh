@@ -0,0 +1,52 @@
+#ifndef TRANSFORM_HIERARCHY_HH
+#define TRANSFORM_HIERARCHY_HH
+
+#include "external/glm/glm/glm.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/**
+ * Node transforms kept as flat arrays, every node after its parent. World matrices
+ * are updated in one linear pass over the nodes, only for dirty nodes and their descendants.
+ */
+class TransformHierarchy {
+public:
+	static constexpr std::uint32_t NO_PARENT{std::numeric_limits<std::uint32_t>::max()};
+
+	TransformHierarchy() = default;
+	// Restores saved nodes, every parent must precede its children
+	TransformHierarchy(std::vector<std::uint32_t>&& parents, std::vector<glm::mat4>&& locals);
+
+	// The parent must be added before, or be NO_PARENT. Returns the new node.
+	std::uint32_t addNode(std::uint32_t parent, const glm::mat4& local);
+
+	std::size_t getNodeCount() const;
+	std::uint32_t getParent(std::uint32_t node) const;
+	const glm::mat4& getLocal(std::uint32_t node) const;
+	void setLocal(std::uint32_t node, const glm::mat4& local);
+
+	// Valid since the last update()
+	const glm::mat4& getWorld(std::uint32_t node) const;
+
+	/**
+	 * Recomputes the world matrices of dirty nodes, and their descendants.
+	 * Returns true if any world matrix changed.
+	 */
+	bool update();
+
+	const std::vector<std::uint32_t>& getParents() const;
+	const std::vector<glm::mat4>& getLocals() const;
+private:
+	std::vector<std::uint32_t> parents_;
+	std::vector<glm::mat4> locals_;
+	std::vector<glm::mat4> worlds_;
+	std::vector<std::uint8_t> is_dirty_;
+
+	// Nodes before the first dirty one are skipped by updates
+	std::size_t first_dirty_node_{0u};
+};
+
+#endif // TRANSFORM_HIERARCHY_HH
@@ -0,0 +1,70 @@
+#ifndef VERTEX_COMPRESSION_HH
+#define VERTEX_COMPRESSION_HH
+
+#include "external/glm/glm/glm.hpp"
+
+#include "game/headers/model/mesh.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class VertexFormat {
+	// 32 bytes: float positions, normals, and texture coordinates
+	Full,
+	// 20 bytes: float positions, octahedral 2 * 16-bit normals, half float texture coordinates
+	Compact,
+	// 16 bytes: like Compact, but with 16-bit positions relative to the mesh's bounds
+	CompactQuantized
+};
+
+// Layout of VertexFormat::Compact
+struct CompactVertex {
+	float position[3];
+	std::int16_t normal[2];
+	std::uint16_t tex_coords[2];
+};
+
+// Layout of VertexFormat::CompactQuantized
+struct QuantizedVertex {
+	// The fourth component pads the position to 8 bytes
+	std::uint16_t position[4];
+	std::int16_t normal[2];
+	std::uint16_t tex_coords[2];
+};
+
+struct EncodedVertices {
+	std::vector<unsigned char> data;
+	std::size_t stride;
+	// Decoded position = encoded position * position_scale + position_offset
+	glm::vec3 position_scale;
+	glm::vec3 position_offset;
+};
+
+struct QuantizationError {
+	// In the mesh's units
+	float max_position_error;
+	// In degrees
+	float max_normal_error;
+	float max_tex_coords_error;
+};
+
+namespace vertex_compression {
+
+	EncodedVertices encode(const Mesh& mesh, VertexFormat format);
+
+	/**
+	 * Encodes, and decodes the mesh's vertices on the CPU, the same way the vertex shader does,
+	 * and returns the largest differences from the original vertices.
+	 */
+	QuantizationError measureError(const Mesh& mesh, VertexFormat format);
+
+	std::uint16_t floatToHalf(float value);
+	float halfToFloat(std::uint16_t value);
+
+	void encodeOctahedral(glm::vec3 normal, std::int16_t encoded[2]);
+	glm::vec3 decodeOctahedral(const std::int16_t encoded[2]);
+
+} // namespace vertex_compression
+
+#endif // VERTEX_COMPRESSION_HH
@@ -0,0 +1,40 @@
+#ifndef VERTEX_DEDUPLICATOR_HH
+#define VERTEX_DEDUPLICATOR_HH
+
+#include "game/headers/model/mesh.hh"
+
+#include <cstdint>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Collects vertices into an array of unique vertices.
+ * Vertices are compared bit by bit, so only exact duplicates are merged.
+ */
+class VertexDeduplicator {
+public:
+	explicit VertexDeduplicator(std::size_t expected_vertex_count);
+
+	/**
+	 * Returns the index of the given vertex inside the unique vertex array.
+	 */
+	std::uint32_t add(const Vertex& vertex);
+
+	/**
+	 * Steals (moves) the unique vertex array out of the deduplicator.
+	 */
+	std::vector<Vertex> takeVertices();
+private:
+	struct VertexHash {
+		std::size_t operator()(const Vertex& vertex) const;
+	};
+	struct VertexEqual {
+		bool operator()(const Vertex& first, const Vertex& second) const;
+	};
+
+	std::unordered_map<Vertex, std::uint32_t, VertexHash, VertexEqual> index_map_;
+	std::vector<Vertex> vertices_;
+};
+
+#endif // VERTEX_DEDUPLICATOR_HH
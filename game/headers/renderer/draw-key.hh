@@ -0,0 +1,69 @@
+#ifndef DRAW_KEY_HH
+#define DRAW_KEY_HH
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+// Passes are drawn in order, every pass's draws after the previous pass's
+enum class RenderPass : std::uint8_t {
+	Opaque
+};
+
+/**
+ * 64-bit sort keys of draws, from the most significant bits: pass, shader, material, textures, vertex
+ * array, and depth. Sorting by them groups draws by the state they need, the costliest to change first,
+ * and orders draws needing the same state front to back. Fields wider than their bits are truncated,
+ * so identifiers may collide, drawing with colliding identifiers only costs state changes.
+ */
+namespace draw_key {
+
+	constexpr unsigned int PASS_BITS{4u};
+	constexpr unsigned int SHADER_BITS{8u};
+	constexpr unsigned int MATERIAL_BITS{12u};
+	constexpr unsigned int TEXTURES_BITS{12u};
+	constexpr unsigned int VERTEX_ARRAY_BITS{12u};
+	constexpr unsigned int DEPTH_BITS{16u};
+
+	constexpr unsigned int DEPTH_SHIFT{0u};
+	constexpr unsigned int VERTEX_ARRAY_SHIFT{DEPTH_SHIFT + DEPTH_BITS};
+	constexpr unsigned int TEXTURES_SHIFT{VERTEX_ARRAY_SHIFT + VERTEX_ARRAY_BITS};
+	constexpr unsigned int MATERIAL_SHIFT{TEXTURES_SHIFT + TEXTURES_BITS};
+	constexpr unsigned int SHADER_SHIFT{MATERIAL_SHIFT + MATERIAL_BITS};
+	constexpr unsigned int PASS_SHIFT{SHADER_SHIFT + SHADER_BITS};
+	static_assert(PASS_SHIFT + PASS_BITS == 64u, "the fields must fill the key");
+
+	constexpr std::uint64_t getField(std::uint64_t value, unsigned int bits, unsigned int shift) {
+		return (value & ((std::uint64_t{1u} << bits) - 1u)) << shift;
+	}
+
+	constexpr std::uint64_t make(
+		RenderPass pass,
+		std::uint32_t shader,
+		std::uint32_t material,
+		std::uint32_t textures,
+		std::uint32_t vertex_array,
+		std::uint32_t depth
+	) {
+		return getField(static_cast<std::uint64_t>(pass), PASS_BITS, PASS_SHIFT)
+			| getField(shader, SHADER_BITS, SHADER_SHIFT)
+			| getField(material, MATERIAL_BITS, MATERIAL_SHIFT)
+			| getField(textures, TEXTURES_BITS, TEXTURES_SHIFT)
+			| getField(vertex_array, VERTEX_ARRAY_BITS, VERTEX_ARRAY_SHIFT)
+			| getField(depth, DEPTH_BITS, DEPTH_SHIFT);
+	}
+
+	/**
+	 * The upper bits of a non-negative float order the same as the float, so depths keep the distances'
+	 * order, coarser further away, without knowing their range. Negative distances are clamped to zero.
+	 */
+	inline std::uint32_t getDepth(float distance) {
+		const float clamped{std::max(distance, 0.0f)};
+		std::uint32_t bits;
+		std::memcpy(&bits, &clamped, sizeof(bits));
+		return bits >> (32u - DEPTH_BITS);
+	}
+
+} // namespace draw_key
+
+#endif // DRAW_KEY_HH
@@ -0,0 +1,73 @@
+#ifndef FRUSTUM_HH
+#define FRUSTUM_HH
+
+#include "external/glm/glm/glm.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * World space bounding spheres, each coordinate in its own array, padded to whole SIMD vectors with
+ * spheres which are never visible. Frustum::cull() fills in which of them are visible.
+ */
+struct CullingSpheres {
+	std::vector<float> center_x;
+	std::vector<float> center_y;
+	std::vector<float> center_z;
+	std::vector<float> radius;
+	std::vector<std::uint8_t> visible;
+	// Spheres added, the arrays are longer by the padding
+	std::size_t count{0u};
+
+	// Keeps the arrays' memory for the next frame's spheres
+	void clear();
+	// Returns the sphere's index
+	std::size_t add(const glm::vec3& center, float sphere_radius);
+	glm::vec3 getCenter(std::size_t index) const;
+};
+
+// World space axis-aligned boxes, by their centers, and half extents, laid out like CullingSpheres
+struct CullingBoxes {
+	std::vector<float> center_x;
+	std::vector<float> center_y;
+	std::vector<float> center_z;
+	std::vector<float> extent_x;
+	std::vector<float> extent_y;
+	std::vector<float> extent_z;
+	std::vector<std::uint8_t> visible;
+	std::size_t count{0u};
+
+	void clear();
+	std::size_t add(const glm::vec3& center, const glm::vec3& extent);
+};
+
+struct CullingStats {
+	// Instances of meshes, each tested by its bounding sphere
+	std::size_t instance_count;
+	std::size_t visible_instance_count;
+	// Meshes merged into static batches, each tested by its box, when the batch is visible
+	std::size_t submesh_count;
+	std::size_t visible_submesh_count;
+};
+
+/**
+ * The six planes of a view-projection matrix's clip volume, in the world space, facing inwards.
+ * A volume is culled once it is wholly behind any plane, so volumes near the frustum's corners
+ * may be kept although they are outside, never the other way around.
+ */
+class Frustum {
+public:
+	explicit Frustum(const glm::mat4& view_projection);
+
+	// Tests simd::LANE_COUNT volumes at a time against every plane
+	void cull(CullingSpheres& spheres) const;
+	void cull(CullingBoxes& boxes) const;
+private:
+	static constexpr std::size_t PLANE_COUNT{6u};
+	// Normals, and distances from the origin, of planes normalized so the normals' lengths are one
+	std::array<glm::vec4, PLANE_COUNT> planes_;
+};
+
+#endif // FRUSTUM_HH
@@ -0,0 +1,43 @@
+#ifndef LOD_SELECTOR_HH
+#define LOD_SELECTOR_HH
+
+#include "game/headers/model/mesh.hh"
+#include "game/headers/renderer/camera.hh"
+#include "game/headers/renderer/screen.hh"
+#include "game/headers/renderer/renderer-settings.hh"
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Picks the coarsest level of detail whose error, projected onto the screen, stays
+ * below RendererSettings::lod_error_pixels. Built once per frame from the camera.
+ */
+class LodSelector {
+public:
+	LodSelector(const Camera& camera, const Screen& screen, const RendererSettings& settings);
+
+	/**
+	 * Returns the level to draw, given the mesh's bounding sphere in the world, every level's error
+	 * from the finest, and the level drawn last frame. A coarser level is only chosen with a margin,
+	 * so meshes at the switching distance do not pop back and forth.
+	 */
+	std::size_t select(
+		const glm::vec3& center,
+		float radius,
+		const std::vector<float>& level_errors,
+		std::size_t current_level
+	) const;
+
+	// Distance from the camera to a bounding sphere, zero inside it
+	float getDistance(const glm::vec3& center, float radius) const;
+private:
+	glm::vec3 camera_position_;
+	float clip_near_;
+	// Screen pixels covered by one unit at a distance of one unit
+	float pixels_per_unit_;
+	float error_pixels_;
+	float hysteresis_;
+};
+
+#endif // LOD_SELECTOR_HH
@@ -3,17 +3,61 @@
 
 #include "game/headers/renderer/screen.hh"
 #include "game/headers/renderer/camera.hh"
+#include "game/headers/renderer/frustum.hh"
+#include "game/headers/renderer/renderer-settings.hh"
 #include "game/headers/model/model.hh"
+#include "game/headers/utility/memory-tracker.hh"
 
+#include "external/glm/glm/glm.hpp"
+
+#include <cstdint>
+#include <future>
 #include <memory>
+#include <vector>
+
+using ModelInstanceId = std::uint64_t;
 
 class ModelRenderer {
 public:
 	virtual ~ModelRenderer() {};
 
-	virtual void init(Screen screen, const Camera* camera) = 0;
+	virtual void init(Screen screen, const Camera* camera, RendererSettings settings) = 0;
+	// Uploads the model to the GPU immediately, and adds an instance of it at the origin
 	virtual void addModel(std::shared_ptr<Model> model) = 0;
+	/**
+	 * The model is added once it is loaded, and it is uploaded
+	 * to the GPU over the following frames.
+	 */
+	virtual void addModel(std::future<std::shared_ptr<Model>> model) = 0;
+
+	/**
+	 * Draws the model once more, with the given transform. Every instance of the same model
+	 * shares its GPU resources, and is drawn by the same draw calls. A model which is not
+	 * drawn yet is uploaded to the GPU over the following frames. Throws std::invalid_argument
+	 * for a model whose geometry was released after an earlier upload, once it is not drawn anymore.
+	 */
+	virtual ModelInstanceId addInstance(std::shared_ptr<Model> model, const glm::mat4& transform) = 0;
+	virtual void setInstanceTransform(ModelInstanceId instance, const glm::mat4& transform) = 0;
+	/**
+	 * Poses an instance of a skinned model, with one skinning matrix per joint of the model's skeleton.
+	 * Instances are drawn in the bind pose until their first matrices are set.
+	 */
+	virtual void setInstanceSkinningMatrices(ModelInstanceId instance, const std::vector<glm::mat4>& skinning_matrices) = 0;
+	// The model's GPU resources are released with its last instance
+	virtual void removeInstance(ModelInstanceId instance) = 0;
+	// Per-frame work which is not drawing, call it once per frame before draw()
+	virtual void update() = 0;
 	virtual void draw() const = 0;
+
+	/**
+	 * Memory of the model, and its GPU resources, including the textures it uses.
+	 * Empty for a model which is not drawn by the renderer.
+	 */
+	virtual MemoryUsage getMemoryUsage(const Model& model) const = 0;
+	// Memory of every drawn model, with shared textures included once
+	virtual MemoryUsage getMemoryUsage() const = 0;
+	// Instances, and submeshes tested against the camera's frustum by the last draw(), and those which were visible
+	virtual CullingStats getCullingStats() const = 0;
 };
 
 #endif // MODEL_RENDERER_HH
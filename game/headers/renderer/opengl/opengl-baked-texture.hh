@@ -0,0 +1,12 @@
+#ifndef OPENGL_BAKED_TEXTURE_HH
+#define OPENGL_BAKED_TEXTURE_HH
+
+#include "game/headers/texture/baked-texture.hh"
+
+/**
+ * Uploads every mip level of a baked texture, straight from its mapping, into the bound 2D texture.
+ * Returns false if the OpenGL context does not support the texture's format.
+ */
+bool upload_baked_texture(const BakedTexture& baked_texture);
+
+#endif // OPENGL_BAKED_TEXTURE_HH
@@ -1,36 +1,189 @@
 #ifndef OPENGL_DRAWABLE_HH
 #define OPENGL_DRAWABLE_HH
 
-#include "game/headers/renderer/drawable.hh"
 #include "game/headers/model/model.hh"
 #include "game/headers/model/mesh.hh"
 #include "game/headers/renderer/opengl/shader.hh"
+#include "game/headers/renderer/opengl/opengl-texture-cache.hh"
+#include "game/headers/renderer/renderer-settings.hh"
+#include "game/headers/renderer/frustum.hh"
+#include "game/headers/renderer/lod-selector.hh"
+#include "game/headers/renderer/opengl/opengl-render-queue.hh"
+#include "game/headers/utility/memory-tracker.hh"
 
+#include "external/glm/glm/glm.hpp"
+
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 struct OpenGLTexture {
-	unsigned int id;
+	std::shared_ptr<OpenGLCachedTexture> cached_texture;
 	Texture texture;
+	// The shader's sampler the texture is bound for
+	ShaderUniform<int> sampler;
 };
 
-class OpenGLDrawableMesh : public Drawable {
+class OpenGLDrawableMesh {
 public:
-	OpenGLDrawableMesh(std::shared_ptr<Mesh> mesh, Shader& shader);
+	/**
+	 * Does not create any GPU objects, call upload() before drawing the mesh.
+	 */
+	OpenGLDrawableMesh(
+		std::shared_ptr<Mesh> mesh,
+		Shader& shader,
+		OpenGLTextureCache& texture_cache,
+		const RendererSettings& settings
+	);
+	// Deletes the mesh's GPU objects, on the OpenGL context's thread
+	~OpenGLDrawableMesh();
+
+	/**
+	 * Owns its GPU objects, so it is only moved, which leaves the source without any.
+	 * Not assignable, as it refers to the renderer's shader, texture cache, and settings.
+	 */
+	OpenGLDrawableMesh(const OpenGLDrawableMesh&) = delete;
+	OpenGLDrawableMesh& operator=(const OpenGLDrawableMesh&) = delete;
+	OpenGLDrawableMesh(OpenGLDrawableMesh&& other) noexcept;
+	OpenGLDrawableMesh& operator=(OpenGLDrawableMesh&& other) = delete;
+
+	/**
+	 * Creates the mesh's GPU objects, which read per-instance transforms, and the instances' slots
+	 * in the model from the given buffers. Must be called on the OpenGL context's thread.
+	 */
+	void upload(unsigned int instance_buffer, unsigned int instance_slot_buffer);
+	bool isUploaded() const;
+
+	// Level of detail state of an instance added to, or removed from the model's instance slots
+	void addInstanceSlot();
+	void removeInstanceSlot(std::size_t slot);
+
+	/**
+	 * Adds every instance's bounding sphere in the world, the instance's transform combined with the
+	 * mesh's node transform. A skinned mesh's vertices are in the model's space already, so its node
+	 * transform is not applied.
+	 */
+	void addBounds(
+		const std::vector<glm::mat4>& transforms,
+		const glm::mat4& node_transform,
+		CullingSpheres& spheres
+	);
+
+	/**
+	 * Picks the level of detail of every instance whose sphere is visible, and appends their transforms
+	 * to the instance stream, grouped by the level they are drawn with. The instances' slots are appended
+	 * to the slot stream in the same order. Skinned meshes are never culled, as their bind pose's sphere
+	 * does not bound their animations. A single instance of a static batch also culls the batch's submeshes.
+	 */
+	void prepareInstances(
+		const LodSelector& selector,
+		const Frustum& frustum,
+		const CullingSpheres& spheres,
+		const std::vector<glm::mat4>& transforms,
+		const glm::mat4& node_transform,
+		std::vector<glm::mat4>& instance_stream,
+		std::vector<std::uint32_t>& instance_slot_stream,
+		CullingStats& stats
+	);
+
+	/**
+	 * Skins every prepared instance's vertices, and streams them to the GPU, on the CPU skinning path.
+	 * The skinning matrices of every instance slot follow each other, joint count of them per slot.
+	 */
+	void skinInstances(
+		const std::vector<std::uint32_t>& instance_slot_stream,
+		const std::vector<glm::mat4>& skinning_matrices,
+		std::size_t joint_count
+	);
+
+	// Submits a packet for every level of detail in use, ordered by the level's closest instance
+	void submit(OpenGLRenderQueue& queue, const OpenGLDrawableModel& model) const;
 
-	void draw() const override;
+	// The render queue's state changes, it sets whatever the previous packet's mesh left differing
+	bool hasSameMaterial(const OpenGLDrawableMesh& other) const;
+	bool hasSameTextures(const OpenGLDrawableMesh& other) const;
+	void setMaterial(const Shader& shader, const OpenGLMeshUniforms& uniforms) const;
+	void bindTextures(const Shader& shader) const;
+	// Binds the vertex array, and sets the uploaded vertex format's decoding parameters
+	void bindVertexArray(const Shader& shader, const OpenGLMeshUniforms& uniforms) const;
+	// Draws the instances of a level of detail, with the mesh's vertex array bound
+	void drawLevel(std::size_t level) const;
+
+	// Vertex, and index buffers, textures are shared, so they are not included
+	const MemoryUsage& getMemoryUsage() const;
+	const std::vector<OpenGLTexture>& getTextures() const;
 private:
 	std::shared_ptr<Mesh> mesh_;
 	Shader& shader_;
+	OpenGLTextureCache& texture_cache_;
+	const RendererSettings& settings_;
+
+	// Ranges of every level of detail's indices in the index buffer, from the finest
+	struct LodRange {
+		std::size_t first_index;
+		std::size_t index_count;
+	};
+	std::vector<LodRange> lod_ranges_;
+	std::vector<float> lod_errors_;
+	// Bounding sphere in the mesh's space
+	glm::vec3 bounds_center_;
+	float bounds_radius_;
+
+	// Every instance's level of detail, in the model's instance slot order
+	std::vector<std::size_t> instance_lod_levels_;
+	// Instances in the instance stream, drawn with each level of detail
+	struct InstanceRange {
+		std::size_t first_instance;
+		std::size_t instance_count;
+	};
+	std::vector<InstanceRange> lod_instances_;
+	// Distance from the camera to every level's closest instance
+	std::vector<float> lod_distances_;
+	// The instances' bounding spheres follow each other in the frame's spheres
+	std::size_t first_sphere_{0u};
+
+	// Submeshes' boxes, and the visible ones' merged index ranges of the level drawn, when drawing only those
+	CullingBoxes submesh_boxes_;
+	std::vector<LodRange> submesh_draws_;
+	bool is_drawing_submeshes_{false};
+	unsigned int instance_buffer_{0u};
+	unsigned int instance_slot_buffer_{0u};
+
+	// Skinned by the vertex shader, or on the CPU into a vertex range per prepared instance
+	bool is_skinned_;
+	bool is_gpu_skinned_;
+	bool is_cpu_skinned_;
+	unsigned int skin_vbo_{0u};
+	std::vector<Vertex> skinned_vertices_;
+
+	// GL_UNSIGNED_SHORT, or GL_UNSIGNED_INT
+	unsigned int index_type_{0u};
+	std::size_t index_size_{0u};
+
+	// Decoding parameters of the uploaded vertex format
+	glm::vec3 position_scale_{1.0f};
+	glm::vec3 position_offset_{0.0f};
+	bool has_octahedral_normals_{false};
 
-	std::size_t vertex_count_;
+	unsigned int vao_{0u};
+	unsigned int vbo_{0u};
+	unsigned int ebo_{0u};
 
-	unsigned int vao_;
-	unsigned int vbo_;
+	bool is_uploaded_{false};
+	MemoryRecord memory_;
 
 	std::vector<OpenGLTexture> opengl_textures_;
+	// Sort key fields, hashed from the material, and the textures' paths
+	std::uint32_t material_key_;
+	std::uint32_t textures_key_;
 
 	void setupVertices();
 	void setupTextures();
+	// Points the instance matrix attributes at the instance stream, from the given instance on
+	void setInstancePointers(std::size_t first_instance) const;
+	// Returns whether any submesh of the single visible instance is visible
+	bool cullSubmeshes(const Frustum& frustum, const glm::mat4& world, std::size_t level, CullingStats& stats);
 };
 
 #endif // OPENGL_DRAWABLE_HH
@@ -1,20 +1,110 @@
 #ifndef OPENGL_DRAWABLE_MODEL_HH
 #define OPENGL_DRAWABLE_MODEL_HH
 
-#include "game/headers/renderer/drawable.hh"
 #include "game/headers/model/model.hh"
 #include "game/headers/model/mesh.hh"
 #include "game/headers/renderer/opengl/shader.hh"
 #include "game/headers/renderer/opengl/opengl-drawable-mesh.hh"
+#include "game/headers/renderer/opengl/opengl-render-queue.hh"
+#include "game/headers/renderer/opengl/opengl-texture-cache.hh"
+#include "game/headers/renderer/renderer-settings.hh"
+#include "game/headers/renderer/frustum.hh"
+#include "game/headers/renderer/lod-selector.hh"
+#include "game/headers/renderer/model-renderer.hh"
+#include "game/headers/utility/memory-tracker.hh"
 
+#include "external/glm/glm/glm.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
-class OpenGLDrawableModel : public Drawable {
+class OpenGLDrawableModel {
 public:
-	OpenGLDrawableModel(std::shared_ptr<Model> model, Shader& shader);
-	void draw() const override;
+	// Past the units meshes bind their textures to, the shader's skinning matrix sampler must be set to it
+	static constexpr unsigned int SKINNING_TEXTURE_UNIT{15u};
+
+	OpenGLDrawableModel(
+		std::shared_ptr<Model> model,
+		Shader& shader,
+		OpenGLTextureCache& texture_cache,
+		const RendererSettings& settings
+	);
+	~OpenGLDrawableModel();
+
+	// Owns the instance buffer
+	OpenGLDrawableModel(const OpenGLDrawableModel&) = delete;
+	OpenGLDrawableModel& operator=(const OpenGLDrawableModel&) = delete;
+
+	// Uploads every mesh at once
+	void upload();
+	void uploadMesh(std::size_t index);
+	std::size_t getMeshCount() const;
+
+	void addInstance(ModelInstanceId instance, const glm::mat4& transform);
+	void setInstanceTransform(ModelInstanceId instance, const glm::mat4& transform);
+	// Throws std::invalid_argument unless there is a matrix for every joint of the model's skeleton
+	void setInstanceSkinningMatrices(ModelInstanceId instance, const std::vector<glm::mat4>& skinning_matrices);
+	void removeInstance(ModelInstanceId instance);
+	std::size_t getInstanceCount() const;
+
+	// Adds the bounding sphere of every mesh's every instance, call it once per frame before prepareInstances()
+	void addBounds(CullingSpheres& spheres);
+
+	/**
+	 * Picks the levels of detail of the instances whose spheres are visible, and uploads this frame's
+	 * instance transforms, and the skinning matrices changed since the last frame. Call it once per
+	 * frame, after the spheres were culled, and before submit().
+	 */
+	void prepareInstances(
+		const LodSelector& selector,
+		const Frustum& frustum,
+		const CullingSpheres& spheres,
+		CullingStats& stats
+	);
+
+	// Submits every mesh's draws of the prepared instances
+	void submit(OpenGLRenderQueue& queue) const;
+	// Binds the skinning matrices of a model skinned on the GPU, returns whether there were any to bind
+	bool bindSkinning(const Shader& shader, const OpenGLMeshUniforms& uniforms) const;
+
+	/**
+	 * The model's own memory, its meshes' buffers, and the textures they use.
+	 * A texture shared with other models is included in each of them.
+	 */
+	MemoryUsage getMemoryUsage() const;
 private:
+	// Keeps the model alive, as the renderer finds drawables by their model's address
+	std::shared_ptr<Model> model_;
 	std::vector<OpenGLDrawableMesh> meshes_;
+	const RendererSettings& settings_;
+
+	// Instances are packed in slots, a removed instance's slot is filled by the last one
+	std::vector<ModelInstanceId> instance_ids_;
+	std::vector<glm::mat4> instance_transforms_;
+	std::unordered_map<ModelInstanceId, std::size_t> instance_slots_;
+
+	// Every mesh's instance transforms, grouped by level of detail, rebuilt every frame
+	std::vector<glm::mat4> instance_stream_;
+	unsigned int instance_buffer_{0u};
+	// Every instance's slot, in the instance stream's order
+	std::vector<std::uint32_t> instance_slot_stream_;
+	unsigned int instance_slot_buffer_{0u};
+
+	// Joint count skinning matrices per instance slot, read by the vertex shader from a texture buffer
+	std::size_t joint_count_;
+	std::vector<glm::mat4> skinning_matrices_;
+	bool are_skinning_matrices_changed_{false};
+	unsigned int skinning_buffer_{0u};
+	unsigned int skinning_texture_{0u};
+	MemoryRecord memory_;
+
+	bool isSkinned() const;
+	void createInstanceBuffer();
+	void uploadSkinningMatrices();
+	void updateMemoryRecord();
 };
 
 #endif // OPENGL_DRAWABLE_MODEL_HH
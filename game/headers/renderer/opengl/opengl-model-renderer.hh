@@ -3,20 +3,57 @@
 
 #include "game/headers/renderer/model-renderer.hh"
 #include "game/headers/renderer/opengl/opengl-drawable-model.hh"
+#include "game/headers/renderer/opengl/opengl-render-queue.hh"
+#include "game/headers/renderer/opengl/opengl-uniform-buffer.hh"
+#include "game/headers/renderer/opengl/opengl-upload-queue.hh"
+#include "game/headers/renderer/opengl/opengl-texture-cache.hh"
+
+#include <future>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
 class OpenGLModelRenderer : public ModelRenderer {
 public:
 	OpenGLModelRenderer() = default;
 
-	void init(Screen screen, const Camera* camera) override;
+	void init(Screen screen, const Camera* camera, RendererSettings settings) override;
 	void addModel(std::shared_ptr<Model> model) override;
+	void addModel(std::future<std::shared_ptr<Model>> model) override;
+	ModelInstanceId addInstance(std::shared_ptr<Model> model, const glm::mat4& transform) override;
+	void setInstanceTransform(ModelInstanceId instance, const glm::mat4& transform) override;
+	void setInstanceSkinningMatrices(ModelInstanceId instance, const std::vector<glm::mat4>& skinning_matrices) override;
+	void removeInstance(ModelInstanceId instance) override;
+	void update() override;
 	void draw() const override;
+	MemoryUsage getMemoryUsage(const Model& model) const override;
+	MemoryUsage getMemoryUsage() const override;
+	CullingStats getCullingStats() const override;
 private:
 	Screen screen_;
 	const Camera* camera_;
+	RendererSettings settings_;
 	Shader mesh_shader_;
+	// Uniform blocks written once per frame, and shared by every shader
+	mutable OpenGLUniformBuffer frame_uniforms_;
+	mutable OpenGLUniformBuffer light_uniforms_;
+	OpenGLTextureCache texture_cache_;
+	// Rebuilt every draw(), kept to reuse their memory
+	mutable OpenGLRenderQueue render_queue_;
+	mutable CullingSpheres culling_spheres_;
+	mutable CullingStats culling_stats_{};
+
+	// One drawable per model, shared by every instance of the model
+	std::unordered_map<const Model*, std::shared_ptr<OpenGLDrawableModel>> models_;
+	std::unordered_map<ModelInstanceId, const Model*> instance_models_;
+	ModelInstanceId next_instance_id_{1u};
+
+	std::vector<std::future<std::shared_ptr<Model>>> pending_models_;
+	OpenGLUploadQueue upload_queue_;
 
-	std::vector<OpenGLDrawableModel> models_;
+	// Finds the model's drawable, or creates one whose upload is queued
+	OpenGLDrawableModel& getDrawable(const std::shared_ptr<Model>& model);
+	void queueUpload(const std::shared_ptr<OpenGLDrawableModel>& model);
 };
 
 #endif // OPENGL_MODEL_RENDERER_HH
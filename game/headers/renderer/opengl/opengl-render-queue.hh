@@ -0,0 +1,64 @@
+#ifndef OPENGL_RENDER_QUEUE_HH
+#define OPENGL_RENDER_QUEUE_HH
+
+#include "game/headers/renderer/draw-key.hh"
+#include "game/headers/renderer/opengl/shader.hh"
+#include "game/headers/utility/radix-sort.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class OpenGLDrawableModel;
+class OpenGLDrawableMesh;
+
+// The mesh shader's uniforms set between draws
+struct OpenGLMeshUniforms {
+	ShaderUniform<glm::vec3> color_ambient;
+	ShaderUniform<glm::vec3> color_diffuse;
+	ShaderUniform<glm::vec3> color_specular;
+	ShaderUniform<float> shininess;
+	ShaderUniform<glm::vec3> vertex_position_scale;
+	ShaderUniform<glm::vec3> vertex_position_offset;
+	ShaderUniform<bool> vertex_octahedral_normals;
+	ShaderUniform<bool> skinned;
+	ShaderUniform<int> joint_count;
+
+	OpenGLMeshUniforms() = default;
+	explicit OpenGLMeshUniforms(const Shader& shader);
+};
+
+// One draw of a mesh's instances at a level of detail, the model binds their skinning matrices
+struct OpenGLDrawPacket {
+	const OpenGLDrawableModel* model;
+	const OpenGLDrawableMesh* mesh;
+	std::uint32_t level;
+};
+
+/**
+ * Draws of a frame, sorted by their draw_key before they are issued, so draws needing the same state
+ * follow each other. Packets point at the drawables, which must outlive the frame's execute().
+ */
+class OpenGLRenderQueue {
+public:
+	OpenGLRenderQueue() = default;
+	// Draws with the shader, which must be in use when executing
+	explicit OpenGLRenderQueue(const Shader& shader);
+
+	// Drops the packets, keeping their memory for the next frame
+	void clear();
+	void submit(std::uint64_t sort_key, const OpenGLDrawPacket& packet);
+	void sort();
+	// Issues the packets in order, setting only the state which differs from the previous packet's
+	void execute() const;
+	std::size_t getPacketCount() const;
+private:
+	const Shader* shader_{nullptr};
+	OpenGLMeshUniforms uniforms_;
+	std::vector<OpenGLDrawPacket> packets_;
+	// Packets' indices by key, and the radix sort's scratch, both reused every frame
+	std::vector<SortEntry> order_;
+	std::vector<SortEntry> scratch_;
+};
+
+#endif // OPENGL_RENDER_QUEUE_HH
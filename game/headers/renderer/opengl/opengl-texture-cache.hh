@@ -0,0 +1,124 @@
+#ifndef OPENGL_TEXTURE_CACHE_HH
+#define OPENGL_TEXTURE_CACHE_HH
+
+#include "game/headers/utility/memory-tracker.hh"
+
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * OpenGL texture object, deleted together with its last owner.
+ */
+class OpenGLCachedTexture {
+public:
+	explicit OpenGLCachedTexture(unsigned int id);
+	~OpenGLCachedTexture();
+
+	OpenGLCachedTexture(const OpenGLCachedTexture&) = delete;
+	OpenGLCachedTexture& operator=(const OpenGLCachedTexture&) = delete;
+
+	unsigned int getId() const;
+	// Until the image is loaded, the texture holds a single placeholder texel
+	bool isLoaded() const;
+	const MemoryUsage& getMemoryUsage() const;
+private:
+	unsigned int id_;
+	bool is_loaded_{false};
+	MemoryRecord memory_;
+
+	friend class OpenGLTextureCache;
+};
+
+/**
+ * Hands out shared textures, so an image used by many meshes is loaded only once.
+ * Baked textures are uploaded right away. Other images are decoded on the game's thread pool, and copied into pixel buffer
+ * objects by it, so the OpenGL thread only issues the transfers.
+ * Must be used on the OpenGL context's thread only.
+ */
+class OpenGLTextureCache {
+public:
+	OpenGLTextureCache() = default;
+	~OpenGLTextureCache();
+
+	OpenGLTextureCache(const OpenGLTextureCache&) = delete;
+	OpenGLTextureCache& operator=(const OpenGLTextureCache&) = delete;
+
+	/**
+	 * Returns the texture of the image file, starting its load if nobody holds it at the moment.
+	 * The texture is usable immediately, its image is filled in by update().
+	 */
+	std::shared_ptr<OpenGLCachedTexture> acquire(const std::string& path);
+
+	/**
+	 * Advances pending loads until the time budget is spent, and forgets released textures.
+	 * Call once per frame.
+	 */
+	void update(double budget_ms);
+
+	// Every live texture, and the images, and pixel buffers of pending loads
+	MemoryUsage getMemoryUsage() const;
+private:
+	struct DecodedImage {
+		int width{0};
+		int height{0};
+		int channels{0};
+		std::shared_ptr<unsigned char> pixels;
+	};
+
+	enum class UploadStage {
+		Decoding,
+		Copying,
+		// The base level is transferred, mipmaps are generated once the transfer is done
+		Transferring
+	};
+
+	struct PixelBuffer {
+		unsigned int id{0};
+		std::size_t size{0};
+	};
+
+	struct PendingUpload {
+		std::weak_ptr<OpenGLCachedTexture> texture;
+		std::string path;
+		UploadStage stage{UploadStage::Decoding};
+		std::future<DecodedImage> decoded;
+		DecodedImage image;
+		PixelBuffer pixel_buffer;
+		std::future<void> copied;
+		// Signaled once the pixel buffer's transfer is done, a GLsync
+		void* transferred{nullptr};
+		// The decoded image, until it is copied into the pixel buffer
+		MemoryRecord memory;
+	};
+
+	// Keyed by the resolved path, so different spellings of a path share a texture
+	std::unordered_map<std::string, std::weak_ptr<OpenGLCachedTexture>> textures_;
+	std::vector<PendingUpload> pending_uploads_;
+	// Pixel buffers are reused, their storage is orphaned on every upload
+	std::vector<PixelBuffer> free_pixel_buffers_;
+	// Storage of every pixel buffer, free or in use
+	std::size_t pixel_buffer_bytes_{0};
+	MemoryRecord staging_memory_;
+
+	static std::string resolvePath(const std::string& path);
+	static DecodedImage decodeImage(const std::string& path);
+	/**
+	 * Uploads the image's baked texture into the bound texture, if there is one.
+	 * Returns the size of the uploaded levels, or zero.
+	 */
+	static std::size_t loadBakedTexture(const std::string& path);
+
+	// Each returns true if the upload is finished, or abandoned
+	bool startCopy(PendingUpload& upload);
+	bool finishUpload(PendingUpload& upload);
+	bool finishMipmaps(PendingUpload& upload);
+
+	PixelBuffer acquirePixelBuffer();
+	void resizePixelBuffer(PixelBuffer& buffer, std::size_t size);
+};
+
+#endif // OPENGL_TEXTURE_CACHE_HH
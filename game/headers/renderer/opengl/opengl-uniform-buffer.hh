@@ -0,0 +1,49 @@
+#ifndef OPENGL_UNIFORM_BUFFER_HH
+#define OPENGL_UNIFORM_BUFFER_HH
+
+#include <array>
+#include <cstddef>
+
+/**
+ * A uniform block's data, streamed once per frame through a ring of regions of one buffer. Every update
+ * writes the next region, unsynchronized, after waiting for the fence of the frame which last read it,
+ * so neither the GPU's reads, nor the driver's buffer tracking stall the writes.
+ * The region written last stays bound to the block's binding point until the next update.
+ */
+class OpenGLUniformBuffer {
+public:
+	// Frames the GPU may lag behind, and still have its region to itself
+	static constexpr std::size_t REGION_COUNT{3u};
+
+	OpenGLUniformBuffer() = default;
+	~OpenGLUniformBuffer();
+
+	// Owns the buffer, and its fences
+	OpenGLUniformBuffer(const OpenGLUniformBuffer&) = delete;
+	OpenGLUniformBuffer& operator=(const OpenGLUniformBuffer&) = delete;
+
+	// Creates the buffer, for blocks of the given size, on the OpenGL context's thread
+	void init(unsigned int binding, std::size_t size);
+
+	// Throws std::invalid_argument if the size is not the block's
+	void update(const void* data, std::size_t size);
+
+	template <typename T>
+	void update(const T& block) {
+		update(&block, sizeof(T));
+	}
+private:
+	unsigned int binding_{0u};
+	unsigned int buffer_{0u};
+	std::size_t size_{0u};
+	// Region size rounded up to the binding offset alignment
+	std::size_t region_stride_{0u};
+	std::size_t region_{0u};
+	bool has_written_{false};
+	// Fenced after the frame which read each region, a GLsync
+	std::array<void*, REGION_COUNT> fences_{};
+
+	void waitForRegion(std::size_t region);
+};
+
+#endif // OPENGL_UNIFORM_BUFFER_HH
@@ -0,0 +1,28 @@
+#ifndef OPENGL_UPLOAD_QUEUE_HH
+#define OPENGL_UPLOAD_QUEUE_HH
+
+#include <deque>
+#include <functional>
+
+/**
+ * Queue of GPU object creation jobs, which must run on the OpenGL context's thread.
+ * Jobs are spread across frames, so a big upload does not stall a single frame.
+ */
+class OpenGLUploadQueue {
+public:
+	using Job = std::function<void()>;
+
+	void push(Job job);
+
+	/**
+	 * Runs queued jobs until the time budget is spent.
+	 * At least one job runs per call, so the queue always makes progress.
+	 */
+	void process(double budget_ms);
+
+	bool isEmpty() const;
+private:
+	std::deque<Job> jobs_;
+};
+
+#endif // OPENGL_UPLOAD_QUEUE_HH
@@ -3,16 +3,36 @@
 
 #include "external/glm/glm/glm.hpp"
 
+#include <cstddef>
+#include <cstdint>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Handle of a shader's uniform, set with values of type T: bool, int for ints, and samplers, float,
+ * glm::vec3, glm::mat3, or glm::mat4. A default handle, or one of a uniform the linker removed, sets nothing.
+ */
+template <typename T>
+struct ShaderUniform {
+	static constexpr std::uint32_t NONE{~std::uint32_t{0u}};
+	std::uint32_t index{NONE};
+
+	bool isActive() const {
+		return index != NONE;
+	}
+};
 
 class Shader {
 public:
 	Shader() = default;
 	/**
-	 * Takes paths to shaders' source files.
+	 * Takes paths to shaders' source files. The linked program's active uniforms are enumerated
+	 * once, so setting them never looks up their names, and its shared uniform blocks are bound
+	 * to their binding points, see uniform-blocks.hh.
 	 */
 	Shader(const std::string& vertex_shader_path, const std::string& fragment_shader_path);
 
@@ -21,13 +41,35 @@ public:
 	// Sets the program for use
 	void use() const;
 
-	void setBool(const std::string& name, bool value) const;
-	void setInt(const std::string& name, int value) const;
-	void setFloat(const std::string& name, float value) const;
-	void setVec3(const std::string& name, glm::vec3 value) const;
-	void setMat3(const std::string& name, glm::mat3 value) const;
-	void setMat4(const std::string& name, glm::mat4 value) const;
+	/**
+	 * Finds an active uniform, array uniforms by their name without "[0]". Throws std::invalid_argument
+	 * if the uniform's type cannot be set with T, a uniform the shader does not use gets a handle which sets nothing.
+	 */
+	template <typename T>
+	ShaderUniform<T> getUniform(const std::string& name) const;
+
+	/**
+	 * Sets a uniform of the program, which must be in use. A value equal to the last one set is not uploaded again.
+	 */
+	template <typename T>
+	void set(ShaderUniform<T> uniform, const T& value) const;
 private:
+	struct UniformInfo {
+		std::string name;
+		// GL_FLOAT_VEC3, GL_SAMPLER_2D, and so on
+		unsigned int type;
+		int location;
+		// Of the last value set in the value cache, whose size is the value type's
+		std::size_t value_offset;
+		bool has_value;
+	};
+	// Uniforms, and the last values set, caching is what setting a const shader changes
+	mutable std::vector<UniformInfo> uniforms_;
+	mutable std::vector<unsigned char> values_;
+	std::unordered_map<std::string, std::uint32_t> uniform_indices_;
+
+	void reflectUniforms();
+	void bindUniformBlocks() const;
 };
 
 #endif // SHADER_HH
@@ -0,0 +1,49 @@
+#ifndef UNIFORM_BLOCKS_HH
+#define UNIFORM_BLOCKS_HH
+
+#include "external/glm/glm/glm.hpp"
+
+#include <cstddef>
+
+/**
+ * Uniform blocks shared by every shader, laid out as the shaders' std140 blocks of the same names.
+ * A vec3 is aligned to 16 bytes in std140, a float which follows it fills its padding.
+ */
+namespace uniform_blocks {
+
+	// Binding points, every program's blocks are bound to them by name when it is linked
+	constexpr unsigned int FRAME_BINDING{0u};
+	constexpr unsigned int LIGHT_BINDING{1u};
+	constexpr const char* FRAME_BLOCK_NAME{"Frame"};
+	constexpr const char* LIGHT_BLOCK_NAME{"Light"};
+
+	struct Frame {
+		glm::mat4 view;
+		glm::mat4 projection;
+		glm::vec3 camera_position;
+		// Seconds since the start
+		float time;
+	};
+	static_assert(offsetof(Frame, projection) == 64u, "the frame block must match its std140 layout");
+	static_assert(offsetof(Frame, camera_position) == 128u, "the frame block must match its std140 layout");
+	static_assert(offsetof(Frame, time) == 140u, "the frame block must match its std140 layout");
+	static_assert(sizeof(Frame) == 144u, "the frame block must match its std140 layout");
+
+	struct Light {
+		glm::vec3 position;
+		float padding_0;
+		glm::vec3 color_ambient;
+		float padding_1;
+		glm::vec3 color_diffuse;
+		float padding_2;
+		glm::vec3 color_specular;
+		float padding_3;
+	};
+	static_assert(offsetof(Light, color_ambient) == 16u, "the light block must match its std140 layout");
+	static_assert(offsetof(Light, color_diffuse) == 32u, "the light block must match its std140 layout");
+	static_assert(offsetof(Light, color_specular) == 48u, "the light block must match its std140 layout");
+	static_assert(sizeof(Light) == 64u, "the light block must match its std140 layout");
+
+} // namespace uniform_blocks
+
+#endif // UNIFORM_BLOCKS_HH
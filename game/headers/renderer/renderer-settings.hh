@@ -0,0 +1,50 @@
+#ifndef RENDERER_SETTINGS_HH
+#define RENDERER_SETTINGS_HH
+
+#include "game/headers/model/vertex-compression.hh"
+
+// Where skinned meshes are deformed by their instances' skinning matrices
+enum class SkinningMode {
+	// The vertex shader reads the matrices from a texture buffer, every instance is drawn by the same draw call
+	Gpu,
+	// Every instance's vertices are skinned each frame, and streamed to the GPU, for drivers the shader path fails on
+	Cpu
+};
+
+struct RendererSettings {
+	// Time spent on uploading loaded models to the GPU, per frame
+	double upload_budget_ms{2.0};
+	// Time spent on issuing texture transfers, per frame
+	double texture_upload_budget_ms{1.0};
+
+	/**
+	 * Layout of uploaded vertex buffers. The compact layouts are opt-in: half float texture coordinates
+	 * lose precision on tiled coordinates, and quantized positions of neighbouring meshes round
+	 * differently on each side of a seam.
+	 */
+	VertexFormat vertex_format{VertexFormat::Full};
+	/**
+	 * With CompactQuantized, static batches, and meshes larger than this along any axis,
+	 * in the mesh's units, keep float positions, as the 16-bit step is a 65535th of the extent.
+	 */
+	float max_quantized_extent{16.0f};
+	// Logs every uploaded mesh's largest vertex quantization error
+	bool validate_vertex_format{false};
+
+	// Largest error of a mesh's level of detail, projected onto the screen
+	float lod_error_pixels{1.0f};
+	// Fraction of the error a coarser level must stay below before it replaces the current one
+	float lod_hysteresis{0.25f};
+
+	/**
+	 * Frees a mesh's CPU vertices, and indices once they are uploaded, only collision sources keep
+	 * a position-only copy. A model whose drawable is dropped with its last instance must be loaded
+	 * again before it is drawn, the renderer rejects new instances of it.
+	 */
+	bool release_uploaded_geometry{true};
+
+	// Skinned meshes keep their geometry on the CPU path, regardless of release_uploaded_geometry
+	SkinningMode skinning_mode{SkinningMode::Gpu};
+};
+
+#endif // RENDERER_SETTINGS_HH
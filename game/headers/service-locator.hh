@@ -4,16 +4,33 @@
 #include "game/headers/model/model-loader.hh"
 #include "game/headers/renderer/model-renderer.hh"
 #include "game/headers/utility/logger.hh"
+#include "game/headers/utility/thread-pool.hh"
+#include "game/headers/utility/memory-tracker.hh"
+#include "game/headers/utility/virtual-file-system.hh"
 
 #include <memory>
 
+// Native loaders parse the formats they know by themselves, and hand the rest to Assimp
+enum class ModelLoaderType {
+	Native,
+	Assimp
+};
+
 class ServiceLocator {
 public:
 	static ServiceLocator& getInstance();
 
-	std::unique_ptr<ModelLoader> getModelLoader() const;
+	std::unique_ptr<ModelLoader> getModelLoader(ModelLoaderType type = ModelLoaderType::Native) const;
+	// Defined with getCurrentTime() in service-locator-opengl.cc, which offline tools leave out
 	std::unique_ptr<ModelRenderer> getModelRenderer() const;
 	std::unique_ptr<Logger> getLogger() const;
+	// The pool is shared by the whole game
+	ThreadPool& getThreadPool() const;
+	// Memory used by models, and their GPU resources
+	MemoryTracker& getMemoryTracker() const;
+	// Every asset is read through it
+	VirtualFileSystem& getFileSystem() const;
+	// Seconds since the window library started
 	double getCurrentTime() const;
 private:
 	ServiceLocator() = default;
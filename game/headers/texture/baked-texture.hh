@@ -0,0 +1,65 @@
+#ifndef BAKED_TEXTURE_HH
+#define BAKED_TEXTURE_HH
+
+#include "game/headers/utility/virtual-file-system.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class BakedTextureFormat : std::uint32_t {
+	BC1 = 1,
+	BC3 = 3,
+	BC4 = 4
+};
+
+struct BakedMipLevel {
+	std::uint32_t width;
+	std::uint32_t height;
+	const unsigned char* data;
+	std::size_t size;
+};
+
+/**
+ * Block compressed texture with a precomputed mip chain, produced by the texture-baker tool.
+ * The file is read through the virtual file system, and the mip levels point straight into its contents.
+ */
+class BakedTexture {
+public:
+	/**
+	 * Throws std::runtime_error if the file is not a valid baked texture.
+	 */
+	BakedTexture(const VirtualFileSystem& file_system, const std::string& path);
+
+	BakedTextureFormat getFormat() const;
+	// The first level is the full resolution image
+	const std::vector<BakedMipLevel>& getMipLevels() const;
+
+	/**
+	 * Path of the baked texture belonging to a source image.
+	 */
+	static std::string getBakedPath(const std::string& source_path);
+
+	/**
+	 * Returns true if a baked texture exists, and it is not older than its source image.
+	 */
+	static bool isAvailable(const VirtualFileSystem& file_system, const std::string& source_path);
+
+	/**
+	 * Writes compressed mip levels, from the largest to the smallest, into a baked texture file.
+	 */
+	static void write(
+		const std::string& path,
+		BakedTextureFormat format,
+		std::uint32_t width,
+		std::uint32_t height,
+		const std::vector<std::vector<std::uint8_t>>& mip_levels
+	);
+private:
+	AssetFile file_;
+	BakedTextureFormat format_;
+	std::vector<BakedMipLevel> mip_levels_;
+};
+
+#endif // BAKED_TEXTURE_HH
@@ -0,0 +1,36 @@
+#ifndef BLOCK_COMPRESSION_HH
+#define BLOCK_COMPRESSION_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Encoders for the BC1 (DXT1), BC3 (DXT5), and BC4 (RGTC1) block compression formats.
+ * Blocks are 4 * 4 texels, stored row by row.
+ */
+namespace block_compression {
+
+	constexpr std::size_t BC1_BLOCK_SIZE{8};
+	constexpr std::size_t BC3_BLOCK_SIZE{16};
+	constexpr std::size_t BC4_BLOCK_SIZE{8};
+
+	// Opaque RGB block, from 16 RGBA texels; alpha is ignored
+	void compressBC1Block(const std::uint8_t rgba[64], std::uint8_t block[BC1_BLOCK_SIZE]);
+	// RGBA block, from 16 RGBA texels
+	void compressBC3Block(const std::uint8_t rgba[64], std::uint8_t block[BC3_BLOCK_SIZE]);
+	// Single channel block, from 16 values
+	void compressBC4Block(const std::uint8_t values[16], std::uint8_t block[BC4_BLOCK_SIZE]);
+
+	/**
+	 * Compresses a whole RGBA image. Partial blocks at the right,
+	 * and bottom edges repeat the edge texels.
+	 * For BC4 only the red channel is used.
+	 */
+	std::vector<std::uint8_t> compressBC1Image(const std::uint8_t* rgba, int width, int height);
+	std::vector<std::uint8_t> compressBC3Image(const std::uint8_t* rgba, int width, int height);
+	std::vector<std::uint8_t> compressBC4Image(const std::uint8_t* rgba, int width, int height);
+
+} // namespace block_compression
+
+#endif // BLOCK_COMPRESSION_HH
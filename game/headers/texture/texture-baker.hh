@@ -0,0 +1,33 @@
+#ifndef TEXTURE_BAKER_HH
+#define TEXTURE_BAKER_HH
+
+#include "game/headers/texture/baked-texture.hh"
+
+#include <optional>
+#include <string>
+
+/**
+ * Offline conversion of images into baked, block compressed textures.
+ */
+namespace texture_baker {
+
+	/**
+	 * Single channel images become BC4, images with transparency BC3, and the rest BC1.
+	 */
+	BakedTextureFormat chooseFormat(int channels, bool has_transparency);
+
+	/**
+	 * Decodes the source image, generates its full mip chain, and writes it
+	 * block compressed. Without a given format, chooseFormat() decides.
+	 * BC4 textures hold the image's luminance.
+	 * Throws std::runtime_error on failure.
+	 */
+	void bake(
+		const std::string& source_path,
+		const std::string& baked_path,
+		std::optional<BakedTextureFormat> format
+	);
+
+} // namespace texture_baker
+
+#endif // TEXTURE_BAKER_HH
@@ -0,0 +1,71 @@
+#ifndef ASSET_ARCHIVE_HH
+#define ASSET_ARCHIVE_HH
+
+#include "game/headers/utility/mapped-file.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+enum class AssetCompression : std::uint32_t {
+	None = 0,
+	LZ4 = 1
+};
+
+struct AssetEntry {
+	// Normalized, relative to the game's directory, like VirtualFileSystem::normalizePath() returns them
+	std::string path;
+	std::uint64_t offset;
+	std::uint64_t stored_size;
+	std::uint64_t size;
+	AssetCompression compression;
+	// Of the packed file, in the same units as std::filesystem::file_time_type
+	std::int64_t modification_time;
+};
+
+struct AssetArchiveSource {
+	// Path inside the archive
+	std::string path;
+	// Path of the file to pack
+	std::string file_path;
+};
+
+/**
+ * Many asset files packed into one, with a table of contents at its end, produced by the asset-packer tool.
+ * The archive is memory-mapped, every entry starts on a page boundary, and is stored either as it is, or LZ4 compressed.
+ */
+class AssetArchive {
+public:
+	/**
+	 * Throws std::runtime_error if the file is not a valid archive.
+	 */
+	explicit AssetArchive(const std::string& path);
+
+	AssetArchive(const AssetArchive&) = delete;
+	AssetArchive& operator=(const AssetArchive&) = delete;
+
+	const std::string& getPath() const;
+	// Nullptr if the archive has no such entry
+	const AssetEntry* find(std::string_view path) const;
+	const std::vector<AssetEntry>& getEntries() const;
+	// Shared, so views into the mapping can outlive the archive
+	const std::shared_ptr<const MappedFile>& getFile() const;
+
+	/**
+	 * Packs the files into an archive. Entries are compressed only if it makes them noticeably smaller.
+	 * Throws std::runtime_error if a file cannot be read, or the archive cannot be written.
+	 */
+	static void write(const std::string& path, const std::vector<AssetArchiveSource>& sources, bool allow_compression);
+private:
+	std::string path_;
+	std::shared_ptr<const MappedFile> file_;
+	std::vector<AssetEntry> entries_;
+	// Views into the entries' paths, the entries never change after loading
+	std::unordered_map<std::string_view, std::size_t> entry_indices_;
+};
+
+#endif // ASSET_ARCHIVE_HH
@@ -0,0 +1,61 @@
+#ifndef BINARY_STREAM_HH
+#define BINARY_STREAM_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Serializes trivially copyable values into a growing byte buffer.
+ * Values are stored in the host's byte order.
+ */
+class BinaryWriter {
+public:
+	template <typename T>
+	void write(const T& value);
+	template <typename T>
+	void writeArray(const T* values, std::size_t count);
+	template <typename T>
+	void writeVector(const std::vector<T>& values);
+	void writeString(std::string_view str);
+	// Pads the buffer with zeros up to the given alignment
+	void align(std::size_t alignment);
+
+	std::size_t size() const;
+	const std::vector<unsigned char>& getBuffer() const;
+private:
+	std::vector<unsigned char> buffer_;
+};
+
+/**
+ * Deserializes values written by the BinaryWriter.
+ * Reading past the end of the data throws std::out_of_range.
+ */
+class BinaryReader {
+public:
+	BinaryReader(const unsigned char* data, std::size_t size);
+
+	template <typename T>
+	T read();
+	template <typename T>
+	std::vector<T> readVector();
+	std::string readString();
+	void align(std::size_t alignment);
+	/**
+	 * Returns a pointer to the next bytes, and skips over them.
+	 */
+	const unsigned char* skip(std::size_t bytes);
+
+	std::size_t getPosition() const;
+	bool isAtEnd() const;
+private:
+	const unsigned char* data_;
+	std::size_t size_;
+	std::size_t position_{0};
+};
+
+#include "game/sources/utility/binary-stream.inl"
+
+#endif // BINARY_STREAM_HH
@@ -0,0 +1,36 @@
+#ifndef HASH_HH
+#define HASH_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace hash_aux {
+
+	constexpr std::uint64_t FNV_OFFSET_BASIS{0xcbf29ce484222325ull};
+	constexpr std::uint64_t FNV_PRIME{0x100000001b3ull};
+
+	/**
+	 * FNV-1a variant which consumes the data eight bytes at a time.
+	 * Not suitable for cryptographic purposes.
+	 */
+	inline std::uint64_t fnv1a(const void* data, std::size_t size,
+			std::uint64_t hash = FNV_OFFSET_BASIS) {
+		const unsigned char* bytes{static_cast<const unsigned char*>(data)};
+		std::size_t i{0};
+		for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t)) {
+			std::uint64_t word;
+			std::memcpy(&word, bytes + i, sizeof(word));
+			hash ^= word;
+			hash *= FNV_PRIME;
+		}
+		for (; i < size; ++i) {
+			hash ^= bytes[i];
+			hash *= FNV_PRIME;
+		}
+		return hash;
+	}
+
+} // namespace hash_aux
+
+#endif // HASH_HH
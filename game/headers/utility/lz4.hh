@@ -0,0 +1,28 @@
+#ifndef LZ4_HH
+#define LZ4_HH
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * LZ4 block format codec, compatible with the reference implementation's raw blocks.
+ * Compression is greedy, and meant for offline tools. Decompression is fast enough for load times.
+ */
+namespace lz4 {
+
+	std::vector<unsigned char> compress(const unsigned char* source, std::size_t size);
+
+	/**
+	 * Decompresses a block into exactly destination_size bytes.
+	 * Throws std::runtime_error if the block is malformed, or does not decompress into the expected size.
+	 */
+	void decompress(
+		const unsigned char* source,
+		std::size_t source_size,
+		unsigned char* destination,
+		std::size_t destination_size
+	);
+
+} // namespace lz4
+
+#endif // LZ4_HH
@@ -0,0 +1,38 @@
+#ifndef MAPPED_FILE_HH
+#define MAPPED_FILE_HH
+
+#include <cstddef>
+#include <string>
+
+/**
+ * Read-only memory mapping of a whole file.
+ * The constructor throws std::runtime_error if the file cannot be mapped.
+ */
+class MappedFile {
+public:
+	explicit MappedFile(const std::string& path);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+
+	const unsigned char* data() const;
+	std::size_t size() const;
+private:
+	const unsigned char* data_{nullptr};
+	std::size_t size_{0};
+
+#ifdef _WIN32
+	void* file_handle_{nullptr};
+	void* mapping_handle_{nullptr};
+#else
+	int file_descriptor_{-1};
+#endif
+
+	void unmap();
+};
+
+#endif // MAPPED_FILE_HH
@@ -0,0 +1,89 @@
+#ifndef MEMORY_TRACKER_HH
+#define MEMORY_TRACKER_HH
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+enum class MemoryCategory : std::size_t {
+	Vertices,
+	// Indices of every level of detail
+	Indices,
+	Textures,
+	// Per-instance transforms
+	Instances,
+	// Node hierarchies, and lights
+	Scene,
+	// Decoded images, and pixel buffers on their way to the GPU
+	Staging,
+	// Position-only copies of meshes released after their upload
+	Collision,
+	// Skeletons, animation clips, poses, and skinning matrices
+	Animation,
+	Count
+};
+
+enum class MemoryDomain : std::size_t {
+	Cpu,
+	Gpu,
+	Count
+};
+
+constexpr std::size_t MEMORY_CATEGORY_COUNT{static_cast<std::size_t>(MemoryCategory::Count)};
+constexpr std::size_t MEMORY_DOMAIN_COUNT{static_cast<std::size_t>(MemoryDomain::Count)};
+
+const char* getMemoryCategoryName(MemoryCategory category);
+
+// Bytes by domain, and category
+struct MemoryUsage {
+	std::array<std::array<std::size_t, MEMORY_CATEGORY_COUNT>, MEMORY_DOMAIN_COUNT> bytes{};
+
+	std::size_t get(MemoryDomain domain, MemoryCategory category) const;
+	std::size_t getTotal(MemoryDomain domain) const;
+
+	MemoryUsage& operator+=(const MemoryUsage& other);
+};
+
+/**
+ * Game-wide memory totals, every MemoryRecord adds its bytes to them.
+ * Safe to update from any thread.
+ */
+class MemoryTracker {
+public:
+	MemoryTracker() = default;
+
+	MemoryTracker(const MemoryTracker&) = delete;
+	MemoryTracker& operator=(const MemoryTracker&) = delete;
+
+	void add(MemoryDomain domain, MemoryCategory category, std::int64_t bytes);
+	MemoryUsage getUsage() const;
+private:
+	std::array<std::array<std::atomic<std::int64_t>, MEMORY_CATEGORY_COUNT>, MEMORY_DOMAIN_COUNT> bytes_{};
+};
+
+/**
+ * Memory owned by a single object, such as a mesh, or a texture. The record keeps
+ * the global tracker up to date, and takes its bytes back from it when destroyed.
+ */
+class MemoryRecord {
+public:
+	MemoryRecord() = default;
+	~MemoryRecord();
+
+	MemoryRecord(const MemoryRecord&) = delete;
+	MemoryRecord& operator=(const MemoryRecord&) = delete;
+
+	MemoryRecord(MemoryRecord&& other) noexcept;
+	MemoryRecord& operator=(MemoryRecord&& other) noexcept;
+
+	// Replaces the bytes recorded for the domain, and category
+	void set(MemoryDomain domain, MemoryCategory category, std::size_t bytes);
+	void clear();
+
+	const MemoryUsage& getUsage() const;
+private:
+	MemoryUsage usage_;
+};
+
+#endif // MEMORY_TRACKER_HH
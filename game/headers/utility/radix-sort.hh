@@ -0,0 +1,24 @@
+#ifndef RADIX_SORT_HH
+#define RADIX_SORT_HH
+
+#include <cstdint>
+#include <vector>
+
+// An index into the caller's items, and the key it is sorted by
+struct SortEntry {
+	std::uint64_t key;
+	std::uint32_t index;
+};
+
+namespace radix_sort {
+
+	/**
+	 * Stable least significant digit radix sort by key, a byte per pass. Passes over bytes every key
+	 * shares are skipped, so keys which differ in a few fields take a few passes. The scratch entries
+	 * are resized to the entries' size, keeping them between calls avoids allocating every time.
+	 */
+	void sort(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch);
+
+} // namespace radix_sort
+
+#endif // RADIX_SORT_HH
@@ -0,0 +1,87 @@
+#ifndef SIMD_HH
+#define SIMD_HH
+
+#include <cmath>
+#include <cstddef>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * The widest float vector the build targets: AVX, SSE, or a single float without either.
+ * Kernels written against it process LANE_COUNT floats per step, the arrays they work on
+ * are padded to a multiple of MAX_LANE_COUNT, so every build processes whole steps.
+ */
+namespace simd {
+
+	constexpr std::size_t MAX_LANE_COUNT{8u};
+
+#if defined(__AVX__)
+	using Floats = __m256;
+	constexpr std::size_t LANE_COUNT{8u};
+	constexpr const char* INSTRUCTION_SET{"AVX"};
+
+	inline Floats load(const float* source) { return _mm256_loadu_ps(source); }
+	inline void store(float* destination, Floats value) { _mm256_storeu_ps(destination, value); }
+	inline Floats broadcast(float value) { return _mm256_set1_ps(value); }
+	inline Floats add(Floats a, Floats b) { return _mm256_add_ps(a, b); }
+	inline Floats sub(Floats a, Floats b) { return _mm256_sub_ps(a, b); }
+	inline Floats mul(Floats a, Floats b) { return _mm256_mul_ps(a, b); }
+	inline Floats div(Floats a, Floats b) { return _mm256_div_ps(a, b); }
+	inline Floats sqrt(Floats a) { return _mm256_sqrt_ps(a); }
+	// Negates the lanes of a where b is negative
+	inline Floats flipSign(Floats a, Floats b) { return _mm256_xor_ps(a, _mm256_and_ps(b, _mm256_set1_ps(-0.0f))); }
+	// Masks have every bit of a lane set, or none
+	inline Floats lessThan(Floats a, Floats b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+	inline Floats maskOr(Floats a, Floats b) { return _mm256_or_ps(a, b); }
+	// A bit per lane of the mask, from the first lane's lowest
+	inline int getMaskBits(Floats mask) { return _mm256_movemask_ps(mask); }
+#elif defined(__SSE2__)
+	using Floats = __m128;
+	constexpr std::size_t LANE_COUNT{4u};
+	constexpr const char* INSTRUCTION_SET{"SSE2"};
+
+	inline Floats load(const float* source) { return _mm_loadu_ps(source); }
+	inline void store(float* destination, Floats value) { _mm_storeu_ps(destination, value); }
+	inline Floats broadcast(float value) { return _mm_set1_ps(value); }
+	inline Floats add(Floats a, Floats b) { return _mm_add_ps(a, b); }
+	inline Floats sub(Floats a, Floats b) { return _mm_sub_ps(a, b); }
+	inline Floats mul(Floats a, Floats b) { return _mm_mul_ps(a, b); }
+	inline Floats div(Floats a, Floats b) { return _mm_div_ps(a, b); }
+	inline Floats sqrt(Floats a) { return _mm_sqrt_ps(a); }
+	// Negates the lanes of a where b is negative
+	inline Floats flipSign(Floats a, Floats b) { return _mm_xor_ps(a, _mm_and_ps(b, _mm_set1_ps(-0.0f))); }
+	// Masks have every bit of a lane set, or none
+	inline Floats lessThan(Floats a, Floats b) { return _mm_cmplt_ps(a, b); }
+	inline Floats maskOr(Floats a, Floats b) { return _mm_or_ps(a, b); }
+	// A bit per lane of the mask, from the first lane's lowest
+	inline int getMaskBits(Floats mask) { return _mm_movemask_ps(mask); }
+#else
+	using Floats = float;
+	constexpr std::size_t LANE_COUNT{1u};
+	constexpr const char* INSTRUCTION_SET{"scalar"};
+
+	inline Floats load(const float* source) { return *source; }
+	inline void store(float* destination, Floats value) { *destination = value; }
+	inline Floats broadcast(float value) { return value; }
+	inline Floats add(Floats a, Floats b) { return a + b; }
+	inline Floats sub(Floats a, Floats b) { return a - b; }
+	inline Floats mul(Floats a, Floats b) { return a * b; }
+	inline Floats div(Floats a, Floats b) { return a / b; }
+	inline Floats sqrt(Floats a) { return std::sqrt(a); }
+	// Negates a where b is negative
+	inline Floats flipSign(Floats a, Floats b) { return b < 0.0f ? -a : a; }
+	// Masks are 1, or 0
+	inline Floats lessThan(Floats a, Floats b) { return a < b ? 1.0f : 0.0f; }
+	inline Floats maskOr(Floats a, Floats b) { return a != 0.0f || b != 0.0f ? 1.0f : 0.0f; }
+	inline int getMaskBits(Floats mask) { return mask != 0.0f ? 1 : 0; }
+#endif
+
+	static_assert(MAX_LANE_COUNT % LANE_COUNT == 0u, "padded arrays must hold whole vectors");
+
+} // namespace simd
+
+#endif // SIMD_HH
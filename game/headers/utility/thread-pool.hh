@@ -0,0 +1,52 @@
+#ifndef THREAD_POOL_HH
+#define THREAD_POOL_HH
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+class ThreadPool {
+public:
+	explicit ThreadPool(std::size_t thread_count);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/**
+	 * Queues the task, and returns a future of its result.
+	 * A pool without threads runs the task in the calling thread.
+	 */
+	template <typename F>
+	std::future<std::invoke_result_t<F>> submit(F&& task);
+
+	/**
+	 * Calls func(i) for every i in [0, count), and waits for all calls to finish.
+	 * The calling thread processes the range too, so it is safe to call
+	 * from inside a task running on this pool.
+	 * The first exception thrown by func is rethrown in the calling thread.
+	 */
+	template <typename F>
+	void parallelFor(std::size_t count, F&& func);
+
+	std::size_t getThreadCount() const;
+private:
+	std::vector<std::thread> workers_;
+	std::deque<std::function<void()>> tasks_;
+	std::mutex mutex_;
+	std::condition_variable condition_;
+	bool stopping_{false};
+
+	void enqueue(std::function<void()> task);
+	void workerLoop();
+};
+
+#include "game/sources/utility/thread-pool.inl"
+
+#endif // THREAD_POOL_HH
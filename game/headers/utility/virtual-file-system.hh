@@ -0,0 +1,86 @@
+#ifndef VIRTUAL_FILE_SYSTEM_HH
+#define VIRTUAL_FILE_SYSTEM_HH
+
+#include "game/headers/utility/asset-archive.hh"
+#include "game/headers/utility/mapped-file.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Contents of a file opened through the virtual file system.
+ * Files stored as they are point straight into a memory mapping, which they keep alive,
+ * compressed ones are decompressed into memory owned by the file.
+ */
+class AssetFile {
+public:
+	AssetFile() = default;
+
+	// Copies would point into the original's buffer
+	AssetFile(const AssetFile&) = delete;
+	AssetFile& operator=(const AssetFile&) = delete;
+
+	AssetFile(AssetFile&&) = default;
+	AssetFile& operator=(AssetFile&&) = default;
+
+	const unsigned char* data() const;
+	std::size_t size() const;
+	std::string_view getText() const;
+private:
+	std::shared_ptr<const MappedFile> mapping_;
+	std::vector<unsigned char> buffer_;
+	const unsigned char* data_{nullptr};
+	std::size_t size_{0};
+
+	friend class VirtualFileSystem;
+};
+
+struct AssetStatus {
+	std::uint64_t size;
+	// In the same units as std::filesystem::file_time_type
+	std::int64_t modification_time;
+};
+
+/**
+ * Looks files up in the mounted asset archives, and then on the disk, so loose files work without packing.
+ * Mount archives before loading anything, lookups are safe from any thread, but mounting is not.
+ */
+class VirtualFileSystem {
+public:
+	VirtualFileSystem();
+
+	VirtualFileSystem(const VirtualFileSystem&) = delete;
+	VirtualFileSystem& operator=(const VirtualFileSystem&) = delete;
+
+	/**
+	 * Archives mounted later take precedence over earlier ones.
+	 * Throws std::runtime_error if the file is not a valid archive.
+	 */
+	void mount(const std::string& archive_path);
+
+	bool exists(const std::string& path) const;
+	/**
+	 * Throws std::runtime_error if the file is neither in an archive, nor on the disk, or it cannot be read.
+	 */
+	AssetFile open(const std::string& path) const;
+	// Returns false if the file does not exist
+	bool stat(const std::string& path, AssetStatus& status) const;
+
+	/**
+	 * Spelling of a path in archives: lexically normal, with forward slashes,
+	 * and relative to the working directory the file system was created in, if it is inside of it.
+	 */
+	std::string normalizePath(const std::string& path) const;
+private:
+	std::vector<std::unique_ptr<AssetArchive>> archives_;
+	std::filesystem::path working_directory_;
+
+	const AssetEntry* find(const std::string& path, const AssetArchive*& archive) const;
+};
+
+#endif // VIRTUAL_FILE_SYSTEM_HH
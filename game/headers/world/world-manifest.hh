@@ -0,0 +1,52 @@
+#ifndef WORLD_MANIFEST_HH
+#define WORLD_MANIFEST_HH
+
+#include "external/glm/glm/glm.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// A cell of the world's grid, with the model covering it
+struct WorldChunk {
+	int x;
+	int z;
+	std::string model_path;
+};
+
+/**
+ * Lists the chunks a world is split into. Chunks are square cells of a grid on the
+ * horizontal plane, and their models are placed in world coordinates.
+ *
+ * The manifest is a text file, with one entry per line, and # starting a comment:
+ *     chunk_size <size>
+ *     origin <x> <z>
+ *     chunk <cell x> <cell z> <model path, relative to the manifest>
+ */
+class WorldManifest {
+public:
+	// Throws if the manifest cannot be read, or is malformed
+	static WorldManifest load(const std::string& path);
+
+	float getChunkSize() const;
+	// Corner of the chunk at cell (0, 0), on the horizontal plane
+	glm::vec2 getOrigin() const;
+	const std::vector<WorldChunk>& getChunks() const;
+
+	// Index of the chunk at the cell, if the world has one
+	bool findChunk(int x, int z, std::size_t& index) const;
+	// Horizontal extents of the cell
+	glm::vec2 getCellMin(int x, int z) const;
+	glm::vec2 getCellMax(int x, int z) const;
+private:
+	float chunk_size_{0.0f};
+	glm::vec2 origin_{0.0f};
+	std::vector<WorldChunk> chunks_;
+	std::unordered_map<std::uint64_t, std::size_t> chunk_cells_;
+
+	static std::uint64_t getCellKey(int x, int z);
+};
+
+#endif // WORLD_MANIFEST_HH
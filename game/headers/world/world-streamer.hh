@@ -0,0 +1,96 @@
+#ifndef WORLD_STREAMER_HH
+#define WORLD_STREAMER_HH
+
+#include "game/headers/world/world-manifest.hh"
+#include "game/headers/model/model.hh"
+#include "game/headers/model/model-loader.hh"
+#include "game/headers/renderer/camera.hh"
+#include "game/headers/renderer/model-renderer.hh"
+
+#include "external/glm/glm/glm.hpp"
+
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <vector>
+
+struct WorldStreamerSettings {
+	// Chunks closer to the camera than this are loaded, in world units
+	float load_radius{150.0f};
+	// Loaded chunks stay until they are farther than this, so a chunk on the edge is not reloaded every frame
+	float unload_radius{180.0f};
+
+	// Loads started per frame, and loads running at once
+	std::size_t max_loads_per_frame{2u};
+	std::size_t max_pending_loads{4u};
+	// Loaded chunks handed to the renderer, and chunks taken from it, per frame
+	std::size_t max_adds_per_frame{1u};
+	std::size_t max_removals_per_frame{4u};
+
+	// How much farther a chunk right behind the camera seems, when loads are prioritized
+	float behind_distance_scale{2.0f};
+
+	// Logs a warning when an unloaded chunk's GPU buffers stay in the memory tracker,
+	// so GPU memory grows with every time the chunk is loaded again
+	bool validate_gpu_memory{false};
+};
+
+/**
+ * Keeps the world's chunks around the camera loaded, and drawn by the renderer.
+ * Each chunk is a separate model, loaded on the game's thread pool, and added to the
+ * renderer as a single instance. Chunks in front of the camera are loaded first.
+ * Must be used on the renderer's thread only.
+ */
+class WorldStreamer {
+public:
+	// The loader, and the renderer must outlive the streamer
+	WorldStreamer(WorldManifest manifest, ModelLoader& loader, ModelRenderer& renderer, WorldStreamerSettings settings = {});
+	// Waits for loads still running, as they use the loader
+	~WorldStreamer();
+
+	WorldStreamer(const WorldStreamer&) = delete;
+	WorldStreamer& operator=(const WorldStreamer&) = delete;
+
+	// Call once per frame, before the renderer's update()
+	void update(const Camera& camera);
+
+	std::size_t getLoadedChunkCount() const;
+	std::size_t getPendingChunkCount() const;
+private:
+	enum class ChunkStage {
+		Unloaded,
+		Loading,
+		Loaded,
+		// Not retried, the load already reported the error
+		Failed
+	};
+
+	struct ChunkState {
+		ChunkStage stage{ChunkStage::Unloaded};
+		std::future<std::shared_ptr<Model>> model;
+		ModelInstanceId instance{0u};
+		// Only for measuring the chunk's memory, the renderer owns the model
+		std::weak_ptr<Model> loaded_model;
+	};
+
+	WorldManifest manifest_;
+	ModelLoader& loader_;
+	ModelRenderer& renderer_;
+	WorldStreamerSettings settings_;
+
+	// Parallel to the manifest's chunks
+	std::vector<ChunkState> chunks_;
+	// Indices of chunks being loaded, and of chunks drawn by the renderer
+	std::vector<std::size_t> pending_chunks_;
+	std::vector<std::size_t> loaded_chunks_;
+
+	void finishLoads(const glm::vec2& camera_pos);
+	void removeDistantChunks(const glm::vec2& camera_pos);
+	void startLoads(const glm::vec2& camera_pos, const glm::vec2& view_direction);
+	void unloadChunk(std::size_t chunk);
+
+	// Horizontal distance from the position to the chunk's cell, zero inside it
+	float getDistance(std::size_t chunk, const glm::vec2& pos) const;
+};
+
+#endif // WORLD_STREAMER_HH
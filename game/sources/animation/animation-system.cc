@@ -0,0 +1,135 @@
+#include "game/headers/animation/animation-system.hh"
+
+#include "game/headers/service-locator.hh"
+
+#include "external/glm/glm/geometric.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+AnimationSystem::AnimationSystem(ModelRenderer& renderer, AnimationSettings settings):
+		renderer_{renderer}, settings_{settings} {
+}
+
+void AnimationSystem::addInstance(ModelInstanceId instance, std::shared_ptr<const Model> model, const glm::vec3& position) {
+	if (model->skeleton_.isEmpty()) {
+		throw std::invalid_argument("cannot animate a model without a skeleton");
+	}
+	if (instance_slots_.count(instance) != 0u) {
+		return;
+	}
+
+	instance_slots_.emplace(instance, instances_.size());
+	// Evaluated by the next update, whatever its distance
+	instances_.push_back({instance, Animator{std::move(model)}, position, std::numeric_limits<float>::infinity()});
+	updateMemoryRecord();
+}
+
+void AnimationSystem::removeInstance(ModelInstanceId instance) {
+	const auto it{instance_slots_.find(instance)};
+	if (it == instance_slots_.end()) {
+		return;
+	}
+	const std::size_t slot{it->second};
+	instance_slots_.erase(it);
+
+	// Moving the last instance into the removed one's slot
+	if (slot + 1u != instances_.size()) {
+		instances_[slot] = std::move(instances_.back());
+		instance_slots_[instances_[slot].instance] = slot;
+	}
+	instances_.pop_back();
+	updateMemoryRecord();
+}
+
+void AnimationSystem::setInstancePosition(ModelInstanceId instance, const glm::vec3& position) {
+	const auto it{instance_slots_.find(instance)};
+	if (it != instance_slots_.end()) {
+		instances_[it->second].position = position;
+	}
+}
+
+bool AnimationSystem::play(ModelInstanceId instance, const std::string& clip, float fade_duration, bool loop) {
+	const auto it{instance_slots_.find(instance)};
+	if (it == instance_slots_.end()) {
+		return false;
+	}
+	AnimatedInstance& animated{instances_[it->second]};
+	if (!animated.animator.play(clip, fade_duration, loop)) {
+		return false;
+	}
+	// A new clip is shown right away, a far instance would otherwise keep its old pose for a while
+	animated.time_since_evaluation = std::numeric_limits<float>::infinity();
+	return true;
+}
+
+void AnimationSystem::update(float frame_seconds, const glm::vec3& camera_position) {
+	const std::chrono::steady_clock::time_point start{std::chrono::steady_clock::now()};
+
+	// Every clip advances, but only the instances whose interval passed are evaluated
+	due_slots_.clear();
+	for (std::size_t slot{0u}; slot < instances_.size(); ++slot) {
+		AnimatedInstance& animated{instances_[slot]};
+		animated.animator.advance(frame_seconds);
+		animated.time_since_evaluation += frame_seconds;
+		const float interval{getUpdateInterval(glm::length(animated.position - camera_position))};
+		if (animated.time_since_evaluation >= interval) {
+			animated.time_since_evaluation = 0.0f;
+			due_slots_.push_back(slot);
+		}
+	}
+
+	// Instances are independent, each one samples into its own poses
+	const auto evaluate{[this](std::size_t i) {
+		instances_[due_slots_[i]].animator.evaluate();
+	}};
+	if (due_slots_.size() >= settings_.parallel_threshold) {
+		ServiceLocator::getInstance().getThreadPool().parallelFor(due_slots_.size(), evaluate);
+	} else {
+		for (std::size_t i{0u}; i < due_slots_.size(); ++i) {
+			evaluate(i);
+		}
+	}
+
+	// The renderer is not thread safe
+	for (std::size_t slot : due_slots_) {
+		const AnimatedInstance& animated{instances_[slot]};
+		renderer_.setInstanceSkinningMatrices(animated.instance, animated.animator.getSkinningMatrices());
+	}
+
+	stats_.instance_count = instances_.size();
+	stats_.evaluated_count = due_slots_.size();
+	stats_.update_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+float AnimationSystem::getUpdateInterval(float distance) const {
+	if (distance <= settings_.full_rate_distance) {
+		return 0.0f;
+	}
+	// The rate halves whenever the distance doubles
+	const float rate{settings_.distant_update_rate * 2.0f * settings_.full_rate_distance / distance};
+	return 1.0f / std::max(rate, settings_.min_update_rate);
+}
+
+const AnimationStats& AnimationSystem::getStats() const {
+	return stats_;
+}
+
+const AnimationSettings& AnimationSystem::getSettings() const {
+	return settings_;
+}
+
+void AnimationSystem::updateMemoryRecord() {
+	std::size_t bytes{
+		instances_.capacity() * sizeof(AnimatedInstance)
+			+ instance_slots_.size() * (sizeof(ModelInstanceId) + sizeof(std::size_t))
+			+ due_slots_.capacity() * sizeof(std::size_t)
+	};
+	for (const AnimatedInstance& animated : instances_) {
+		bytes += animated.animator.getMemorySize();
+	}
+	memory_.set(MemoryDomain::Cpu, MemoryCategory::Animation, bytes);
+}
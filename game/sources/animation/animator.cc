@@ -0,0 +1,74 @@
+#include "game/headers/animation/animator.hh"
+
+#include "game/headers/animation/pose-math.hh"
+
+#include <utility>
+
+Animator::Animator(std::shared_ptr<const Model> model):
+		model_{std::move(model)},
+		pose_{model_->skeleton_},
+		previous_pose_{model_->skeleton_} {
+	pose_math::computeSkinningMatrices(model_->skeleton_, pose_, joint_transforms_, skinning_matrices_);
+}
+
+bool Animator::play(const std::string& name, float fade_duration, bool loop, float speed) {
+	const CompressedAnimationClip* clip{model_->findAnimation(name)};
+	if (clip == nullptr) {
+		return false;
+	}
+
+	// Fading out of the bind pose is not worth it, neither is fading into the same clip.
+	// Playbacks are swapped, so each keeps its cursor's storage
+	if (current_.clip != nullptr && current_.clip != clip && fade_duration > 0.0f) {
+		std::swap(previous_, current_);
+		fade_time_ = 0.0f;
+		fade_duration_ = fade_duration;
+	} else {
+		previous_.clip = nullptr;
+	}
+	current_.clip = clip;
+	current_.time = 0.0f;
+	current_.speed = speed;
+	current_.loop = loop;
+	return true;
+}
+
+void Animator::advance(float seconds) {
+	current_.time += seconds * current_.speed;
+	if (previous_.clip != nullptr) {
+		previous_.time += seconds * previous_.speed;
+		fade_time_ += seconds;
+		if (fade_time_ >= fade_duration_) {
+			previous_.clip = nullptr;
+		}
+	}
+}
+
+void Animator::evaluate() {
+	if (current_.clip == nullptr) {
+		return;
+	}
+
+	pose_math::sampleClip(*current_.clip, current_.time, current_.loop, current_.cursor, pose_);
+	if (previous_.clip != nullptr) {
+		pose_math::sampleClip(*previous_.clip, previous_.time, previous_.loop, previous_.cursor, previous_pose_);
+		pose_math::blendPoses(previous_pose_, pose_, fade_time_ / fade_duration_, pose_);
+	}
+	pose_math::computeSkinningMatrices(model_->skeleton_, pose_, joint_transforms_, skinning_matrices_);
+}
+
+const std::vector<glm::mat4>& Animator::getSkinningMatrices() const {
+	return skinning_matrices_;
+}
+
+const std::shared_ptr<const Model>& Animator::getModel() const {
+	return model_;
+}
+
+std::size_t Animator::getMemorySize() const {
+	return pose_.getMemorySize()
+		+ previous_pose_.getMemorySize()
+		+ current_.cursor.getMemorySize()
+		+ previous_.cursor.getMemorySize()
+		+ (joint_transforms_.capacity() + skinning_matrices_.capacity()) * sizeof(glm::mat4);
+}
@@ -0,0 +1,129 @@
+#include "game/headers/animation/clip-cursor.hh"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace {
+
+	// Keys a track's cursor steps over, before searching the track instead
+	constexpr std::uint32_t MAX_FORWARD_STEPS{4u};
+
+	/**
+	 * Moves the track's key to the last one at, or before the position, and returns the next key's weight.
+	 * A position before the first key, or after the last one holds it.
+	 */
+	float seekTrack(
+		const std::vector<AnimationKey>& keys,
+		const AnimationTrack& track,
+		float frame_position,
+		std::uint32_t& key,
+		std::uint32_t& next_key
+	) {
+		const std::uint32_t end{track.first_key + track.key_count};
+		bool is_found{key == track.first_key || static_cast<float>(keys[key].frame) <= frame_position};
+		for (std::uint32_t step{0u}; is_found && key + 1u < end && static_cast<float>(keys[key + 1u].frame) <= frame_position; ++step) {
+			if (step == MAX_FORWARD_STEPS) {
+				is_found = false;
+				break;
+			}
+			++key;
+		}
+		if (!is_found) {
+			const AnimationKey* first{keys.data() + track.first_key};
+			const AnimationKey* next{
+				std::upper_bound(first, keys.data() + end, frame_position, [](float position, const AnimationKey& other) {
+					return position < static_cast<float>(other.frame);
+				})
+			};
+			key = track.first_key + static_cast<std::uint32_t>(std::max<std::ptrdiff_t>(next - first - 1, 0));
+		}
+
+		next_key = std::min(key + 1u, end - 1u);
+		const float from_frame{static_cast<float>(keys[key].frame)};
+		if (next_key == key || frame_position <= from_frame) {
+			return 0.0f;
+		}
+		return std::min((frame_position - from_frame) / static_cast<float>(keys[next_key].frame - keys[key].frame), 1.0f);
+	}
+
+} // namespace
+
+void ClipCursor::seek(const CompressedAnimationClip& clip, float frame_position) {
+	const std::size_t padded_joint_count{getPaddedJointCount(clip.joint_count)};
+	if (clip_ != &clip) {
+		clip_ = &clip;
+		keys_.resize(3u * clip.joint_count);
+		for (std::size_t joint{0u}; joint < clip.joint_count; ++joint) {
+			keys_[3u * joint] = clip.joints[joint].translation.first_key;
+			keys_[3u * joint + 1u] = clip.joints[joint].rotation.first_key;
+			keys_[3u * joint + 2u] = clip.joints[joint].scale.first_key;
+		}
+		if (from_keys_.getJointCount() != clip.joint_count) {
+			from_keys_ = Pose(clip.joint_count);
+			to_keys_ = Pose(clip.joint_count);
+		}
+		// Padding joints keep a zero weight
+		weights_.assign(3u * padded_joint_count, 0.0f);
+	}
+
+	float* const translation_weights{weights_.data()};
+	float* const rotation_weights{translation_weights + padded_joint_count};
+	float* const scale_weights{rotation_weights + padded_joint_count};
+	for (std::size_t joint{0u}; joint < clip.joint_count; ++joint) {
+		const JointTracks& tracks{clip.joints[joint]};
+		std::uint32_t next_key;
+
+		std::uint32_t& translation_key{keys_[3u * joint]};
+		translation_weights[joint] = seekTrack(clip.keys, tracks.translation, frame_position, translation_key, next_key);
+		const glm::vec3 from_translation{animation_quantization::dequantizeVector(
+			clip.keys[translation_key].values, tracks.translation_min, tracks.translation_step
+		)};
+		const glm::vec3 to_translation{animation_quantization::dequantizeVector(
+			clip.keys[next_key].values, tracks.translation_min, tracks.translation_step
+		)};
+
+		std::uint32_t& rotation_key{keys_[3u * joint + 1u]};
+		rotation_weights[joint] = seekTrack(clip.keys, tracks.rotation, frame_position, rotation_key, next_key);
+		const glm::vec4 from_rotation{animation_quantization::dequantizeRotation(clip.keys[rotation_key].values)};
+		const glm::vec4 to_rotation{animation_quantization::dequantizeRotation(clip.keys[next_key].values)};
+
+		std::uint32_t& scale_key{keys_[3u * joint + 2u]};
+		scale_weights[joint] = seekTrack(clip.keys, tracks.scale, frame_position, scale_key, next_key);
+		const glm::vec3 from_scale{animation_quantization::dequantizeVector(
+			clip.keys[scale_key].values, tracks.scale_min, tracks.scale_step
+		)};
+		const glm::vec3 to_scale{animation_quantization::dequantizeVector(
+			clip.keys[next_key].values, tracks.scale_min, tracks.scale_step
+		)};
+
+		from_keys_.setJointTransform(joint, {from_translation, from_rotation, from_scale});
+		to_keys_.setJointTransform(joint, {to_translation, to_rotation, to_scale});
+	}
+}
+
+const Pose& ClipCursor::getFromKeys() const {
+	return from_keys_;
+}
+
+const Pose& ClipCursor::getToKeys() const {
+	return to_keys_;
+}
+
+const float* ClipCursor::getTranslationWeights() const {
+	return weights_.data();
+}
+
+const float* ClipCursor::getRotationWeights() const {
+	return weights_.data() + from_keys_.getPaddedJointCount();
+}
+
+const float* ClipCursor::getScaleWeights() const {
+	return weights_.data() + 2u * from_keys_.getPaddedJointCount();
+}
+
+std::size_t ClipCursor::getMemorySize() const {
+	return keys_.capacity() * sizeof(std::uint32_t)
+		+ from_keys_.getMemorySize()
+		+ to_keys_.getMemorySize()
+		+ weights_.capacity() * sizeof(float);
+}
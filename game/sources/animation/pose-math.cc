@@ -0,0 +1,252 @@
+#include "game/headers/animation/pose-math.hh"
+
+#include "game/headers/utility/simd.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+
+namespace {
+
+	constexpr std::size_t TRANSLATION_CHANNELS[3]{
+		static_cast<std::size_t>(JointChannel::TranslationX),
+		static_cast<std::size_t>(JointChannel::TranslationY),
+		static_cast<std::size_t>(JointChannel::TranslationZ)
+	};
+	constexpr std::size_t SCALE_CHANNELS[3]{
+		static_cast<std::size_t>(JointChannel::ScaleX),
+		static_cast<std::size_t>(JointChannel::ScaleY),
+		static_cast<std::size_t>(JointChannel::ScaleZ)
+	};
+	constexpr std::size_t ROTATION_CHANNELS[4]{
+		static_cast<std::size_t>(JointChannel::RotationX),
+		static_cast<std::size_t>(JointChannel::RotationY),
+		static_cast<std::size_t>(JointChannel::RotationZ),
+		static_cast<std::size_t>(JointChannel::RotationW)
+	};
+
+	/**
+	 * Interpolates every channel of two sets of channel arrays, the result may alias either.
+	 * Rotations take the shorter way around, and are renormalized, which is close to a slerp
+	 * for the small angles between neighbouring frames, and blended poses.
+	 * Get weights stores the translation, rotation, and scale weights of the joints starting at the given one.
+	 */
+	template <typename GetWeights>
+	void interpolateChannels(
+		const float* const (&from)[JOINT_CHANNEL_COUNT],
+		const float* const (&to)[JOINT_CHANNEL_COUNT],
+		GetWeights get_weights,
+		float* const (&result)[JOINT_CHANNEL_COUNT],
+		std::size_t padded_joint_count
+	) {
+		for (std::size_t joint{0u}; joint < padded_joint_count; joint += simd::LANE_COUNT) {
+			simd::Floats translation_t;
+			simd::Floats rotation_t;
+			simd::Floats scale_t;
+			get_weights(joint, translation_t, rotation_t, scale_t);
+
+			for (std::size_t channel : TRANSLATION_CHANNELS) {
+				const simd::Floats a{simd::load(from[channel] + joint)};
+				const simd::Floats b{simd::load(to[channel] + joint)};
+				simd::store(result[channel] + joint, simd::add(a, simd::mul(simd::sub(b, a), translation_t)));
+			}
+			for (std::size_t channel : SCALE_CHANNELS) {
+				const simd::Floats a{simd::load(from[channel] + joint)};
+				const simd::Floats b{simd::load(to[channel] + joint)};
+				simd::store(result[channel] + joint, simd::add(a, simd::mul(simd::sub(b, a), scale_t)));
+			}
+
+			simd::Floats a[4];
+			simd::Floats b[4];
+			for (std::size_t i{0u}; i < 4u; ++i) {
+				a[i] = simd::load(from[ROTATION_CHANNELS[i]] + joint);
+				b[i] = simd::load(to[ROTATION_CHANNELS[i]] + joint);
+			}
+			const simd::Floats dot{
+				simd::add(simd::add(simd::mul(a[0], b[0]), simd::mul(a[1], b[1])), simd::add(simd::mul(a[2], b[2]), simd::mul(a[3], b[3])))
+			};
+			simd::Floats q[4];
+			for (std::size_t i{0u}; i < 4u; ++i) {
+				// Opposite quaternions are the same rotation, the one on the near hemisphere is interpolated towards
+				q[i] = simd::add(a[i], simd::mul(simd::sub(simd::flipSign(b[i], dot), a[i]), rotation_t));
+			}
+			const simd::Floats length{
+				simd::sqrt(simd::add(simd::add(simd::mul(q[0], q[0]), simd::mul(q[1], q[1])), simd::add(simd::mul(q[2], q[2]), simd::mul(q[3], q[3]))))
+			};
+			for (std::size_t i{0u}; i < 4u; ++i) {
+				simd::store(result[ROTATION_CHANNELS[i]] + joint, simd::div(q[i], length));
+			}
+		}
+	}
+
+	void getPoseChannels(const Pose& pose, const float* (&channels)[JOINT_CHANNEL_COUNT]) {
+		for (std::size_t channel{0u}; channel < JOINT_CHANNEL_COUNT; ++channel) {
+			channels[channel] = pose.getChannel(static_cast<JointChannel>(channel));
+		}
+	}
+
+	void getPoseChannels(Pose& pose, float* (&channels)[JOINT_CHANNEL_COUNT]) {
+		for (std::size_t channel{0u}; channel < JOINT_CHANNEL_COUNT; ++channel) {
+			channels[channel] = pose.getChannel(static_cast<JointChannel>(channel));
+		}
+	}
+
+	// Column major result of a times b, the result may alias either
+	void multiply(const glm::mat4& a, const glm::mat4& b, glm::mat4& result) {
+#if defined(__SSE2__)
+		const __m128 a_columns[4]{
+			_mm_loadu_ps(&a[0][0]), _mm_loadu_ps(&a[1][0]), _mm_loadu_ps(&a[2][0]), _mm_loadu_ps(&a[3][0])
+		};
+		for (int column{0}; column < 4; ++column) {
+			const __m128 b_column{_mm_loadu_ps(&b[column][0])};
+			const __m128 product{_mm_add_ps(
+				_mm_add_ps(
+					_mm_mul_ps(a_columns[0], _mm_shuffle_ps(b_column, b_column, _MM_SHUFFLE(0, 0, 0, 0))),
+					_mm_mul_ps(a_columns[1], _mm_shuffle_ps(b_column, b_column, _MM_SHUFFLE(1, 1, 1, 1)))
+				),
+				_mm_add_ps(
+					_mm_mul_ps(a_columns[2], _mm_shuffle_ps(b_column, b_column, _MM_SHUFFLE(2, 2, 2, 2))),
+					_mm_mul_ps(a_columns[3], _mm_shuffle_ps(b_column, b_column, _MM_SHUFFLE(3, 3, 3, 3)))
+				)
+			)};
+			_mm_storeu_ps(&result[column][0], product);
+		}
+#else
+		result = a * b;
+#endif
+	}
+
+} // namespace
+
+void pose_math::sampleClip(const CompressedAnimationClip& clip, float time, bool loop, ClipCursor& cursor, Pose& pose) {
+	if (pose.getJointCount() != clip.joint_count) {
+		throw std::invalid_argument("the pose does not match the clip's skeleton: " + clip.name);
+	}
+
+	// Finding the position between the clip's frames
+	float position{0.0f};
+	if (clip.duration > 0.0f) {
+		const float clip_time{loop ? time - clip.duration * std::floor(time / clip.duration) : std::clamp(time, 0.0f, clip.duration)};
+		position = std::min(clip_time * clip.sample_rate, static_cast<float>(clip.frame_count - 1u));
+	}
+
+	// Every track's keys around the position, each track with its own weight, as keys are at different frames
+	cursor.seek(clip, position);
+	const float* from[JOINT_CHANNEL_COUNT];
+	const float* to[JOINT_CHANNEL_COUNT];
+	float* result[JOINT_CHANNEL_COUNT];
+	getPoseChannels(cursor.getFromKeys(), from);
+	getPoseChannels(cursor.getToKeys(), to);
+	getPoseChannels(pose, result);
+	const float* const translation_weights{cursor.getTranslationWeights()};
+	const float* const rotation_weights{cursor.getRotationWeights()};
+	const float* const scale_weights{cursor.getScaleWeights()};
+	interpolateChannels(
+		from, to,
+		[=](std::size_t joint, simd::Floats& translation_t, simd::Floats& rotation_t, simd::Floats& scale_t) {
+			translation_t = simd::load(translation_weights + joint);
+			rotation_t = simd::load(rotation_weights + joint);
+			scale_t = simd::load(scale_weights + joint);
+		},
+		result, pose.getPaddedJointCount()
+	);
+}
+
+void pose_math::blendPoses(const Pose& from, const Pose& to, float weight, Pose& result) {
+	if (from.getJointCount() != result.getJointCount() || to.getJointCount() != result.getJointCount()) {
+		throw std::invalid_argument("cannot blend poses of different skeletons");
+	}
+
+	const float* from_channels[JOINT_CHANNEL_COUNT];
+	const float* to_channels[JOINT_CHANNEL_COUNT];
+	float* result_channels[JOINT_CHANNEL_COUNT];
+	getPoseChannels(from, from_channels);
+	getPoseChannels(to, to_channels);
+	getPoseChannels(result, result_channels);
+	const simd::Floats t{simd::broadcast(weight)};
+	interpolateChannels(
+		from_channels, to_channels,
+		[t](std::size_t, simd::Floats& translation_t, simd::Floats& rotation_t, simd::Floats& scale_t) {
+			translation_t = t;
+			rotation_t = t;
+			scale_t = t;
+		},
+		result_channels, result.getPaddedJointCount()
+	);
+}
+
+void pose_math::computeSkinningMatrices(
+	const Skeleton& skeleton,
+	const Pose& pose,
+	std::vector<glm::mat4>& joint_transforms,
+	std::vector<glm::mat4>& skinning_matrices
+) {
+	const std::size_t joint_count{skeleton.getJointCount()};
+	if (pose.getJointCount() != joint_count) {
+		throw std::invalid_argument("the pose does not match the skeleton");
+	}
+	joint_transforms.resize(joint_count);
+	skinning_matrices.resize(joint_count);
+
+	// Local matrices of several joints at once, the rotation, and scale part is computed channel by channel
+	const float* channels[JOINT_CHANNEL_COUNT];
+	getPoseChannels(pose, channels);
+	const simd::Floats one{simd::broadcast(1.0f)};
+	const simd::Floats two{simd::broadcast(2.0f)};
+	for (std::size_t first_joint{0u}; first_joint < joint_count; first_joint += simd::LANE_COUNT) {
+		const simd::Floats x{simd::load(channels[static_cast<std::size_t>(JointChannel::RotationX)] + first_joint)};
+		const simd::Floats y{simd::load(channels[static_cast<std::size_t>(JointChannel::RotationY)] + first_joint)};
+		const simd::Floats z{simd::load(channels[static_cast<std::size_t>(JointChannel::RotationZ)] + first_joint)};
+		const simd::Floats w{simd::load(channels[static_cast<std::size_t>(JointChannel::RotationW)] + first_joint)};
+		const simd::Floats scale_x{simd::load(channels[static_cast<std::size_t>(JointChannel::ScaleX)] + first_joint)};
+		const simd::Floats scale_y{simd::load(channels[static_cast<std::size_t>(JointChannel::ScaleY)] + first_joint)};
+		const simd::Floats scale_z{simd::load(channels[static_cast<std::size_t>(JointChannel::ScaleZ)] + first_joint)};
+
+		const simd::Floats xx{simd::mul(x, x)};
+		const simd::Floats yy{simd::mul(y, y)};
+		const simd::Floats zz{simd::mul(z, z)};
+		const simd::Floats xy{simd::mul(x, y)};
+		const simd::Floats xz{simd::mul(x, z)};
+		const simd::Floats yz{simd::mul(y, z)};
+		const simd::Floats xw{simd::mul(x, w)};
+		const simd::Floats yw{simd::mul(y, w)};
+		const simd::Floats zw{simd::mul(z, w)};
+
+		// Rotation, and scale part of every joint's matrix, column by column
+		float elements[9][simd::LANE_COUNT];
+		simd::store(elements[0], simd::mul(simd::sub(one, simd::mul(two, simd::add(yy, zz))), scale_x));
+		simd::store(elements[1], simd::mul(simd::mul(two, simd::add(xy, zw)), scale_x));
+		simd::store(elements[2], simd::mul(simd::mul(two, simd::sub(xz, yw)), scale_x));
+		simd::store(elements[3], simd::mul(simd::mul(two, simd::sub(xy, zw)), scale_y));
+		simd::store(elements[4], simd::mul(simd::sub(one, simd::mul(two, simd::add(xx, zz))), scale_y));
+		simd::store(elements[5], simd::mul(simd::mul(two, simd::add(yz, xw)), scale_y));
+		simd::store(elements[6], simd::mul(simd::mul(two, simd::add(xz, yw)), scale_z));
+		simd::store(elements[7], simd::mul(simd::mul(two, simd::sub(yz, xw)), scale_z));
+		simd::store(elements[8], simd::mul(simd::sub(one, simd::mul(two, simd::add(xx, yy))), scale_z));
+
+		const std::size_t last_joint{std::min(first_joint + simd::LANE_COUNT, joint_count)};
+		for (std::size_t joint{first_joint}; joint < last_joint; ++joint) {
+			const std::size_t lane{joint - first_joint};
+			glm::mat4& local{joint_transforms[joint]};
+			local[0] = glm::vec4(elements[0][lane], elements[1][lane], elements[2][lane], 0.0f);
+			local[1] = glm::vec4(elements[3][lane], elements[4][lane], elements[5][lane], 0.0f);
+			local[2] = glm::vec4(elements[6][lane], elements[7][lane], elements[8][lane], 0.0f);
+			local[3] = glm::vec4(
+				channels[static_cast<std::size_t>(JointChannel::TranslationX)][joint],
+				channels[static_cast<std::size_t>(JointChannel::TranslationY)][joint],
+				channels[static_cast<std::size_t>(JointChannel::TranslationZ)][joint],
+				1.0f
+			);
+		}
+	}
+
+	// Parents precede their children, so one pass moves every joint into the model's space
+	for (std::size_t joint{0u}; joint < joint_count; ++joint) {
+		const std::uint32_t parent{skeleton.parents[joint]};
+		if (parent != Skeleton::NO_JOINT) {
+			multiply(joint_transforms[parent], joint_transforms[joint], joint_transforms[joint]);
+		}
+		multiply(joint_transforms[joint], skeleton.inverse_binds[joint], skinning_matrices[joint]);
+	}
+}
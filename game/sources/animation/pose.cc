@@ -0,0 +1,74 @@
+#include "game/headers/animation/pose.hh"
+
+#include "game/headers/utility/simd.hh"
+
+static_assert(JOINT_LANES % simd::MAX_LANE_COUNT == 0u, "poses must be processed in whole SIMD vectors");
+
+Pose::Pose(std::size_t joint_count):
+		joint_count_{joint_count},
+		channels_(JOINT_CHANNEL_COUNT * ::getPaddedJointCount(joint_count), 0.0f) {
+	const JointTransform identity{glm::vec3(0.0f), glm::vec4(0.0f, 0.0f, 0.0f, 1.0f), glm::vec3(1.0f)};
+	for (std::size_t joint{0u}; joint < getPaddedJointCount(); ++joint) {
+		setJointTransform(joint, identity);
+	}
+}
+
+Pose::Pose(const Skeleton& skeleton): Pose(skeleton.getJointCount()) {
+	for (std::size_t joint{0u}; joint < joint_count_; ++joint) {
+		setJointTransform(joint, skeleton.bind_pose[joint]);
+	}
+}
+
+std::size_t Pose::getJointCount() const {
+	return joint_count_;
+}
+
+std::size_t Pose::getPaddedJointCount() const {
+	return ::getPaddedJointCount(joint_count_);
+}
+
+float* Pose::getChannel(JointChannel channel) {
+	return channels_.data() + static_cast<std::size_t>(channel) * getPaddedJointCount();
+}
+
+const float* Pose::getChannel(JointChannel channel) const {
+	return channels_.data() + static_cast<std::size_t>(channel) * getPaddedJointCount();
+}
+
+JointTransform Pose::getJointTransform(std::size_t joint) const {
+	return {
+		glm::vec3(
+			getChannel(JointChannel::TranslationX)[joint],
+			getChannel(JointChannel::TranslationY)[joint],
+			getChannel(JointChannel::TranslationZ)[joint]
+		),
+		glm::vec4(
+			getChannel(JointChannel::RotationX)[joint],
+			getChannel(JointChannel::RotationY)[joint],
+			getChannel(JointChannel::RotationZ)[joint],
+			getChannel(JointChannel::RotationW)[joint]
+		),
+		glm::vec3(
+			getChannel(JointChannel::ScaleX)[joint],
+			getChannel(JointChannel::ScaleY)[joint],
+			getChannel(JointChannel::ScaleZ)[joint]
+		)
+	};
+}
+
+void Pose::setJointTransform(std::size_t joint, const JointTransform& transform) {
+	getChannel(JointChannel::TranslationX)[joint] = transform.translation.x;
+	getChannel(JointChannel::TranslationY)[joint] = transform.translation.y;
+	getChannel(JointChannel::TranslationZ)[joint] = transform.translation.z;
+	getChannel(JointChannel::RotationX)[joint] = transform.rotation.x;
+	getChannel(JointChannel::RotationY)[joint] = transform.rotation.y;
+	getChannel(JointChannel::RotationZ)[joint] = transform.rotation.z;
+	getChannel(JointChannel::RotationW)[joint] = transform.rotation.w;
+	getChannel(JointChannel::ScaleX)[joint] = transform.scale.x;
+	getChannel(JointChannel::ScaleY)[joint] = transform.scale.y;
+	getChannel(JointChannel::ScaleZ)[joint] = transform.scale.z;
+}
+
+std::size_t Pose::getMemorySize() const {
+	return channels_.capacity() * sizeof(float);
+}
@@ -0,0 +1,60 @@
+#include "game/headers/animation/skinning.hh"
+
+#include "external/glm/glm/geometric.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+void skinning::skinVertices(
+	const Vertex* vertices,
+	const VertexSkin* skin,
+	std::size_t vertex_count,
+	const glm::mat4* skinning_matrices,
+	Vertex* skinned_vertices
+) {
+	for (std::size_t i{0u}; i < vertex_count; ++i) {
+		const Vertex& vertex{vertices[i]};
+		const VertexSkin& vertex_skin{skin[i]};
+		Vertex& skinned{skinned_vertices[i]};
+
+#if defined(__SSE2__)
+		// Blending the joint matrices a column at a time
+		__m128 columns[4]{_mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps()};
+		for (std::size_t j{0u}; j < 4u; ++j) {
+			const __m128 weight{_mm_set1_ps(vertex_skin.weights[j])};
+			const glm::mat4& matrix{skinning_matrices[vertex_skin.joints[j]]};
+			for (int column{0}; column < 4; ++column) {
+				columns[column] = _mm_add_ps(columns[column], _mm_mul_ps(weight, _mm_loadu_ps(&matrix[column][0])));
+			}
+		}
+
+		float position[4];
+		float normal[4];
+		_mm_storeu_ps(position, _mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(columns[0], _mm_set1_ps(vertex.position.x)), _mm_mul_ps(columns[1], _mm_set1_ps(vertex.position.y))),
+			_mm_add_ps(_mm_mul_ps(columns[2], _mm_set1_ps(vertex.position.z)), columns[3])
+		));
+		_mm_storeu_ps(normal, _mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(columns[0], _mm_set1_ps(vertex.normal.x)), _mm_mul_ps(columns[1], _mm_set1_ps(vertex.normal.y))),
+			_mm_mul_ps(columns[2], _mm_set1_ps(vertex.normal.z))
+		));
+		skinned.position = glm::vec3(position[0], position[1], position[2]);
+		skinned.normal = glm::vec3(normal[0], normal[1], normal[2]);
+#else
+		glm::mat4 matrix(0.0f);
+		for (std::size_t j{0u}; j < 4u; ++j) {
+			matrix += skinning_matrices[vertex_skin.joints[j]] * vertex_skin.weights[j];
+		}
+		skinned.position = glm::vec3(matrix * glm::vec4(vertex.position, 1.0f));
+		skinned.normal = glm::vec3(matrix * glm::vec4(vertex.normal, 0.0f));
+#endif
+
+		// Scaled joints stretch normals, zero normals stay as they are
+		const float normal_length{glm::length(skinned.normal)};
+		if (normal_length > 0.0f) {
+			skinned.normal /= normal_length;
+		}
+		skinned.tex_coords = vertex.tex_coords;
+	}
+}
@@ -3,7 +3,12 @@
 
 BitmapFontRenderer::BitmapFontRenderer(const BitmapFont& font, const Shader& bitmap_shader,
 		float screen_width_height):
-	_font{font}, _bitmap_shader{bitmap_shader}, _screen_width_height{screen_width_height} {
+	_font{font}, _bitmap_shader{bitmap_shader},
+	_color_uniform{bitmap_shader.getUniform<glm::vec3>("color")},
+	_tex_uniform{bitmap_shader.getUniform<int>("tex")},
+	_pos_matrix_uniform{bitmap_shader.getUniform<glm::mat3>("pos_matrix")},
+	_tex_matrix_uniform{bitmap_shader.getUniform<glm::mat3>("tex_matrix")},
+	_screen_width_height{screen_width_height} {
 	
 	glGenVertexArrays(1, &_vao);
 	glGenBuffers(1, &_vbo);
@@ -31,8 +36,8 @@ void BitmapFontRenderer::draw(std::string_view text, float scale,
 		glm::vec2 position, glm::vec3 color) const {
 
 	_bitmap_shader.use();
-	_bitmap_shader.setVec3("color", color);
-	_bitmap_shader.setInt("tex", 0);
+	_bitmap_shader.set(_color_uniform, color);
+	_bitmap_shader.set(_tex_uniform, 0);
 	glActiveTexture(GL_TEXTURE0);
 	glBindTexture(GL_TEXTURE_2D, _font.getTextureId());
 	glBindVertexArray(_vao);
@@ -56,14 +61,14 @@ void BitmapFontRenderer::draw(std::string_view text, float scale,
 			0.0f, cell_h, 0.0f,
 			position.x + offset_x, position.y, 1.0f
 		);
-		_bitmap_shader.setMat3("pos_matrix", pos_matrix);
+		_bitmap_shader.set(_pos_matrix_uniform, pos_matrix);
 		// Update the texture matrix uniform
 		glm::mat3 tex_matrix(
 			tex_w, 0.0f, 0.0f,
 			0.0f, tex_h, 0.0f,
 			tex_x, tex_y, 1.0f
 		);
-		_bitmap_shader.setMat3("tex_matrix", tex_matrix);
+		_bitmap_shader.set(_tex_matrix_uniform, tex_matrix);
 		glDrawArrays(GL_TRIANGLES, 0, 6);
 
 		offset_x += (_font.getWidthHeight() * scale / _screen_width_height);
@@ -4,8 +4,12 @@
 #include "external/glad/glad.h"
 
 #include "game/headers/debug-help.hh"
+#include "game/headers/renderer/opengl/opengl-baked-texture.hh"
+#include "game/headers/service-locator.hh"
+#include "game/headers/texture/baked-texture.hh"
 
 #include <iostream>
+#include <stdexcept>
 
 BitmapFont::BitmapFont(const std::string& bitmap_path, int rows, int columns,
 		int first_ascii_sym, float width_height):
@@ -16,10 +20,46 @@ BitmapFont::BitmapFont(const std::string& bitmap_path, int rows, int columns,
 	int image_width, image_height, color_channels;
 	unsigned char* data;
 
+	const VirtualFileSystem& file_system{ServiceLocator::getInstance().getFileSystem()};
+
+	// Prefer the baked, block compressed font. Only BC4 holds the luminance the shader reads from red,
+	// other formats would hand it the red channel of a colored font
+	if (BakedTexture::isAvailable(file_system, bitmap_path)) {
+		try {
+			const BakedTexture baked_texture{file_system, BakedTexture::getBakedPath(bitmap_path)};
+			if (baked_texture.getFormat() != BakedTextureFormat::BC4) {
+				std::cout << "Error: The baked font texture is not BC4, bake it with --format bc4! Path to the font: "
+					<< bitmap_path << std::endl;
+			} else {
+				glGenTextures(1, &_texture_id);
+				glBindTexture(GL_TEXTURE_2D, _texture_id);
+				if (upload_baked_texture(baked_texture)) {
+					glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+					glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+					glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+					glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+					return;
+				}
+				glDeleteTextures(1, &_texture_id);
+				_texture_id = 0;
+			}
+		} catch (const std::runtime_error& e) {
+			std::cout << "Error: The baked font texture cannot be loaded! " << e.what() << std::endl;
+		}
+	}
+
 	// Load grayscale font
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 	constexpr int PER_PIXEL_COMP{1};
-	data = stbi_load(bitmap_path.c_str(), &image_width, &image_height, &color_channels, PER_PIXEL_COMP);
+	data = NULL;
+	try {
+		const AssetFile file{file_system.open(bitmap_path)};
+		data = stbi_load_from_memory(
+			file.data(), static_cast<int>(file.size()), &image_width, &image_height, &color_channels, PER_PIXEL_COMP
+		);
+	} catch (const std::runtime_error& e) {
+		std::cout << "Error: " << e.what() << std::endl;
+	}
 	if (data != NULL) {
 		glGenTextures(1, &_texture_id);
 		glBindTexture(GL_TEXTURE_2D, _texture_id);
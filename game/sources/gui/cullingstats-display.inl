@@ -0,0 +1,21 @@
+#include "game/headers/gui/cullingstats-display.hh"
+
+CullingStatsDisplay::CullingStatsDisplay(
+	FontRenderer& font_renderer, const ModelRenderer& model_renderer, glm::vec2 pos, float font_size):
+	font_renderer_{font_renderer}, model_renderer_{model_renderer}, pos_{pos}, font_size_{font_size} {
+
+}
+
+void CullingStatsDisplay::draw() const {
+	constexpr glm::vec3 FONT_COLOR{0.6f, 1.0f, 0.6f};
+	font_renderer_.draw(formatStats(), font_size_, pos_, FONT_COLOR);
+}
+
+// Visible out of tested instances, and submeshes of static batches
+std::string CullingStatsDisplay::formatStats() const {
+	const CullingStats stats{model_renderer_.getCullingStats()};
+	return "Visible instances: " + std::to_string(stats.visible_instance_count) + "/"
+		+ std::to_string(stats.instance_count) + ", submeshes: "
+		+ std::to_string(stats.visible_submesh_count) + "/"
+		+ std::to_string(stats.submesh_count);
+}
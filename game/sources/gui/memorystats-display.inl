@@ -0,0 +1,46 @@
+#include "game/headers/gui/memorystats-display.hh"
+
+#include <cstdio>
+
+/**
+ * The position argument specifies the bottom left corner of the memory stats display.
+ */
+MemoryStatsDisplay::MemoryStatsDisplay(
+	FontRenderer& font_renderer, const MemoryTracker& memory_tracker, glm::vec2 pos, float font_size):
+	font_renderer_{font_renderer}, memory_tracker_{memory_tracker}, pos_{pos}, font_size_{font_size} {
+
+}
+
+void MemoryStatsDisplay::draw() const {
+	constexpr glm::vec3 FONT_COLOR{1.0f, 1.0f, 0.2f};
+
+	const MemoryUsage usage{memory_tracker_.getUsage()};
+	font_renderer_.draw(
+		"CPU [MiB]: " + formatUsage(usage, MemoryDomain::Cpu), font_size_, pos_ + glm::vec2{0.0f, font_size_}, FONT_COLOR
+	);
+	font_renderer_.draw("GPU [MiB]: " + formatUsage(usage, MemoryDomain::Gpu), font_size_, pos_, FONT_COLOR);
+}
+
+// The total, followed by every category in use
+std::string MemoryStatsDisplay::formatUsage(const MemoryUsage& usage, MemoryDomain domain) {
+	constexpr double BYTES_PER_MIB{1024.0 * 1024.0};
+	char buffer[32];
+
+	std::snprintf(buffer, sizeof(buffer), "%.1f", usage.getTotal(domain) / BYTES_PER_MIB);
+	std::string text{buffer};
+
+	std::string categories;
+	for (std::size_t i{0u}; i < MEMORY_CATEGORY_COUNT; ++i) {
+		const MemoryCategory category{static_cast<MemoryCategory>(i)};
+		const std::size_t bytes{usage.get(domain, category)};
+		if (bytes == 0u) {
+			continue;
+		}
+		std::snprintf(buffer, sizeof(buffer), " %.1f", bytes / BYTES_PER_MIB);
+		categories += (categories.empty() ? "" : ",") + std::string(" ") + getMemoryCategoryName(category) + buffer;
+	}
+	if (!categories.empty()) {
+		text += " (" + categories.substr(1u) + ")";
+	}
+	return text;
+}
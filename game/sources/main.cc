@@ -15,9 +15,16 @@
 #include "game/headers/renderer/screen.hh"
 #include "game/headers/renderer/camera.hh"
 #include "game/headers/renderer/model-renderer.hh"
+#include "game/headers/renderer/renderer-settings.hh"
 
 #include "game/headers/model/model.hh"
 #include "game/headers/model/model-loader.hh"
+#include "game/headers/model/scene-generator.hh"
+
+#include "game/headers/animation/animation-system.hh"
+
+#include "game/headers/world/world-manifest.hh"
+#include "game/headers/world/world-streamer.hh"
 
 #include "game/headers/gui/bitmap-font.hh"
 #include "game/headers/gui/bitmap-font-renderer.hh"
@@ -25,12 +32,17 @@
 #include "game/headers/gui/scene.hh"
 #include "game/headers/gui/framestats-display.hh"
 #include "game/headers/gui/camerastats-display.hh"
+#include "game/headers/gui/memorystats-display.hh"
+#include "game/headers/gui/cullingstats-display.hh"
 
 #include "game/headers/input/keyboard-handler.hh"
 #include "game/headers/input/mouse-handler.hh"
 #include "game/headers/input/key.hh"
 
 // System classes
+#include <exception>
+#include <filesystem>
+#include <stdexcept>
 #include <string>
 #include <memory>
 
@@ -51,7 +63,22 @@ KeyboardHandler keyboard_handler;
 MouseHandler mouse_handler;
 std::unique_ptr<Logger> logger{ServiceLocator::getInstance().getLogger()};
 
-int main() {
+/**
+ * Usage: thegame [<scene.obj>]
+ * A scene written by scene-gen is drawn once per entry of its instance list, next to the world.
+ */
+int main(int argc, char* argv[]) {
+	// Packed assets shadow the loose files, which remain usable during development
+	const std::string asset_archive_path{"game.pak"};
+	if (std::filesystem::exists(asset_archive_path)) {
+		try {
+			ServiceLocator::getInstance().getFileSystem().mount(asset_archive_path);
+		} catch (const std::runtime_error& e) {
+			logger->Error(e.what());
+			return -1;
+		}
+	}
+
 	// Setting up GLFW
 	glfwSetErrorCallback(error_callback);
 
@@ -147,14 +174,48 @@ int main() {
 	FrameStatsDisplay<512> frame_stats_display(bitmap_font_renderer, frame_stats, {-1.0f, 0.85f}, 0.05f);
 	GUI.add(&frame_stats_display);
 
+	MemoryStatsDisplay memory_stats_display(
+		bitmap_font_renderer, ServiceLocator::getInstance().getMemoryTracker(), {-1.0f, 0.75f}, 0.05f
+	);
+	GUI.add(&memory_stats_display);
+
 	CameraStatsDisplay camera_stats_display(bitmap_font_renderer, camera, {-1.0f, 0.95f}, 0.05f);
 	GUI.add(&camera_stats_display);
 
 	// Setting up a model loader, and a model renderer
 	std::unique_ptr<ModelRenderer> model_renderer{ServiceLocator::getInstance().getModelRenderer()};
-	model_renderer->init(screen, &camera);
+	RendererSettings renderer_settings;
+	renderer_settings.upload_budget_ms = 2.0;
+	model_renderer->init(screen, &camera, renderer_settings);
+
+	CullingStatsDisplay culling_stats_display(bitmap_font_renderer, *model_renderer, {-1.0f, 0.7f}, 0.05f);
+	GUI.add(&culling_stats_display);
+
 	std::unique_ptr<ModelLoader> model_loader{ServiceLocator::getInstance().getModelLoader()};
-	model_renderer->addModel(model_loader->loadModel("game/terrains/plane-cube/plane-cube.obj"));
+	// Poses the instances of skinned models before every draw
+	AnimationSystem animation_system{*model_renderer};
+
+	// Streaming the terrain's chunks around the camera
+	WorldStreamerSettings world_streamer_settings;
+	world_streamer_settings.validate_gpu_memory = true;
+	WorldStreamer world_streamer{
+		WorldManifest::load("game/terrains/plane-cube/plane-cube.world"),
+		*model_loader,
+		*model_renderer,
+		world_streamer_settings
+	};
+
+	if (argc > 1) {
+		const std::string scene_path{argv[1]};
+		try {
+			const std::shared_ptr<Model> scene{model_loader->loadModel(scene_path)};
+			for (const glm::mat4& instance : scene_generator::loadInstances(scene_generator::getInstancesPath(scene_path))) {
+				model_renderer->addInstance(scene, instance);
+			}
+		} catch (const std::exception& e) {
+			logger->Error("cannot load a generated scene: " + scene_path + ": " + e.what());
+		}
+	}
 
 	// Setting up inputs
 	keyboard_handler.registerKeyHandler(Input::Key::W, [&](Input::Action action, Input::Modifier modifier) {
@@ -306,6 +367,9 @@ int main() {
 		}
 
 		// Terrain, and models
+		world_streamer.update(camera);
+		animation_system.update(static_cast<float>(last_frame_duration), camera.pos);
+		model_renderer->update();
 		model_renderer->draw();
 
 		// Controls
@@ -0,0 +1,376 @@
+#include "game/headers/model/animation-compressor.hh"
+
+#include "external/glm/glm/geometric.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+	// Key frames are stored in 16 bits
+	constexpr std::size_t MAX_FRAME_COUNT{65536u};
+	// Tolerances grow by the factor while the clip stays within the maximum error, at most this many times
+	constexpr float RELAXATION_FACTOR{1.5f};
+	constexpr std::size_t MAX_RELAXATIONS{8u};
+
+	JointTransform getFrameTransform(const AnimationClip& clip, std::size_t frame, std::size_t joint) {
+		return {
+			glm::vec3(
+				clip.getChannel(frame, JointChannel::TranslationX)[joint],
+				clip.getChannel(frame, JointChannel::TranslationY)[joint],
+				clip.getChannel(frame, JointChannel::TranslationZ)[joint]
+			),
+			glm::vec4(
+				clip.getChannel(frame, JointChannel::RotationX)[joint],
+				clip.getChannel(frame, JointChannel::RotationY)[joint],
+				clip.getChannel(frame, JointChannel::RotationZ)[joint],
+				clip.getChannel(frame, JointChannel::RotationW)[joint]
+			),
+			glm::vec3(
+				clip.getChannel(frame, JointChannel::ScaleX)[joint],
+				clip.getChannel(frame, JointChannel::ScaleY)[joint],
+				clip.getChannel(frame, JointChannel::ScaleZ)[joint]
+			)
+		};
+	}
+
+	// Parents precede their children, so one pass moves every joint into the model's space
+	void toModelSpace(const Skeleton& skeleton, std::vector<glm::mat4>& transforms) {
+		for (std::size_t joint{0u}; joint < transforms.size(); ++joint) {
+			const std::uint32_t parent{skeleton.parents[joint]};
+			if (parent != Skeleton::NO_JOINT) {
+				transforms[joint] = transforms[parent] * transforms[joint];
+			}
+		}
+	}
+
+	/**
+	 * Distance each joint's tracks may move its shell. The maximum error is split evenly over the
+	 * longest chain of joints through the joint, as every joint of a chain moves the chain's end.
+	 */
+	std::vector<float> getJointTolerances(const Skeleton& skeleton, float max_error) {
+		const std::size_t joint_count{skeleton.getJointCount()};
+		std::vector<std::size_t> depths(joint_count, 1u);
+		std::vector<std::size_t> heights(joint_count, 1u);
+		for (std::size_t joint{0u}; joint < joint_count; ++joint) {
+			const std::uint32_t parent{skeleton.parents[joint]};
+			if (parent != Skeleton::NO_JOINT) {
+				depths[joint] = depths[parent] + 1u;
+			}
+		}
+		for (std::size_t joint{joint_count}; joint-- > 0u;) {
+			const std::uint32_t parent{skeleton.parents[joint]};
+			if (parent != Skeleton::NO_JOINT) {
+				heights[parent] = std::max(heights[parent], heights[joint] + 1u);
+			}
+		}
+
+		std::vector<float> tolerances(joint_count);
+		for (std::size_t joint{0u}; joint < joint_count; ++joint) {
+			tolerances[joint] = max_error / static_cast<float>(depths[joint] + heights[joint] - 1u);
+		}
+		return tolerances;
+	}
+
+	/**
+	 * How far each joint's rotation, and scale move points: the distance to its furthest descendant
+	 * in the bind pose, plus the shell distance around that descendant.
+	 */
+	std::vector<float> getJointReaches(const Skeleton& skeleton, float shell_distance) {
+		const std::size_t joint_count{skeleton.getJointCount()};
+		std::vector<glm::mat4> binds(joint_count);
+		for (std::size_t joint{0u}; joint < joint_count; ++joint) {
+			binds[joint] = skeleton.bind_pose[joint].toMatrix();
+		}
+		toModelSpace(skeleton, binds);
+
+		std::vector<float> reaches(joint_count, shell_distance);
+		for (std::size_t joint{joint_count}; joint-- > 0u;) {
+			const std::uint32_t parent{skeleton.parents[joint]};
+			if (parent != Skeleton::NO_JOINT) {
+				const float offset{glm::length(glm::vec3(binds[joint][3]) - glm::vec3(binds[parent][3]))};
+				reaches[parent] = std::max(reaches[parent], offset + reaches[joint]);
+			}
+		}
+		return reaches;
+	}
+
+	/**
+	 * Frames of the keys to keep, the first, and the last frame always among them, unless every frame
+	 * is close enough to the first. Greedily extends each key's segment for as long as linearly
+	 * interpolating its decoded ends reproduces every frame in between within the tolerance.
+	 */
+	template <typename Value, typename Interpolate, typename Distance>
+	std::vector<std::size_t> reduceKeys(
+		const std::vector<Value>& samples,
+		const std::vector<Value>& decoded,
+		float tolerance,
+		Interpolate interpolate,
+		Distance distance
+	) {
+		const std::size_t frame_count{samples.size()};
+		bool is_constant{true};
+		for (std::size_t frame{0u}; frame < frame_count && is_constant; ++frame) {
+			is_constant = distance(decoded[0], samples[frame]) <= tolerance;
+		}
+		if (is_constant) {
+			return {0u};
+		}
+
+		const auto fits{[&](std::size_t from, std::size_t to) {
+			for (std::size_t frame{from}; frame <= to; ++frame) {
+				const float weight{static_cast<float>(frame - from) / static_cast<float>(to - from)};
+				if (distance(interpolate(decoded[from], decoded[to], weight), samples[frame]) > tolerance) {
+					return false;
+				}
+			}
+			return true;
+		}};
+
+		std::vector<std::size_t> frames{0u};
+		std::size_t from{0u};
+		while (from + 1u < frame_count) {
+			std::size_t to{from + 1u};
+			while (to + 1u < frame_count && fits(from, to + 1u)) {
+				++to;
+			}
+			frames.push_back(to);
+			from = to;
+		}
+		return frames;
+	}
+
+	AnimationTrack appendKeys(
+		const std::vector<std::size_t>& frames,
+		const std::vector<AnimationKey>& quantized,
+		std::vector<AnimationKey>& keys
+	) {
+		const AnimationTrack track{static_cast<std::uint32_t>(keys.size()), static_cast<std::uint32_t>(frames.size())};
+		for (std::size_t frame : frames) {
+			keys.push_back(quantized[frame]);
+		}
+		return track;
+	}
+
+	template <typename Distance>
+	AnimationTrack compressVectorTrack(
+		const std::vector<glm::vec3>& samples,
+		float tolerance,
+		Distance distance,
+		glm::vec3& min,
+		glm::vec3& step,
+		std::vector<AnimationKey>& keys
+	) {
+		min = samples[0];
+		glm::vec3 max{samples[0]};
+		for (const glm::vec3& sample : samples) {
+			min = glm::min(min, sample);
+			max = glm::max(max, sample);
+		}
+		step = animation_quantization::getQuantizationStep(min, max);
+
+		std::vector<AnimationKey> quantized(samples.size());
+		std::vector<glm::vec3> decoded(samples.size());
+		for (std::size_t frame{0u}; frame < samples.size(); ++frame) {
+			quantized[frame].frame = static_cast<std::uint16_t>(frame);
+			animation_quantization::quantizeVector(samples[frame], min, step, quantized[frame].values);
+			decoded[frame] = animation_quantization::dequantizeVector(quantized[frame].values, min, step);
+		}
+
+		const std::vector<std::size_t> frames{reduceKeys(
+			samples,
+			decoded,
+			tolerance,
+			[](const glm::vec3& from, const glm::vec3& to, float weight) {
+				return glm::mix(from, to, weight);
+			},
+			distance
+		)};
+		return appendKeys(frames, quantized, keys);
+	}
+
+	// Rotations move the shell along an arc of the joint's reach
+	AnimationTrack compressRotationTrack(
+		const std::vector<glm::vec4>& samples,
+		float tolerance,
+		float reach,
+		std::vector<AnimationKey>& keys
+	) {
+		std::vector<AnimationKey> quantized(samples.size());
+		std::vector<glm::vec4> decoded(samples.size());
+		for (std::size_t frame{0u}; frame < samples.size(); ++frame) {
+			quantized[frame].frame = static_cast<std::uint16_t>(frame);
+			animation_quantization::quantizeRotation(samples[frame], quantized[frame].values);
+			decoded[frame] = animation_quantization::dequantizeRotation(quantized[frame].values);
+		}
+
+		const std::vector<std::size_t> frames{reduceKeys(
+			samples,
+			decoded,
+			tolerance,
+			[](const glm::vec4& from, glm::vec4 to, float weight) {
+				if (glm::dot(from, to) < 0.0f) {
+					to = -to;
+				}
+				return glm::normalize(glm::mix(from, to, weight));
+			},
+			[reach](const glm::vec4& a, glm::vec4 b) {
+				if (glm::dot(a, b) < 0.0f) {
+					b = -b;
+				}
+				// The rotation angle between them, accurate for small angles unlike an arc cosine
+				const float angle{4.0f * std::atan2(glm::length(a - b), glm::length(a + b))};
+				return angle * reach;
+			}
+		)};
+		return appendKeys(frames, quantized, keys);
+	}
+
+	// Replaces the clip's keys
+	void compressTracks(
+		const AnimationClip& clip,
+		const std::vector<float>& tolerances,
+		const std::vector<float>& reaches,
+		CompressedAnimationClip& compressed
+	) {
+		std::vector<glm::vec3> translations(clip.frame_count);
+		std::vector<glm::vec4> rotations(clip.frame_count);
+		std::vector<glm::vec3> scales(clip.frame_count);
+		compressed.keys.clear();
+		for (std::size_t joint{0u}; joint < compressed.joints.size(); ++joint) {
+			for (std::size_t frame{0u}; frame < clip.frame_count; ++frame) {
+				const JointTransform transform{getFrameTransform(clip, frame, joint)};
+				translations[frame] = transform.translation;
+				rotations[frame] = transform.rotation;
+				scales[frame] = transform.scale;
+			}
+
+			JointTracks& tracks{compressed.joints[joint]};
+			const float reach{reaches[joint]};
+			// Translations move the shell as much as they change, scales as much as the joint reaches
+			tracks.translation = compressVectorTrack(
+				translations,
+				tolerances[joint],
+				[](const glm::vec3& a, const glm::vec3& b) {
+					return glm::length(a - b);
+				},
+				tracks.translation_min,
+				tracks.translation_step,
+				compressed.keys
+			);
+			tracks.rotation = compressRotationTrack(rotations, tolerances[joint], reach, compressed.keys);
+			tracks.scale = compressVectorTrack(
+				scales,
+				tolerances[joint],
+				[reach](const glm::vec3& a, const glm::vec3& b) {
+					const glm::vec3 difference{glm::abs(a - b)};
+					return std::max({difference.x, difference.y, difference.z}) * reach;
+				},
+				tracks.scale_min,
+				tracks.scale_step,
+				compressed.keys
+			);
+		}
+		compressed.keys.shrink_to_fit();
+	}
+
+} // namespace
+
+float AnimationCompressionReport::getRatio() const {
+	return compressed_bytes > 0u ? static_cast<float>(raw_bytes) / static_cast<float>(compressed_bytes) : 0.0f;
+}
+
+CompressedAnimationClip animation_compressor::compress(
+	const AnimationClip& clip,
+	const Skeleton& skeleton,
+	const AnimationCompressionSettings& settings,
+	AnimationCompressionReport& report
+) {
+	const std::size_t joint_count{skeleton.getJointCount()};
+	if (clip.joint_count != joint_count) {
+		throw std::invalid_argument("the clip does not match the skeleton: " + clip.name);
+	}
+	if (clip.frame_count == 0u || clip.frame_count > MAX_FRAME_COUNT) {
+		throw std::invalid_argument("cannot compress a clip of " + std::to_string(clip.frame_count) + " frames: " + clip.name);
+	}
+
+	CompressedAnimationClip compressed;
+	compressed.name = clip.name;
+	compressed.duration = clip.duration;
+	compressed.sample_rate = clip.sample_rate;
+	compressed.frame_count = clip.frame_count;
+	compressed.joint_count = clip.joint_count;
+	compressed.joints.resize(joint_count);
+
+	const std::vector<float> reaches{getJointReaches(skeleton, settings.shell_distance)};
+	std::vector<float> tolerances{getJointTolerances(skeleton, settings.max_error)};
+	compressTracks(clip, tolerances, reaches, compressed);
+	float error{measureError(clip, compressed, skeleton, settings.shell_distance)};
+	// Errors along a chain rarely add up in the same direction, so the tolerances are relaxed
+	// for as long as the measured error stays within the maximum
+	for (std::size_t relaxation{0u}; relaxation < MAX_RELAXATIONS; ++relaxation) {
+		for (float& tolerance : tolerances) {
+			tolerance *= RELAXATION_FACTOR;
+		}
+		CompressedAnimationClip relaxed{compressed};
+		compressTracks(clip, tolerances, reaches, relaxed);
+		const float relaxed_error{measureError(clip, relaxed, skeleton, settings.shell_distance)};
+		if (relaxed_error > settings.max_error) {
+			break;
+		}
+		compressed = std::move(relaxed);
+		error = relaxed_error;
+	}
+
+	report.clip = clip.name;
+	report.raw_bytes = clip.name.size() + clip.samples.size() * sizeof(float);
+	report.compressed_bytes = compressed.name.size()
+		+ compressed.joints.size() * sizeof(JointTracks)
+		+ compressed.keys.size() * sizeof(AnimationKey);
+	report.frame_count = joint_count * 3u * clip.frame_count;
+	report.key_count = compressed.keys.size();
+	report.max_error = error;
+	return compressed;
+}
+
+float animation_compressor::measureError(
+	const AnimationClip& clip,
+	const CompressedAnimationClip& compressed,
+	const Skeleton& skeleton,
+	float shell_distance
+) {
+	const std::size_t joint_count{skeleton.getJointCount()};
+	if (clip.joint_count != joint_count || compressed.joint_count != joint_count || compressed.frame_count != clip.frame_count) {
+		throw std::invalid_argument("the clips do not match: " + clip.name);
+	}
+
+	// The joint, and points at the shell distance along its axes
+	const glm::vec4 shell_points[4]{
+		glm::vec4(0.0f, 0.0f, 0.0f, 1.0f),
+		glm::vec4(shell_distance, 0.0f, 0.0f, 1.0f),
+		glm::vec4(0.0f, shell_distance, 0.0f, 1.0f),
+		glm::vec4(0.0f, 0.0f, shell_distance, 1.0f)
+	};
+
+	float max_error{0.0f};
+	std::vector<glm::mat4> raw_transforms(joint_count);
+	std::vector<glm::mat4> compressed_transforms(joint_count);
+	for (std::size_t frame{0u}; frame < clip.frame_count; ++frame) {
+		for (std::size_t joint{0u}; joint < joint_count; ++joint) {
+			raw_transforms[joint] = getFrameTransform(clip, frame, joint).toMatrix();
+			compressed_transforms[joint] = compressed.getJointTransform(joint, static_cast<float>(frame)).toMatrix();
+		}
+		toModelSpace(skeleton, raw_transforms);
+		toModelSpace(skeleton, compressed_transforms);
+
+		for (std::size_t joint{0u}; joint < joint_count; ++joint) {
+			for (const glm::vec4& point : shell_points) {
+				const glm::vec3 difference{raw_transforms[joint] * point - compressed_transforms[joint] * point};
+				max_error = std::max(max_error, glm::length(difference));
+			}
+		}
+	}
+	return max_error;
+}
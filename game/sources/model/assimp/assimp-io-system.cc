@@ -0,0 +1,81 @@
+#include "game/headers/model/assimp/assimp-io-system.hh"
+
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+AssimpAssetStream::AssimpAssetStream(AssetFile file): file_{std::move(file)} {
+}
+
+std::size_t AssimpAssetStream::Read(void* buffer, std::size_t size, std::size_t count) {
+	if (size == 0u) {
+		return 0u;
+	}
+	// Like fread(), only whole elements are read
+	const std::size_t available{(file_.size() - position_) / size};
+	const std::size_t read_count{count < available ? count : available};
+	std::memcpy(buffer, file_.data() + position_, read_count * size);
+	position_ += read_count * size;
+	return read_count;
+}
+
+std::size_t AssimpAssetStream::Write(const void*, std::size_t, std::size_t) {
+	return 0u;
+}
+
+aiReturn AssimpAssetStream::Seek(std::size_t offset, aiOrigin origin) {
+	std::size_t position;
+	if (origin == aiOrigin_SET) {
+		position = offset;
+	} else if (origin == aiOrigin_CUR) {
+		position = position_ + offset;
+	} else if (origin == aiOrigin_END) {
+		// Assimp passes negative offsets from the end as wrapped around unsigned values
+		position = file_.size() + offset;
+	} else {
+		return aiReturn_FAILURE;
+	}
+	if (position > file_.size()) {
+		return aiReturn_FAILURE;
+	}
+	position_ = position;
+	return aiReturn_SUCCESS;
+}
+
+std::size_t AssimpAssetStream::Tell() const {
+	return position_;
+}
+
+std::size_t AssimpAssetStream::FileSize() const {
+	return file_.size();
+}
+
+void AssimpAssetStream::Flush() {
+}
+
+AssimpIOSystem::AssimpIOSystem(const VirtualFileSystem& file_system): file_system_{file_system} {
+}
+
+bool AssimpIOSystem::Exists(const char* path) const {
+	return file_system_.exists(path);
+}
+
+char AssimpIOSystem::getOsSeparator() const {
+	return '/';
+}
+
+Assimp::IOStream* AssimpIOSystem::Open(const char* path, const char* mode) {
+	if (std::strchr(mode, 'w') != nullptr || std::strchr(mode, 'a') != nullptr) {
+		return nullptr;
+	}
+	try {
+		return new AssimpAssetStream(file_system_.open(path));
+	} catch (const std::runtime_error&) {
+		// Assimp reports missing files itself
+		return nullptr;
+	}
+}
+
+void AssimpIOSystem::Close(Assimp::IOStream* stream) {
+	delete stream;
+}
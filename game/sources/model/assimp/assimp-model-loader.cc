@@ -5,24 +5,192 @@
 #include "external/assimp/include/assimp/postprocess.h"
 
 #include "game/headers/debug-help.hh"
+#include "game/headers/model/assimp/assimp-io-system.hh"
 #include "game/headers/math-aux.hh"
+#include "game/headers/model/vertex-deduplicator.hh"
+#include "game/headers/model/mesh-cache.hh"
+#include "game/headers/service-locator.hh"
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace {
+
+	// Clips are resampled at this rate, poses between two frames are interpolated
+	constexpr float ANIMATION_SAMPLE_RATE{30.0f};
+	// Assimp leaves the rate unset for some formats
+	constexpr double DEFAULT_TICKS_PER_SECOND{25.0};
+
+	// Assimp's matrices are row-major, glm's are column-major
+	glm::mat4 to_glm_matrix(const aiMatrix4x4& m) {
+		return glm::mat4(
+			m.a1, m.b1, m.c1, m.d1,
+			m.a2, m.b2, m.c2, m.d2,
+			m.a3, m.b3, m.c3, m.d3,
+			m.a4, m.b4, m.c4, m.d4
+		);
+	}
+
+	// Assimp's quaternions are stored w first
+	glm::vec4 to_glm_quaternion(const aiQuaternion& q) {
+		return glm::vec4(q.x, q.y, q.z, q.w);
+	}
+
+	glm::vec4 slerp(const glm::vec4& from, glm::vec4 to, float t) {
+		float cosine{glm::dot(from, to)};
+		// Taking the shorter way around
+		if (cosine < 0.0f) {
+			to = -to;
+			cosine = -cosine;
+		}
+		if (cosine > 0.9995f) {
+			return glm::normalize(from + (to - from) * t);
+		}
+		const float angle{std::acos(cosine)};
+		return (from * std::sin((1.0f - t) * angle) + to * std::sin(t * angle)) / std::sin(angle);
+	}
+
+	// Index of the last key at, or before the time, and the factor towards the key after it
+	template <typename Key>
+	std::pair<unsigned int, float> locateKey(const Key* keys, unsigned int key_count, double time) {
+		const Key* next{std::upper_bound(keys, keys + key_count, time, [](double time, const Key& key) {
+			return time < key.mTime;
+		})};
+		if (next == keys) {
+			return {0u, 0.0f};
+		}
+		if (next == keys + key_count) {
+			return {key_count - 1u, 0.0f};
+		}
+		const unsigned int index{static_cast<unsigned int>(next - keys - 1)};
+		const double span{next->mTime - keys[index].mTime};
+		return {index, span > 0.0 ? static_cast<float>((time - keys[index].mTime) / span) : 0.0f};
+	}
+
+	glm::vec3 sampleVectorKeys(const aiVectorKey* keys, unsigned int key_count, double time) {
+		const auto [index, t]{locateKey(keys, key_count, time)};
+		const aiVector3D& from{keys[index].mValue};
+		const aiVector3D& to{keys[std::min(index + 1u, key_count - 1u)].mValue};
+		return glm::mix(glm::vec3(from.x, from.y, from.z), glm::vec3(to.x, to.y, to.z), t);
+	}
+
+	glm::vec4 sampleQuaternionKeys(const aiQuatKey* keys, unsigned int key_count, double time) {
+		const auto [index, t]{locateKey(keys, key_count, time)};
+		return slerp(
+			to_glm_quaternion(keys[index].mValue),
+			to_glm_quaternion(keys[std::min(index + 1u, key_count - 1u)].mValue),
+			t
+		);
+	}
+
+	void setJointTransform(AnimationClip& clip, std::size_t frame, std::size_t joint, const JointTransform& transform) {
+		const float values[JOINT_CHANNEL_COUNT]{
+			transform.translation.x, transform.translation.y, transform.translation.z,
+			transform.rotation.x, transform.rotation.y, transform.rotation.z, transform.rotation.w,
+			transform.scale.x, transform.scale.y, transform.scale.z
+		};
+		for (std::size_t channel{0u}; channel < JOINT_CHANNEL_COUNT; ++channel) {
+			clip.getChannel(frame, static_cast<JointChannel>(channel))[joint] = values[channel];
+		}
+	}
+
+	const aiNode* findNode(const aiNode* node, const std::string& name) {
+		if (name == node->mName.C_Str()) {
+			return node;
+		}
+		for (unsigned int i{0u}; i < node->mNumChildren; ++i) {
+			if (const aiNode* found{findNode(node->mChildren[i], name)}) {
+				return found;
+			}
+		}
+		return nullptr;
+	}
+
+	// Adds the node, and its descendants which are joints, depth-first, so every parent precedes its children
+	void addJoints(
+		const aiNode* node,
+		std::uint32_t parent,
+		const std::unordered_set<const aiNode*>& joint_nodes,
+		const std::unordered_map<std::string, glm::mat4>& bone_offsets,
+		std::vector<glm::mat4>& bind_transforms,
+		Skeleton& skeleton
+	) {
+		const std::uint32_t joint{static_cast<std::uint32_t>(skeleton.getJointCount())};
+		const glm::mat4 local{to_glm_matrix(node->mTransformation)};
+		bind_transforms.push_back(parent == Skeleton::NO_JOINT ? local : bind_transforms[parent] * local);
+
+		skeleton.joint_names.push_back(node->mName.C_Str());
+		skeleton.parents.push_back(parent);
+		skeleton.bind_pose.push_back(JointTransform::fromMatrix(local));
+		// Ancestors without a bone skin no vertices, their inverse bind matrix only completes the set
+		const auto offset{bone_offsets.find(skeleton.joint_names.back())};
+		skeleton.inverse_binds.push_back(
+			offset != bone_offsets.end() ? offset->second : glm::inverse(bind_transforms.back())
+		);
+
+		for (unsigned int i{0u}; i < node->mNumChildren; ++i) {
+			if (joint_nodes.count(node->mChildren[i]) != 0u) {
+				addJoints(node->mChildren[i], joint, joint_nodes, bone_offsets, bind_transforms, skeleton);
+			}
+		}
+	}
+
+} // namespace
+
+AssimpModelLoader::AssimpModelLoader(bool use_mesh_cache, const AnimationCompressionSettings& animation_compression):
+	use_mesh_cache_{use_mesh_cache}, animation_compression_{animation_compression} {
+}
 
 std::shared_ptr<Model> AssimpModelLoader::loadModel(const std::string& path) {
+	// Skip the importer if the model was already processed
+	if (use_mesh_cache_) {
+		std::shared_ptr<Model> cached_model{mesh_cache::load(path)};
+		if (cached_model) {
+			return cached_model;
+		}
+	}
+
+	// The importer owns the scene, so every load has its own importer
+	Assimp::Importer importer;
+	// The importer takes ownership of the IO system
+	importer.SetIOHandler(new AssimpIOSystem(ServiceLocator::getInstance().getFileSystem()));
 	const aiScene* scene{
-		_importer.ReadFile(
+		importer.ReadFile(
 			path,
 			aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_GenNormals
 		)
 	};
 	if (scene == nullptr || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || scene->mRootNode == nullptr) {
-		throw std::runtime_error(std::string("cannot load model file: ") + std::string(_importer.GetErrorString()));
+		throw std::runtime_error(std::string("cannot load model file: ") + std::string(importer.GetErrorString()));
 	}
 
+	// Every skinned mesh refers to the same skeleton's joints
+	Skeleton skeleton{processSkeleton(scene)};
+
+	// Convert the scene's meshes in parallel, each into its own slot, so the order stays the same
+	std::vector<std::shared_ptr<Mesh>> scene_meshes(scene->mNumMeshes);
+	std::vector<MeshOptimizationReport> reports(scene->mNumMeshes);
+	ServiceLocator::getInstance().getThreadPool().parallelFor(
+		scene->mNumMeshes,
+		[this, scene, &skeleton, &scene_meshes, &reports](std::size_t i) {
+			scene_meshes[i] = processMesh(scene->mMeshes[i], scene, skeleton, reports[i]);
+		}
+	);
+	logOptimizationReports(path, reports);
+
 	// Process root node
 	std::vector<std::shared_ptr<Mesh>> meshes;
-	processNode(meshes, scene->mRootNode, scene);
+	std::vector<std::uint32_t> mesh_nodes;
+	TransformHierarchy transforms;
+	processNode(meshes, mesh_nodes, transforms, scene_meshes, scene->mRootNode, TransformHierarchy::NO_PARENT);
 
 	// Process lights
 	std::vector<Light> lights;
@@ -30,40 +198,95 @@ std::shared_ptr<Model> AssimpModelLoader::loadModel(const std::string& path) {
 		processLights(scene, lights);
 	}
 
-	return std::make_shared<Model>(std::move(meshes), std::move(lights));
+	// Process animations, and compress every clip in parallel
+	const std::vector<AnimationClip> clips{processAnimations(scene, skeleton)};
+	std::vector<CompressedAnimationClip> animations(clips.size());
+	std::vector<AnimationCompressionReport> compression_reports(clips.size());
+	ServiceLocator::getInstance().getThreadPool().parallelFor(
+		clips.size(),
+		[this, &clips, &skeleton, &animations, &compression_reports](std::size_t i) {
+			animations[i] = animation_compressor::compress(clips[i], skeleton, animation_compression_, compression_reports[i]);
+		}
+	);
+	logCompressionReports(path, compression_reports);
+
+	std::shared_ptr<Model> model{
+		std::make_shared<Model>(
+			std::move(meshes),
+			std::move(mesh_nodes),
+			std::move(transforms),
+			std::move(lights),
+			std::move(skeleton),
+			std::move(animations)
+		)
+	};
+
+	if (use_mesh_cache_) {
+		try {
+			mesh_cache::store(path, *model);
+		} catch (const std::exception& e) {
+			ServiceLocator::getInstance().getLogger()->Warning(std::string("cannot cache a model: ") + e.what());
+		}
+	}
+
+	return model;
 }
 
-void AssimpModelLoader::processNode(std::vector<std::shared_ptr<Mesh>>& meshes, aiNode* node, const aiScene* ai_scene) {
-	// Process meshes
+void AssimpModelLoader::processNode(
+	std::vector<std::shared_ptr<Mesh>>& meshes,
+	std::vector<std::uint32_t>& mesh_nodes,
+	TransformHierarchy& transforms,
+	const std::vector<std::shared_ptr<Mesh>>& scene_meshes,
+	const aiNode* node,
+	std::uint32_t parent
+) {
+	// Nodes are added in depth-first order, so every parent precedes its children
+	const std::uint32_t node_index{transforms.addNode(parent, to_glm_matrix(node->mTransformation))};
+
+	// Collect the node's already processed meshes
 	for (unsigned int i{0u}; i < node->mNumMeshes; i++) {
 		const unsigned int mesh_index{node->mMeshes[i]};
-		const aiMesh* ai_mesh{ai_scene->mMeshes[mesh_index]};
-		
-		meshes.push_back(processMesh(ai_mesh, ai_scene));
+		meshes.push_back(scene_meshes[mesh_index]);
+		mesh_nodes.push_back(node_index);
 	}
 
 	// Process children nodes
 	for (unsigned int i{0u}; i < node->mNumChildren; i++) {
-		processNode(meshes, node->mChildren[i], ai_scene);
+		processNode(meshes, mesh_nodes, transforms, scene_meshes, node->mChildren[i], node_index);
 	}
 }
 
-std::shared_ptr<Mesh> AssimpModelLoader::processMesh(const aiMesh* mesh, const aiScene* scene) {
+std::shared_ptr<Mesh> AssimpModelLoader::processMesh(
+	const aiMesh* mesh,
+	const aiScene* scene,
+	const Skeleton& skeleton,
+	MeshOptimizationReport& report
+) const {
 	if (!mesh->HasPositions()) {
 		throw std::runtime_error("the mesh has no vertex positions");
 	}
 
-	// Setting up triangles
-	std::vector<Triangle> triangles;
+	// Setting up unique vertices, and triangle indices, a merged vertex keeps the skin of its first occurrence
+	const std::vector<VertexSkin> vertex_skins{processSkin(mesh, skeleton)};
+	std::vector<VertexSkin> skin;
+	VertexDeduplicator deduplicator{mesh->mNumVertices};
+	std::vector<std::uint32_t> indices;
+	indices.reserve(3u * mesh->mNumFaces);
 	for (unsigned int i{0u}; i < mesh->mNumFaces; i++) {
-		const aiFace triangle{mesh->mFaces[i]};
+		const aiFace& triangle{mesh->mFaces[i]};
 
 		if (triangle.mNumIndices != 3) {
 			// Face is not a triangle, skipping it
 			continue;
 		}
 
-		triangles.push_back(processTriangle(&triangle, mesh));
+		for (unsigned int j{0u}; j < 3u; j++) {
+			const std::uint32_t index{deduplicator.add(processVertex(mesh, triangle.mIndices[j]))};
+			if (!vertex_skins.empty() && index == skin.size()) {
+				skin.push_back(vertex_skins[triangle.mIndices[j]]);
+			}
+			indices.push_back(index);
+		}
 	}
 
 	// Setting up a material
@@ -71,38 +294,95 @@ std::shared_ptr<Mesh> AssimpModelLoader::processMesh(const aiMesh* mesh, const a
 	Material material{};
 	std::vector<Texture> textures;
 	processMaterial(ai_mat, material, textures);
-	
-	return std::make_shared<Mesh>(std::move(triangles), std::move(textures), material);
+
+	return buildMesh(
+		deduplicator.takeVertices(),
+		std::move(indices),
+		std::move(textures),
+		std::move(skin),
+		material,
+		report
+	);
 }
 
-Triangle AssimpModelLoader::processTriangle(const aiFace* ai_triangle, const aiMesh* ai_mesh) {
-	Triangle triangle;
-	for (int i{0}; i < 3; i++) {
-		const int vertex_index{static_cast<int>(ai_triangle->mIndices[i])};
+Vertex AssimpModelLoader::processVertex(const aiMesh* ai_mesh, unsigned int vertex_index) const {
+	Vertex vertex{};
 
-		// Position
-		const aiVector3D vertex_vector{ai_mesh->mVertices[vertex_index]};
-		triangle.vertices[i].position = {vertex_vector.x, vertex_vector.y, vertex_vector.z};
+	// Position
+	const aiVector3D vertex_vector{ai_mesh->mVertices[vertex_index]};
+	vertex.position = {vertex_vector.x, vertex_vector.y, vertex_vector.z};
 
-		// Normal
-		if (ai_mesh->HasNormals()) {
-			const aiVector3D ai_normal{ai_mesh->mNormals[vertex_index]};
+	// Normal
+	if (ai_mesh->HasNormals()) {
+		const aiVector3D ai_normal{ai_mesh->mNormals[vertex_index]};
 
-			triangle.vertices[i].normal = {ai_normal.x, ai_normal.y, ai_normal.z};
-		}
-		
-		// Texture
-		if (ai_mesh->HasTextureCoords(0)) {
-			const aiVector3D ai_tex_coords{ai_mesh->mTextureCoords[0][vertex_index]};
+		vertex.normal = {ai_normal.x, ai_normal.y, ai_normal.z};
+	}
+
+	// Texture
+	if (ai_mesh->HasTextureCoords(0)) {
+		const aiVector3D ai_tex_coords{ai_mesh->mTextureCoords[0][vertex_index]};
+
+		vertex.tex_coords = {ai_tex_coords.x, ai_tex_coords.y};
+	}
+
+	return vertex;
+}
+
+std::vector<VertexSkin> AssimpModelLoader::processSkin(const aiMesh* ai_mesh, const Skeleton& skeleton) const {
+	std::vector<VertexSkin> skin;
+	if (!ai_mesh->HasBones()) {
+		return skin;
+	}
+	skin.assign(ai_mesh->mNumVertices, VertexSkin{});
+
+	for (unsigned int i{0u}; i < ai_mesh->mNumBones; ++i) {
+		const aiBone* bone{ai_mesh->mBones[i]};
+		const std::uint16_t joint{static_cast<std::uint16_t>(skeleton.findJoint(bone->mName.C_Str()))};
+		for (unsigned int j{0u}; j < bone->mNumWeights; ++j) {
+			const aiVertexWeight& weight{bone->mWeights[j]};
+			if (weight.mVertexId >= ai_mesh->mNumVertices || weight.mWeight <= 0.0f) {
+				continue;
+			}
 
-			triangle.vertices[i].tex_coords = {ai_tex_coords.x, ai_tex_coords.y};
+			// Keeping the four strongest influences of every vertex
+			VertexSkin& vertex_skin{skin[weight.mVertexId]};
+			std::size_t weakest{0u};
+			for (std::size_t k{1u}; k < 4u; ++k) {
+				if (vertex_skin.weights[k] < vertex_skin.weights[weakest]) {
+					weakest = k;
+				}
+			}
+			if (weight.mWeight > vertex_skin.weights[weakest]) {
+				vertex_skin.joints[weakest] = joint;
+				vertex_skin.weights[weakest] = weight.mWeight;
+			}
 		}
 	}
 
-	return triangle;
+	std::size_t unweighted_count{0u};
+	for (VertexSkin& vertex_skin : skin) {
+		const float weight_sum{vertex_skin.weights[0] + vertex_skin.weights[1] + vertex_skin.weights[2] + vertex_skin.weights[3]};
+		if (weight_sum <= 0.0f) {
+			// Follows the root joint, rather than collapsing into the origin
+			vertex_skin.joints[0] = 0u;
+			vertex_skin.weights[0] = 1.0f;
+			++unweighted_count;
+			continue;
+		}
+		for (float& weight : vertex_skin.weights) {
+			weight /= weight_sum;
+		}
+	}
+	if (unweighted_count > 0u) {
+		ServiceLocator::getInstance().getLogger()->Warning(
+			std::to_string(unweighted_count) + " vertices of a skinned mesh have no bone weights, they follow the root joint"
+		);
+	}
+	return skin;
 }
 
-void AssimpModelLoader::processMaterial(const aiMaterial* ai_mat, Material& material, std::vector<Texture>& textures) {
+void AssimpModelLoader::processMaterial(const aiMaterial* ai_mat, Material& material, std::vector<Texture>& textures) const {
 	// Setting a material's colors
 	aiColor3D ai_color(0.0f, 0.0f, 0.0f);
 
@@ -145,7 +425,7 @@ std::vector<Texture> AssimpModelLoader::loadMaterialTextures(
 	const aiMaterial* mat,
 	const aiTextureType type,
 	const std::string& type_name
-) {
+) const {
 	std::vector<Texture> textures;
 	for (unsigned int i{0u}; i < mat->GetTextureCount(type); i++) {
 		aiString path;
@@ -194,3 +474,104 @@ void AssimpModelLoader::processLights(const aiScene* scene, std::vector<Light>&
 		lights.push_back(my_light);
 	}
 }
+
+Skeleton AssimpModelLoader::processSkeleton(const aiScene* scene) const {
+	// The offset matrix of every bone, meshes sharing a bone normally agree on it
+	std::unordered_map<std::string, glm::mat4> bone_offsets;
+	for (unsigned int i{0u}; i < scene->mNumMeshes; ++i) {
+		const aiMesh* mesh{scene->mMeshes[i]};
+		for (unsigned int j{0u}; j < mesh->mNumBones; ++j) {
+			const aiBone* bone{mesh->mBones[j]};
+			const glm::mat4 offset{to_glm_matrix(bone->mOffsetMatrix)};
+			const auto [it, inserted]{bone_offsets.emplace(bone->mName.C_Str(), offset)};
+			if (!inserted && it->second != offset) {
+				ServiceLocator::getInstance().getLogger()->Warning(
+					"meshes disagree on a bone's bind pose, the first one is used: " + it->first
+				);
+			}
+		}
+	}
+	if (bone_offsets.empty()) {
+		return {};
+	}
+
+	// Marking the bones' nodes, and their ancestors up to the root
+	std::unordered_set<const aiNode*> joint_nodes;
+	for (const auto& [name, offset] : bone_offsets) {
+		const aiNode* node{findNode(scene->mRootNode, name)};
+		if (node == nullptr) {
+			throw std::runtime_error("a bone has no node: " + name);
+		}
+		for (; node != nullptr && joint_nodes.insert(node).second; node = node->mParent) {
+		}
+	}
+	if (joint_nodes.size() > std::numeric_limits<std::uint16_t>::max() + 1u) {
+		throw std::runtime_error("the skeleton has too many joints");
+	}
+
+	Skeleton skeleton;
+	std::vector<glm::mat4> bind_transforms;
+	addJoints(scene->mRootNode, Skeleton::NO_JOINT, joint_nodes, bone_offsets, bind_transforms, skeleton);
+	return skeleton;
+}
+
+std::vector<AnimationClip> AssimpModelLoader::processAnimations(const aiScene* scene, const Skeleton& skeleton) const {
+	std::vector<AnimationClip> clips;
+	if (skeleton.isEmpty()) {
+		if (scene->mNumAnimations > 0u) {
+			ServiceLocator::getInstance().getLogger()->Warning("animations of a model without bones are not imported");
+		}
+		return clips;
+	}
+
+	const std::size_t joint_count{skeleton.getJointCount()};
+	const std::size_t padded_joint_count{getPaddedJointCount(joint_count)};
+	const JointTransform identity{glm::vec3(0.0f), glm::vec4(0.0f, 0.0f, 0.0f, 1.0f), glm::vec3(1.0f)};
+	for (unsigned int i{0u}; i < scene->mNumAnimations; ++i) {
+		const aiAnimation* animation{scene->mAnimations[i]};
+		const double ticks_per_second{animation->mTicksPerSecond > 0.0 ? animation->mTicksPerSecond : DEFAULT_TICKS_PER_SECOND};
+
+		AnimationClip clip;
+		clip.name = animation->mName.length > 0u ? animation->mName.C_Str() : "animation-" + std::to_string(i);
+		clip.duration = static_cast<float>(std::max(animation->mDuration, 0.0) / ticks_per_second);
+		clip.frame_count = static_cast<std::uint32_t>(std::ceil(clip.duration * ANIMATION_SAMPLE_RATE)) + 1u;
+		// Adjusted, so the last frame falls on the clip's end
+		clip.sample_rate = clip.frame_count > 1u ? static_cast<float>(clip.frame_count - 1u) / clip.duration : 0.0f;
+		clip.joint_count = static_cast<std::uint32_t>(joint_count);
+		clip.samples.resize(clip.frame_count * JOINT_CHANNEL_COUNT * padded_joint_count);
+
+		// Joints without a channel keep their bind pose, padding joints are identities
+		for (std::size_t frame{0u}; frame < clip.frame_count; ++frame) {
+			for (std::size_t joint{0u}; joint < padded_joint_count; ++joint) {
+				setJointTransform(clip, frame, joint, joint < joint_count ? skeleton.bind_pose[joint] : identity);
+			}
+		}
+
+		for (unsigned int j{0u}; j < animation->mNumChannels; ++j) {
+			const aiNodeAnim* channel{animation->mChannels[j]};
+			const std::uint32_t joint{skeleton.findJoint(channel->mNodeName.C_Str())};
+			if (joint == Skeleton::NO_JOINT) {
+				continue;
+			}
+
+			for (std::size_t frame{0u}; frame < clip.frame_count; ++frame) {
+				const double time{
+					clip.sample_rate > 0.0f ? static_cast<double>(frame) / clip.sample_rate * ticks_per_second : 0.0
+				};
+				JointTransform transform{skeleton.bind_pose[joint]};
+				if (channel->mNumPositionKeys > 0u) {
+					transform.translation = sampleVectorKeys(channel->mPositionKeys, channel->mNumPositionKeys, time);
+				}
+				if (channel->mNumRotationKeys > 0u) {
+					transform.rotation = sampleQuaternionKeys(channel->mRotationKeys, channel->mNumRotationKeys, time);
+				}
+				if (channel->mNumScalingKeys > 0u) {
+					transform.scale = sampleVectorKeys(channel->mScalingKeys, channel->mNumScalingKeys, time);
+				}
+				setJointTransform(clip, frame, joint, transform);
+			}
+		}
+		clips.push_back(std::move(clip));
+	}
+	return clips;
+}
@@ -0,0 +1,146 @@
+#include "game/headers/model/compressed-animation.hh"
+
+#include "external/glm/glm/geometric.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+	// Components other than a unit quaternion's largest are within plus, or minus this
+	constexpr float SMALLEST_COMPONENT_LIMIT{0.70710678f};
+	constexpr std::uint16_t ROTATION_COMPONENT_MASK{0x7fffu};
+	constexpr float ROTATION_COMPONENT_STEPS{32767.0f};
+	constexpr float VECTOR_COMPONENT_STEPS{65535.0f};
+
+	// Keys around a position, and the weight of the later one
+	struct KeyPair {
+		const AnimationKey* from;
+		const AnimationKey* to;
+		float weight;
+	};
+
+	KeyPair findKeys(const std::vector<AnimationKey>& keys, const AnimationTrack& track, float frame_position) {
+		const AnimationKey* first{keys.data() + track.first_key};
+		const AnimationKey* end{first + track.key_count};
+		const AnimationKey* next{
+			std::upper_bound(first, end, frame_position, [](float position, const AnimationKey& key) {
+				return position < static_cast<float>(key.frame);
+			})
+		};
+		if (next == first) {
+			return {first, first, 0.0f};
+		}
+		const AnimationKey* previous{next - 1};
+		if (next == end) {
+			return {previous, previous, 0.0f};
+		}
+		const float weight{
+			(frame_position - static_cast<float>(previous->frame)) / static_cast<float>(next->frame - previous->frame)
+		};
+		return {previous, next, weight};
+	}
+
+	glm::vec3 sampleVectorTrack(
+		const std::vector<AnimationKey>& keys,
+		const AnimationTrack& track,
+		const glm::vec3& min,
+		const glm::vec3& step,
+		float frame_position
+	) {
+		const KeyPair pair{findKeys(keys, track, frame_position)};
+		const glm::vec3 from{animation_quantization::dequantizeVector(pair.from->values, min, step)};
+		if (pair.from == pair.to) {
+			return from;
+		}
+		return glm::mix(from, animation_quantization::dequantizeVector(pair.to->values, min, step), pair.weight);
+	}
+
+	// Normalized linear interpolation, the same as between the frames of uncompressed poses
+	glm::vec4 sampleRotationTrack(const std::vector<AnimationKey>& keys, const AnimationTrack& track, float frame_position) {
+		const KeyPair pair{findKeys(keys, track, frame_position)};
+		const glm::vec4 from{animation_quantization::dequantizeRotation(pair.from->values)};
+		if (pair.from == pair.to) {
+			return from;
+		}
+		glm::vec4 to{animation_quantization::dequantizeRotation(pair.to->values)};
+		if (glm::dot(from, to) < 0.0f) {
+			to = -to;
+		}
+		return glm::normalize(glm::mix(from, to, pair.weight));
+	}
+
+} // namespace
+
+JointTransform CompressedAnimationClip::getJointTransform(std::size_t joint, float frame_position) const {
+	const JointTracks& tracks{joints[joint]};
+	return {
+		sampleVectorTrack(keys, tracks.translation, tracks.translation_min, tracks.translation_step, frame_position),
+		sampleRotationTrack(keys, tracks.rotation, frame_position),
+		sampleVectorTrack(keys, tracks.scale, tracks.scale_min, tracks.scale_step, frame_position)
+	};
+}
+
+std::size_t CompressedAnimationClip::getMemorySize() const {
+	return name.capacity() + joints.capacity() * sizeof(JointTracks) + keys.capacity() * sizeof(AnimationKey);
+}
+
+void animation_quantization::quantizeRotation(const glm::vec4& rotation, std::uint16_t (&values)[3]) {
+	int largest{0};
+	for (int i{1}; i < 4; ++i) {
+		if (std::fabs(rotation[i]) > std::fabs(rotation[largest])) {
+			largest = i;
+		}
+	}
+	// q, and -q are the same rotation, the one with a positive largest component is stored
+	const glm::vec4 canonical{rotation[largest] < 0.0f ? -rotation : rotation};
+
+	int value{0};
+	for (int i{0}; i < 4; ++i) {
+		if (i == largest) {
+			continue;
+		}
+		const float normalized{std::clamp(canonical[i] / SMALLEST_COMPONENT_LIMIT * 0.5f + 0.5f, 0.0f, 1.0f)};
+		values[value++] = static_cast<std::uint16_t>(std::lround(normalized * ROTATION_COMPONENT_STEPS));
+	}
+	values[0] = static_cast<std::uint16_t>(values[0] | ((largest >> 1) << 15));
+	values[1] = static_cast<std::uint16_t>(values[1] | ((largest & 1) << 15));
+}
+
+glm::vec4 animation_quantization::dequantizeRotation(const std::uint16_t (&values)[3]) {
+	const int largest{((values[0] >> 15) << 1) | (values[1] >> 15)};
+
+	glm::vec4 rotation;
+	float sum_of_squares{0.0f};
+	int value{0};
+	for (int i{0}; i < 4; ++i) {
+		if (i == largest) {
+			continue;
+		}
+		const float normalized{static_cast<float>(values[value++] & ROTATION_COMPONENT_MASK) / ROTATION_COMPONENT_STEPS};
+		rotation[i] = (normalized * 2.0f - 1.0f) * SMALLEST_COMPONENT_LIMIT;
+		sum_of_squares += rotation[i] * rotation[i];
+	}
+	rotation[largest] = std::sqrt(std::max(1.0f - sum_of_squares, 0.0f));
+	return glm::normalize(rotation);
+}
+
+glm::vec3 animation_quantization::getQuantizationStep(const glm::vec3& min, const glm::vec3& max) {
+	return (max - min) / VECTOR_COMPONENT_STEPS;
+}
+
+void animation_quantization::quantizeVector(
+	const glm::vec3& value,
+	const glm::vec3& min,
+	const glm::vec3& step,
+	std::uint16_t (&values)[3]
+) {
+	for (int i{0}; i < 3; ++i) {
+		const float steps{step[i] > 0.0f ? (value[i] - min[i]) / step[i] : 0.0f};
+		values[i] = static_cast<std::uint16_t>(std::clamp(std::lround(steps), 0l, static_cast<long>(VECTOR_COMPONENT_STEPS)));
+	}
+}
+
+glm::vec3 animation_quantization::dequantizeVector(const std::uint16_t (&values)[3], const glm::vec3& min, const glm::vec3& step) {
+	return min + glm::vec3(values[0], values[1], values[2]) * step;
+}
@@ -0,0 +1,348 @@
+#include "game/headers/model/mesh-cache.hh"
+
+#include "game/headers/service-locator.hh"
+#include "game/headers/utility/binary-stream.hh"
+#include "game/headers/utility/hash.hh"
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+	constexpr char CACHE_MAGIC[8]{'F', 'P', 'S', 'M', 'E', 'S', 'H', '\0'};
+	// Increase whenever the layout, or the processing of cached meshes changes
+	constexpr std::uint32_t CACHE_VERSION{6u};
+	constexpr const char* CACHE_EXTENSION{".meshcache"};
+
+	struct SourceKey {
+		std::int64_t modification_time;
+		std::uint64_t size;
+	};
+
+	// Sources, and caches may be packed into an archive, or loose files
+	const VirtualFileSystem& getFileSystem() {
+		return ServiceLocator::getInstance().getFileSystem();
+	}
+
+	SourceKey getSourceKey(const std::string& source_path) {
+		AssetStatus status;
+		if (!getFileSystem().stat(source_path, status)) {
+			throw std::runtime_error("cannot find a model's source file: " + source_path);
+		}
+		return {status.modification_time, status.size};
+	}
+
+	std::uint64_t hashSourceFile(const std::string& source_path) {
+		const AssetFile source{getFileSystem().open(source_path)};
+		return hash_aux::fnv1a(source.data(), source.size());
+	}
+
+	/**
+	 * Writes to a temporary file first, so a reader never sees a partially written cache.
+	 * The temporary file is unique per thread, as the same model may be loaded concurrently.
+	 */
+	void writeCacheFile(const std::string& cache_path, const std::vector<unsigned char>& buffer) {
+		const std::string temporary_path{
+			cache_path + ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()))
+		};
+		{
+			std::ofstream file{temporary_path, std::ios::binary | std::ios::trunc};
+			if (!file) {
+				throw std::runtime_error("cannot create a mesh cache file: " + temporary_path);
+			}
+			file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+			if (!file) {
+				throw std::runtime_error("cannot write a mesh cache file: " + temporary_path);
+			}
+		}
+		fs::rename(temporary_path, cache_path);
+	}
+
+	// Rewrites the cache with the source's current key, caches packed into an archive are left as they are
+	void refreshSourceKey(
+		const std::string& cache_path,
+		const AssetFile& cache,
+		std::size_t key_offset,
+		const SourceKey& source_key
+	) {
+		std::error_code error;
+		if (!fs::is_regular_file(cache_path, error)) {
+			return;
+		}
+		std::vector<unsigned char> buffer(cache.data(), cache.data() + cache.size());
+		std::memcpy(buffer.data() + key_offset, &source_key, sizeof(SourceKey));
+		writeCacheFile(cache_path, buffer);
+	}
+
+	void writeMesh(BinaryWriter& writer, const Mesh& mesh) {
+		writer.write(mesh.material_);
+
+		writer.write(static_cast<std::uint32_t>(mesh.textures_.size()));
+		for (const Texture& texture : mesh.textures_) {
+			writer.writeString(texture.type);
+			writer.writeString(texture.path);
+		}
+
+		writer.align(sizeof(std::uint64_t));
+		writer.writeVector(mesh.vertices_);
+		writer.align(sizeof(std::uint64_t));
+		writer.writeVector(mesh.indices_);
+		writer.align(sizeof(std::uint64_t));
+		writer.writeVector(mesh.skin_);
+
+		writer.write(static_cast<std::uint32_t>(mesh.lods_.size()));
+		for (const MeshLod& lod : mesh.lods_) {
+			writer.write(lod.error);
+			writer.align(sizeof(std::uint64_t));
+			writer.writeVector(lod.indices);
+		}
+	}
+
+	std::shared_ptr<Mesh> readMesh(BinaryReader& reader) {
+		const Material material{reader.read<Material>()};
+
+		const std::uint32_t texture_count{reader.read<std::uint32_t>()};
+		std::vector<Texture> textures;
+		textures.reserve(texture_count);
+		for (std::uint32_t i{0u}; i < texture_count; ++i) {
+			std::string type{reader.readString()};
+			std::string path{reader.readString()};
+			textures.push_back({std::move(type), std::move(path)});
+		}
+
+		reader.align(sizeof(std::uint64_t));
+		std::vector<Vertex> vertices{reader.readVector<Vertex>()};
+		reader.align(sizeof(std::uint64_t));
+		std::vector<std::uint32_t> indices{reader.readVector<std::uint32_t>()};
+		reader.align(sizeof(std::uint64_t));
+		std::vector<VertexSkin> skin{reader.readVector<VertexSkin>()};
+
+		const std::uint32_t lod_count{reader.read<std::uint32_t>()};
+		std::vector<MeshLod> lods;
+		lods.reserve(lod_count);
+		for (std::uint32_t i{0u}; i < lod_count; ++i) {
+			const float error{reader.read<float>()};
+			reader.align(sizeof(std::uint64_t));
+			lods.push_back({reader.readVector<std::uint32_t>(), error});
+		}
+
+		return std::make_shared<Mesh>(
+			std::move(vertices),
+			std::move(indices),
+			std::move(textures),
+			material,
+			std::move(lods),
+			std::move(skin)
+		);
+	}
+
+	void writeSkeleton(BinaryWriter& writer, const Skeleton& skeleton) {
+		writer.write(static_cast<std::uint32_t>(skeleton.joint_names.size()));
+		for (const std::string& name : skeleton.joint_names) {
+			writer.writeString(name);
+		}
+		writer.align(sizeof(std::uint64_t));
+		writer.writeVector(skeleton.parents);
+		writer.align(sizeof(std::uint64_t));
+		writer.writeVector(skeleton.bind_pose);
+		writer.align(sizeof(std::uint64_t));
+		writer.writeVector(skeleton.inverse_binds);
+	}
+
+	Skeleton readSkeleton(BinaryReader& reader) {
+		Skeleton skeleton;
+		const std::uint32_t joint_count{reader.read<std::uint32_t>()};
+		skeleton.joint_names.reserve(joint_count);
+		for (std::uint32_t i{0u}; i < joint_count; ++i) {
+			skeleton.joint_names.push_back(reader.readString());
+		}
+		reader.align(sizeof(std::uint64_t));
+		skeleton.parents = reader.readVector<std::uint32_t>();
+		reader.align(sizeof(std::uint64_t));
+		skeleton.bind_pose = reader.readVector<JointTransform>();
+		reader.align(sizeof(std::uint64_t));
+		skeleton.inverse_binds = reader.readVector<glm::mat4>();
+		if (skeleton.parents.size() != joint_count
+				|| skeleton.bind_pose.size() != joint_count
+				|| skeleton.inverse_binds.size() != joint_count) {
+			throw std::runtime_error("corrupt skeleton");
+		}
+		return skeleton;
+	}
+
+	void writeAnimation(BinaryWriter& writer, const CompressedAnimationClip& animation) {
+		writer.writeString(animation.name);
+		writer.write(animation.duration);
+		writer.write(animation.sample_rate);
+		writer.write(animation.frame_count);
+		writer.write(animation.joint_count);
+		writer.align(sizeof(std::uint64_t));
+		writer.writeVector(animation.joints);
+		writer.align(sizeof(std::uint64_t));
+		writer.writeVector(animation.keys);
+	}
+
+	CompressedAnimationClip readAnimation(BinaryReader& reader) {
+		CompressedAnimationClip animation;
+		animation.name = reader.readString();
+		animation.duration = reader.read<float>();
+		animation.sample_rate = reader.read<float>();
+		animation.frame_count = reader.read<std::uint32_t>();
+		animation.joint_count = reader.read<std::uint32_t>();
+		reader.align(sizeof(std::uint64_t));
+		animation.joints = reader.readVector<JointTracks>();
+		reader.align(sizeof(std::uint64_t));
+		animation.keys = reader.readVector<AnimationKey>();
+		return animation;
+	}
+
+} // namespace
+
+std::string mesh_cache::getCachePath(const std::string& source_path) {
+	return source_path + CACHE_EXTENSION;
+}
+
+std::shared_ptr<Model> mesh_cache::load(const std::string& source_path) {
+	const std::string cache_path{getCachePath(source_path)};
+	if (!getFileSystem().exists(cache_path)) {
+		return nullptr;
+	}
+
+	try {
+		const AssetFile cache{getFileSystem().open(cache_path)};
+		BinaryReader reader{cache.data(), cache.size()};
+
+		// Validating the cache's header
+		const unsigned char* magic{reader.skip(sizeof(CACHE_MAGIC))};
+		if (std::memcmp(magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0) {
+			return nullptr;
+		}
+		if (reader.read<std::uint32_t>() != CACHE_VERSION) {
+			return nullptr;
+		}
+		if (reader.readString() != source_path) {
+			return nullptr;
+		}
+		const std::size_t key_offset{reader.getPosition()};
+		const SourceKey cached_key{reader.read<SourceKey>()};
+		const std::uint64_t cached_hash{reader.read<std::uint64_t>()};
+
+		const SourceKey source_key{getSourceKey(source_path)};
+		const bool is_unmodified{
+			cached_key.modification_time == source_key.modification_time
+				&& cached_key.size == source_key.size
+		};
+		// Hash the source only if it was touched since the cache was written
+		if (!is_unmodified && (cached_key.size != source_key.size || hashSourceFile(source_path) != cached_hash)) {
+			return nullptr;
+		}
+
+		// Reading meshes
+		const std::uint32_t mesh_count{reader.read<std::uint32_t>()};
+		std::vector<std::shared_ptr<Mesh>> meshes;
+		meshes.reserve(mesh_count);
+		for (std::uint32_t i{0u}; i < mesh_count; ++i) {
+			meshes.push_back(readMesh(reader));
+		}
+
+		// Reading the node hierarchy
+		reader.align(sizeof(std::uint64_t));
+		std::vector<std::uint32_t> mesh_nodes{reader.readVector<std::uint32_t>()};
+		reader.align(sizeof(std::uint64_t));
+		std::vector<std::uint32_t> node_parents{reader.readVector<std::uint32_t>()};
+		reader.align(sizeof(std::uint64_t));
+		std::vector<glm::mat4> node_locals{reader.readVector<glm::mat4>()};
+		TransformHierarchy transforms{std::move(node_parents), std::move(node_locals)};
+
+		// Reading lights
+		reader.align(sizeof(std::uint64_t));
+		std::vector<Light> lights{reader.readVector<Light>()};
+
+		// Reading the skeleton, and animations
+		Skeleton skeleton{readSkeleton(reader)};
+		const std::uint32_t animation_count{reader.read<std::uint32_t>()};
+		std::vector<CompressedAnimationClip> animations;
+		animations.reserve(animation_count);
+		for (std::uint32_t i{0u}; i < animation_count; ++i) {
+			animations.push_back(readAnimation(reader));
+		}
+
+		std::shared_ptr<Model> model{std::make_shared<Model>(
+			std::move(meshes),
+			std::move(mesh_nodes),
+			std::move(transforms),
+			std::move(lights),
+			std::move(skeleton),
+			std::move(animations)
+		)};
+
+		// The source was only touched, so later loads compare the new key, instead of hashing the source again
+		if (!is_unmodified) {
+			try {
+				refreshSourceKey(cache_path, cache, key_offset, source_key);
+			} catch (const std::exception& e) {
+				ServiceLocator::getInstance().getLogger()->Warning(
+					"cannot update a mesh cache: " + cache_path + ": " + e.what()
+				);
+			}
+		}
+		return model;
+	} catch (const std::exception&) {
+		// A truncated, or otherwise corrupt cache is the same as no cache
+		return nullptr;
+	}
+}
+
+void mesh_cache::store(const std::string& source_path, const Model& model) {
+	for (const std::shared_ptr<Mesh>& mesh : model.meshes_) {
+		if (!mesh->isGeometryResident()) {
+			throw std::invalid_argument("cannot cache a model whose geometry was released: " + source_path);
+		}
+	}
+
+	BinaryWriter writer;
+
+	// Header
+	writer.writeArray(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+	writer.write(CACHE_VERSION);
+	writer.writeString(source_path);
+	writer.write(getSourceKey(source_path));
+	writer.write(hashSourceFile(source_path));
+
+	// Meshes
+	writer.write(static_cast<std::uint32_t>(model.meshes_.size()));
+	for (const std::shared_ptr<Mesh>& mesh : model.meshes_) {
+		writeMesh(writer, *mesh);
+	}
+
+	// Node hierarchy
+	writer.align(sizeof(std::uint64_t));
+	writer.writeVector(model.mesh_nodes_);
+	writer.align(sizeof(std::uint64_t));
+	writer.writeVector(model.transforms_.getParents());
+	writer.align(sizeof(std::uint64_t));
+	writer.writeVector(model.transforms_.getLocals());
+
+	// Lights
+	writer.align(sizeof(std::uint64_t));
+	writer.writeVector(model.lights_);
+
+	// Skeleton, and animations
+	writeSkeleton(writer, model.skeleton_);
+	writer.write(static_cast<std::uint32_t>(model.animations_.size()));
+	for (const CompressedAnimationClip& animation : model.animations_) {
+		writeAnimation(writer, animation);
+	}
+
+	writeCacheFile(getCachePath(source_path), writer.getBuffer());
+}
@@ -0,0 +1,404 @@
+#include "game/headers/model/mesh-optimizer.hh"
+
+#include "external/glm/glm/glm.hpp"
+#include "external/glm/glm/geometric.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace {
+
+	constexpr std::uint32_t INVALID_INDEX{std::numeric_limits<std::uint32_t>::max()};
+
+	// Vertex scoring constants from Tom Forsyth's paper
+	constexpr std::size_t FORSYTH_CACHE_SIZE{32u};
+	constexpr float CACHE_DECAY_POWER{1.5f};
+	constexpr float LAST_TRIANGLE_SCORE{0.75f};
+	constexpr float VALENCE_BOOST_SCALE{2.0f};
+	constexpr float VALENCE_BOOST_POWER{0.5f};
+
+	float getVertexScore(int cache_position, std::uint32_t remaining_valence) {
+		if (remaining_valence == 0u) {
+			// No triangle needs the vertex anymore
+			return -1.0f;
+		}
+
+		float score{0.0f};
+		if (cache_position >= 0) {
+			if (cache_position < 3) {
+				// Vertices of the last triangle are scored lower, so the next triangle does not share an edge
+				// in the same direction, which would be a strip with worse locality
+				score = LAST_TRIANGLE_SCORE;
+			} else {
+				const float scale{1.0f / static_cast<float>(FORSYTH_CACHE_SIZE - 3u)};
+				score = std::pow(1.0f - static_cast<float>(cache_position - 3) * scale, CACHE_DECAY_POWER);
+			}
+		}
+
+		// Vertices with few triangles left are preferred, so they can leave the cache for good
+		score += VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remaining_valence), -VALENCE_BOOST_POWER);
+		return score;
+	}
+
+	/**
+	 * FIFO cache simulation, which is how post-transform caches actually behave.
+	 * Resetting only advances the clock, so every cached vertex becomes too old.
+	 */
+	class FifoCacheSimulator {
+	public:
+		FifoCacheSimulator(std::size_t vertex_count, std::size_t cache_size):
+				timestamps_(vertex_count, 0u),
+				cache_size_{cache_size},
+				time_{cache_size + 1u} {
+		}
+
+		// Returns true if the vertex had to be transformed
+		bool access(std::uint32_t index) {
+			if (time_ - timestamps_[index] > cache_size_) {
+				timestamps_[index] = time_++;
+				return true;
+			}
+			return false;
+		}
+
+		void reset() {
+			time_ += cache_size_ + 1u;
+		}
+	private:
+		std::vector<std::size_t> timestamps_;
+		std::size_t cache_size_;
+		std::size_t time_;
+	};
+
+	struct Cluster {
+		std::size_t first_triangle;
+		std::size_t triangle_count;
+		float sort_key;
+	};
+
+	std::vector<std::size_t> findHardBoundaries(const std::vector<std::uint32_t>& indices, std::size_t vertex_count) {
+		// Cache optimized triangle orders miss the cache completely where they jump to a new part of the mesh
+		std::vector<std::size_t> boundaries;
+		FifoCacheSimulator cache{vertex_count, mesh_optimizer::DEFAULT_CACHE_SIZE};
+		const std::size_t triangle_count{indices.size() / 3u};
+		for (std::size_t triangle{0u}; triangle < triangle_count; ++triangle) {
+			unsigned int misses{0u};
+			for (std::size_t corner{0u}; corner < 3u; ++corner) {
+				misses += cache.access(indices[3u * triangle + corner]) ? 1u : 0u;
+			}
+			if (triangle == 0u || misses == 3u) {
+				boundaries.push_back(triangle);
+			}
+		}
+		return boundaries;
+	}
+
+	std::vector<Cluster> splitClusters(
+		const std::vector<std::uint32_t>& indices,
+		std::size_t vertex_count,
+		float threshold
+	) {
+		const std::size_t triangle_count{indices.size() / 3u};
+		std::vector<std::size_t> boundaries{findHardBoundaries(indices, vertex_count)};
+		boundaries.push_back(triangle_count);
+
+		std::vector<Cluster> clusters;
+		FifoCacheSimulator cache{vertex_count, mesh_optimizer::DEFAULT_CACHE_SIZE};
+		for (std::size_t i{0u}; i + 1u < boundaries.size(); ++i) {
+			const std::size_t begin{boundaries[i]};
+			const std::size_t end{boundaries[i + 1u]};
+
+			// Cache efficiency of the whole hard cluster
+			std::size_t cluster_misses{0u};
+			cache.reset();
+			for (std::size_t index{3u * begin}; index < 3u * end; ++index) {
+				cluster_misses += cache.access(indices[index]) ? 1u : 0u;
+			}
+			const float target_acmr{threshold * static_cast<float>(cluster_misses) / static_cast<float>(end - begin)};
+
+			// Splitting the hard cluster wherever the part so far is nearly as efficient as the whole
+			std::size_t split_begin{begin};
+			std::size_t split_misses{0u};
+			cache.reset();
+			for (std::size_t triangle{begin}; triangle < end; ++triangle) {
+				for (std::size_t corner{0u}; corner < 3u; ++corner) {
+					split_misses += cache.access(indices[3u * triangle + corner]) ? 1u : 0u;
+				}
+				const std::size_t split_triangles{triangle + 1u - split_begin};
+				const float split_acmr{static_cast<float>(split_misses) / static_cast<float>(split_triangles)};
+				if (triangle + 1u == end || split_acmr <= target_acmr) {
+					clusters.push_back({split_begin, split_triangles, 0.0f});
+					split_begin = triangle + 1u;
+					split_misses = 0u;
+					cache.reset();
+				}
+			}
+		}
+		return clusters;
+	}
+
+} // namespace
+
+float VertexCacheStats::getACMR() const {
+	return triangle_count == 0u ? 0.0f : static_cast<float>(transformed_vertex_count) / static_cast<float>(triangle_count);
+}
+
+float VertexCacheStats::getATVR() const {
+	return vertex_count == 0u ? 0.0f : static_cast<float>(transformed_vertex_count) / static_cast<float>(vertex_count);
+}
+
+VertexCacheStats& VertexCacheStats::operator+=(const VertexCacheStats& other) {
+	triangle_count += other.triangle_count;
+	vertex_count += other.vertex_count;
+	transformed_vertex_count += other.transformed_vertex_count;
+	return *this;
+}
+
+VertexCacheStats mesh_optimizer::analyzeVertexCache(
+	const std::vector<std::uint32_t>& indices,
+	std::size_t vertex_count,
+	std::size_t cache_size
+) {
+	VertexCacheStats stats{indices.size() / 3u, vertex_count, 0u};
+	FifoCacheSimulator cache{vertex_count, cache_size};
+	for (std::uint32_t index : indices) {
+		stats.transformed_vertex_count += cache.access(index) ? 1u : 0u;
+	}
+	return stats;
+}
+
+void mesh_optimizer::optimizeVertexCache(std::vector<std::uint32_t>& indices, std::size_t vertex_count) {
+	const std::size_t triangle_count{indices.size() / 3u};
+	if (triangle_count == 0u) {
+		return;
+	}
+
+	// Every vertex's triangles, where the first live_triangle_counts[vertex] are not emitted yet
+	std::vector<std::uint32_t> live_triangle_counts(vertex_count, 0u);
+	for (std::uint32_t index : indices) {
+		++live_triangle_counts[index];
+	}
+	std::vector<std::size_t> adjacency_offsets(vertex_count + 1u, 0u);
+	std::partial_sum(live_triangle_counts.cbegin(), live_triangle_counts.cend(), adjacency_offsets.begin() + 1);
+	std::vector<std::uint32_t> adjacency(indices.size());
+	{
+		std::vector<std::size_t> fill_offsets(adjacency_offsets.cbegin(), adjacency_offsets.cend() - 1);
+		for (std::size_t i{0u}; i < indices.size(); ++i) {
+			adjacency[fill_offsets[indices[i]]++] = static_cast<std::uint32_t>(i / 3u);
+		}
+	}
+
+	std::vector<int> cache_positions(vertex_count, -1);
+	std::vector<float> vertex_scores(vertex_count);
+	for (std::size_t vertex{0u}; vertex < vertex_count; ++vertex) {
+		vertex_scores[vertex] = getVertexScore(-1, live_triangle_counts[vertex]);
+	}
+
+	std::vector<float> triangle_scores(triangle_count);
+	std::vector<bool> is_emitted(triangle_count, false);
+	std::uint32_t best_triangle{0u};
+	for (std::size_t triangle{0u}; triangle < triangle_count; ++triangle) {
+		triangle_scores[triangle] = vertex_scores[indices[3u * triangle]]
+			+ vertex_scores[indices[3u * triangle + 1u]]
+			+ vertex_scores[indices[3u * triangle + 2u]];
+		if (triangle_scores[triangle] > triangle_scores[best_triangle]) {
+			best_triangle = static_cast<std::uint32_t>(triangle);
+		}
+	}
+
+	std::vector<std::uint32_t> optimized;
+	optimized.reserve(indices.size());
+	std::vector<std::uint32_t> cache;
+	std::vector<std::uint32_t> next_cache;
+	cache.reserve(FORSYTH_CACHE_SIZE + 3u);
+	next_cache.reserve(FORSYTH_CACHE_SIZE + 3u);
+	std::size_t next_unemitted{0u};
+
+	while (optimized.size() < indices.size()) {
+		if (best_triangle == INVALID_INDEX) {
+			// Nothing in the cache has triangles left, continuing with the first triangle not emitted yet
+			while (is_emitted[next_unemitted]) {
+				++next_unemitted;
+			}
+			best_triangle = static_cast<std::uint32_t>(next_unemitted);
+		}
+
+		const std::uint32_t* triangle_vertices{&indices[3u * best_triangle]};
+		optimized.insert(optimized.end(), triangle_vertices, triangle_vertices + 3);
+		is_emitted[best_triangle] = true;
+
+		// Removing the emitted triangle from its vertices' live triangles
+		for (std::size_t corner{0u}; corner < 3u; ++corner) {
+			const std::uint32_t vertex{triangle_vertices[corner]};
+			std::uint32_t* live_begin{&adjacency[adjacency_offsets[vertex]]};
+			std::uint32_t* live_end{live_begin + live_triangle_counts[vertex]};
+			std::uint32_t* found{std::find(live_begin, live_end, best_triangle)};
+			if (found != live_end) {
+				std::swap(*found, *(live_end - 1));
+				--live_triangle_counts[vertex];
+			}
+		}
+
+		// The emitted triangle's vertices move to the front of the LRU cache
+		next_cache.assign(triangle_vertices, triangle_vertices + 3);
+		for (std::uint32_t vertex : cache) {
+			if (vertex != triangle_vertices[0] && vertex != triangle_vertices[1] && vertex != triangle_vertices[2]) {
+				next_cache.push_back(vertex);
+			}
+		}
+
+		// Rescoring every vertex which moved in, or out of the cache, and their triangles
+		for (std::size_t position{0u}; position < next_cache.size(); ++position) {
+			const std::uint32_t vertex{next_cache[position]};
+			cache_positions[vertex] = position < FORSYTH_CACHE_SIZE ? static_cast<int>(position) : -1;
+			vertex_scores[vertex] = getVertexScore(cache_positions[vertex], live_triangle_counts[vertex]);
+		}
+		best_triangle = INVALID_INDEX;
+		float best_score{-std::numeric_limits<float>::max()};
+		for (std::uint32_t vertex : next_cache) {
+			const std::size_t live_begin{adjacency_offsets[vertex]};
+			const std::size_t live_end{live_begin + live_triangle_counts[vertex]};
+			for (std::size_t i{live_begin}; i < live_end; ++i) {
+				const std::uint32_t triangle{adjacency[i]};
+				const float score{
+					vertex_scores[indices[3u * triangle]]
+					+ vertex_scores[indices[3u * triangle + 1u]]
+					+ vertex_scores[indices[3u * triangle + 2u]]
+				};
+				triangle_scores[triangle] = score;
+				if (score > best_score || (score == best_score && triangle < best_triangle)) {
+					best_score = score;
+					best_triangle = triangle;
+				}
+			}
+		}
+
+		if (next_cache.size() > FORSYTH_CACHE_SIZE) {
+			next_cache.resize(FORSYTH_CACHE_SIZE);
+		}
+		std::swap(cache, next_cache);
+	}
+
+	indices = std::move(optimized);
+}
+
+void mesh_optimizer::optimizeOverdraw(
+	std::vector<std::uint32_t>& indices,
+	const std::vector<Vertex>& vertices,
+	float threshold
+) {
+	const std::size_t triangle_count{indices.size() / 3u};
+	if (triangle_count == 0u) {
+		return;
+	}
+
+	std::vector<Cluster> clusters{splitClusters(indices, vertices.size(), threshold)};
+	if (clusters.size() < 2u) {
+		return;
+	}
+
+	// Area weighted centroids, and normals whose lengths are twice the areas
+	std::vector<glm::vec3> cluster_centroids(clusters.size(), glm::vec3(0.0f));
+	std::vector<glm::vec3> cluster_normals(clusters.size(), glm::vec3(0.0f));
+	glm::vec3 mesh_centroid{0.0f};
+	float mesh_area{0.0f};
+	for (std::size_t i{0u}; i < clusters.size(); ++i) {
+		float cluster_area{0.0f};
+		for (std::size_t triangle{clusters[i].first_triangle}; triangle < clusters[i].first_triangle + clusters[i].triangle_count; ++triangle) {
+			const glm::vec3& a{vertices[indices[3u * triangle]].position};
+			const glm::vec3& b{vertices[indices[3u * triangle + 1u]].position};
+			const glm::vec3& c{vertices[indices[3u * triangle + 2u]].position};
+			const glm::vec3 normal{glm::cross(b - a, c - a)};
+			const float area{glm::length(normal)};
+
+			cluster_centroids[i] += (a + b + c) * (area / 3.0f);
+			cluster_normals[i] += normal;
+			cluster_area += area;
+		}
+
+		mesh_centroid += cluster_centroids[i];
+		mesh_area += cluster_area;
+		if (cluster_area > 0.0f) {
+			cluster_centroids[i] /= cluster_area;
+		}
+	}
+	if (mesh_area > 0.0f) {
+		mesh_centroid /= mesh_area;
+	}
+
+	// Clusters facing away from the mesh's centre are likely in front of the rest of it
+	for (std::size_t i{0u}; i < clusters.size(); ++i) {
+		const float normal_length{glm::length(cluster_normals[i])};
+		clusters[i].sort_key = normal_length > 0.0f
+			? glm::dot(cluster_centroids[i] - mesh_centroid, cluster_normals[i] / normal_length)
+			: 0.0f;
+	}
+	std::stable_sort(
+		clusters.begin(),
+		clusters.end(),
+		[](const Cluster& a, const Cluster& b) {
+			return a.sort_key > b.sort_key;
+		}
+	);
+
+	std::vector<std::uint32_t> sorted;
+	sorted.reserve(indices.size());
+	for (const Cluster& cluster : clusters) {
+		const auto first{indices.cbegin() + 3u * cluster.first_triangle};
+		sorted.insert(sorted.end(), first, first + 3u * cluster.triangle_count);
+	}
+	indices = std::move(sorted);
+}
+
+void mesh_optimizer::optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<std::uint32_t>& indices) {
+	std::vector<VertexSkin> skin;
+	optimizeVertexFetch(vertices, indices, skin);
+}
+
+void mesh_optimizer::optimizeVertexFetch(
+	std::vector<Vertex>& vertices,
+	std::vector<std::uint32_t>& indices,
+	std::vector<VertexSkin>& skin
+) {
+	const bool is_skinned{!skin.empty()};
+	std::vector<std::uint32_t> remap(vertices.size(), INVALID_INDEX);
+	std::vector<Vertex> reordered;
+	reordered.reserve(vertices.size());
+	std::vector<VertexSkin> reordered_skin;
+	reordered_skin.reserve(skin.size());
+	for (std::uint32_t& index : indices) {
+		if (remap[index] == INVALID_INDEX) {
+			remap[index] = static_cast<std::uint32_t>(reordered.size());
+			reordered.push_back(vertices[index]);
+			if (is_skinned) {
+				reordered_skin.push_back(skin[index]);
+			}
+		}
+		index = remap[index];
+	}
+	vertices = std::move(reordered);
+	skin = std::move(reordered_skin);
+}
+
+MeshOptimizationReport mesh_optimizer::optimize(std::vector<Vertex>& vertices, std::vector<std::uint32_t>& indices) {
+	std::vector<VertexSkin> skin;
+	return optimize(vertices, indices, skin);
+}
+
+MeshOptimizationReport mesh_optimizer::optimize(
+	std::vector<Vertex>& vertices,
+	std::vector<std::uint32_t>& indices,
+	std::vector<VertexSkin>& skin
+) {
+	MeshOptimizationReport report;
+	report.before = analyzeVertexCache(indices, vertices.size());
+
+	optimizeVertexCache(indices, vertices.size());
+	optimizeOverdraw(indices, vertices);
+	optimizeVertexFetch(vertices, indices, skin);
+
+	report.after = analyzeVertexCache(indices, vertices.size());
+	return report;
+}
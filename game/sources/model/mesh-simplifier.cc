@@ -0,0 +1,342 @@
+#include "game/headers/model/mesh-simplifier.hh"
+
+#include "game/headers/model/mesh-optimizer.hh"
+#include "game/headers/utility/hash.hh"
+
+#include "external/glm/glm/glm.hpp"
+#include "external/glm/glm/geometric.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+
+namespace {
+
+	constexpr float MAX_NORMAL_TURN_COSINE{0.25f};
+
+	// Plane distance quadric, the symmetric 4x4 matrix is stored as its upper triangle
+	struct Quadric {
+		double a2, ab, ac, ad;
+		double b2, bc, bd;
+		double c2, cd;
+		double d2;
+		// Total area of the planes
+		double weight;
+
+		Quadric& operator+=(const Quadric& other) {
+			a2 += other.a2; ab += other.ab; ac += other.ac; ad += other.ad;
+			b2 += other.b2; bc += other.bc; bd += other.bd;
+			c2 += other.c2; cd += other.cd;
+			d2 += other.d2;
+			weight += other.weight;
+			return *this;
+		}
+
+		// Area weighted mean squared distance of the point from the planes
+		double evaluate(const glm::vec3& point) const {
+			const double x{point.x};
+			const double y{point.y};
+			const double z{point.z};
+			const double squared_distance{
+				a2 * x * x + b2 * y * y + c2 * z * z + d2
+					+ 2.0 * (ab * x * y + ac * x * z + ad * x + bc * y * z + bd * y + cd * z)
+			};
+			return weight > 0.0 ? std::max(squared_distance, 0.0) / weight : 0.0;
+		}
+	};
+
+	Quadric makePlaneQuadric(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+		const glm::vec3 cross{glm::cross(b - a, c - a)};
+		const double length{glm::length(cross)};
+		if (length == 0.0) {
+			return Quadric{};
+		}
+		const double area{0.5 * length};
+		const double nx{cross.x / length};
+		const double ny{cross.y / length};
+		const double nz{cross.z / length};
+		const double d{-(nx * a.x + ny * a.y + nz * a.z)};
+		return {
+			area * nx * nx, area * nx * ny, area * nx * nz, area * nx * d,
+			area * ny * ny, area * ny * nz, area * ny * d,
+			area * nz * nz, area * nz * d,
+			area * d * d,
+			area
+		};
+	}
+
+	struct Collapse {
+		std::uint32_t from;
+		std::uint32_t to;
+		double cost;
+	};
+
+	struct PositionHash {
+		std::size_t operator()(const glm::vec3& position) const {
+			return static_cast<std::size_t>(hash_aux::fnv1a(&position, sizeof(glm::vec3)));
+		}
+	};
+
+	struct PositionEqual {
+		bool operator()(const glm::vec3& a, const glm::vec3& b) const {
+			return std::memcmp(&a, &b, sizeof(glm::vec3)) == 0;
+		}
+	};
+
+	class Simplifier {
+	public:
+		Simplifier(const std::vector<Vertex>& vertices, const std::vector<std::uint32_t>& indices):
+				vertices_{vertices},
+				indices_{indices},
+				quadrics_(vertices.size(), Quadric{}),
+				is_locked_(vertices.size(), false) {
+			findLockedVertices();
+			for (std::size_t i{0u}; i + 2u < indices_.size(); i += 3u) {
+				const Quadric quadric{
+					makePlaneQuadric(getPosition(indices_[i]), getPosition(indices_[i + 1u]), getPosition(indices_[i + 2u]))
+				};
+				for (std::size_t corner{0u}; corner < 3u; ++corner) {
+					quadrics_[indices_[i + corner]] += quadric;
+				}
+			}
+		}
+
+		std::size_t getTriangleCount() const {
+			return indices_.size() / 3u;
+		}
+
+		const std::vector<std::uint32_t>& getIndices() const {
+			return indices_;
+		}
+
+		float getError() const {
+			return static_cast<float>(std::sqrt(max_cost_));
+		}
+
+		/**
+		 * Collapses the cheapest edges, at most one per vertex neighbourhood, until the target is reached.
+		 * Returns false if no edge could be collapsed.
+		 */
+		bool runPass(std::size_t target_triangle_count) {
+			buildAdjacency();
+
+			std::vector<Collapse> collapses;
+			collapses.reserve(indices_.size());
+			for (std::size_t i{0u}; i < indices_.size(); i += 3u) {
+				for (std::size_t corner{0u}; corner < 3u; ++corner) {
+					const std::uint32_t from{indices_[i + corner]};
+					const std::uint32_t to{indices_[i + (corner + 1u) % 3u]};
+					if (is_locked_[from]) {
+						continue;
+					}
+					Quadric quadric{quadrics_[from]};
+					quadric += quadrics_[to];
+					collapses.push_back({from, to, quadric.evaluate(getPosition(to))});
+				}
+			}
+			// Ties are broken by the vertices, so the order does not depend on the sort's implementation
+			std::sort(
+				collapses.begin(),
+				collapses.end(),
+				[](const Collapse& a, const Collapse& b) {
+					if (a.cost != b.cost) {
+						return a.cost < b.cost;
+					}
+					return a.from != b.from ? a.from < b.from : a.to < b.to;
+				}
+			);
+
+			// Every collapse removes about two triangles
+			const std::size_t collapse_budget{(getTriangleCount() - target_triangle_count) / 2u + 1u};
+			std::vector<std::uint32_t> remap(vertices_.size());
+			std::iota(remap.begin(), remap.end(), 0u);
+			std::vector<bool> is_touched(vertices_.size(), false);
+			std::size_t collapse_count{0u};
+
+			for (const Collapse& collapse : collapses) {
+				if (collapse_count >= collapse_budget) {
+					break;
+				}
+				if (is_touched[collapse.from] || is_touched[collapse.to] || flipsTriangles(collapse)) {
+					continue;
+				}
+
+				remap[collapse.from] = collapse.to;
+				quadrics_[collapse.to] += quadrics_[collapse.from];
+				max_cost_ = std::max(max_cost_, collapse.cost);
+				++collapse_count;
+
+				// The neighbourhood is frozen for the rest of the pass, so later flip checks see current triangles
+				forEachTriangle(collapse.from, [this, &is_touched](std::size_t triangle) {
+					for (std::size_t corner{0u}; corner < 3u; ++corner) {
+						is_touched[indices_[3u * triangle + corner]] = true;
+					}
+				});
+				is_touched[collapse.to] = true;
+			}
+			if (collapse_count == 0u) {
+				return false;
+			}
+
+			// Applying the collapses, and dropping triangles which became degenerate
+			std::vector<std::uint32_t> collapsed;
+			collapsed.reserve(indices_.size());
+			for (std::size_t i{0u}; i < indices_.size(); i += 3u) {
+				const std::uint32_t a{remap[indices_[i]]};
+				const std::uint32_t b{remap[indices_[i + 1u]]};
+				const std::uint32_t c{remap[indices_[i + 2u]]};
+				if (a != b && b != c && c != a) {
+					collapsed.insert(collapsed.end(), {a, b, c});
+				}
+			}
+			indices_ = std::move(collapsed);
+			return true;
+		}
+	private:
+		const std::vector<Vertex>& vertices_;
+		std::vector<std::uint32_t> indices_;
+		std::vector<Quadric> quadrics_;
+		std::vector<bool> is_locked_;
+		double max_cost_{0.0};
+
+		// Every vertex's triangles
+		std::vector<std::size_t> adjacency_offsets_;
+		std::vector<std::uint32_t> adjacency_;
+
+		const glm::vec3& getPosition(std::uint32_t vertex) const {
+			return vertices_[vertex].position;
+		}
+
+		void findLockedVertices() {
+			// Vertices sharing a position differ in other attributes, they lie on a seam
+			std::unordered_map<glm::vec3, std::uint32_t, PositionHash, PositionEqual> position_ids;
+			position_ids.reserve(vertices_.size());
+			std::vector<std::uint32_t> position_of(vertices_.size());
+			std::vector<std::uint32_t> wedge_counts;
+			for (std::size_t vertex{0u}; vertex < vertices_.size(); ++vertex) {
+				const auto [it, inserted]{
+					position_ids.emplace(vertices_[vertex].position, static_cast<std::uint32_t>(wedge_counts.size()))
+				};
+				if (inserted) {
+					wedge_counts.push_back(0u);
+				}
+				position_of[vertex] = it->second;
+				++wedge_counts[it->second];
+			}
+			for (std::size_t vertex{0u}; vertex < vertices_.size(); ++vertex) {
+				is_locked_[vertex] = wedge_counts[position_of[vertex]] > 1u;
+			}
+
+			// An edge without its opposite half-edge lies on a border, or is not manifold
+			std::unordered_map<std::uint64_t, int> edge_balances;
+			edge_balances.reserve(indices_.size());
+			const auto makeEdgeKey{[](std::uint32_t a, std::uint32_t b) {
+				return (static_cast<std::uint64_t>(std::min(a, b)) << 32) | std::max(a, b);
+			}};
+			for (std::size_t i{0u}; i < indices_.size(); i += 3u) {
+				for (std::size_t corner{0u}; corner < 3u; ++corner) {
+					const std::uint32_t a{position_of[indices_[i + corner]]};
+					const std::uint32_t b{position_of[indices_[i + (corner + 1u) % 3u]]};
+					edge_balances[makeEdgeKey(a, b)] += a < b ? 1 : -1;
+				}
+			}
+			std::vector<bool> is_border_position(wedge_counts.size(), false);
+			for (const auto& [key, balance] : edge_balances) {
+				if (balance != 0) {
+					is_border_position[static_cast<std::uint32_t>(key >> 32)] = true;
+					is_border_position[static_cast<std::uint32_t>(key & 0xffffffffu)] = true;
+				}
+			}
+			for (std::size_t vertex{0u}; vertex < vertices_.size(); ++vertex) {
+				if (is_border_position[position_of[vertex]]) {
+					is_locked_[vertex] = true;
+				}
+			}
+		}
+
+		void buildAdjacency() {
+			adjacency_offsets_.assign(vertices_.size() + 1u, 0u);
+			for (std::uint32_t index : indices_) {
+				++adjacency_offsets_[index + 1u];
+			}
+			std::partial_sum(adjacency_offsets_.cbegin(), adjacency_offsets_.cend(), adjacency_offsets_.begin());
+			adjacency_.resize(indices_.size());
+			std::vector<std::size_t> fill_offsets(adjacency_offsets_.cbegin(), adjacency_offsets_.cend() - 1);
+			for (std::size_t i{0u}; i < indices_.size(); ++i) {
+				adjacency_[fill_offsets[indices_[i]]++] = static_cast<std::uint32_t>(i / 3u);
+			}
+		}
+
+		template <typename F>
+		void forEachTriangle(std::uint32_t vertex, F func) const {
+			for (std::size_t i{adjacency_offsets_[vertex]}; i < adjacency_offsets_[vertex + 1u]; ++i) {
+				func(adjacency_[i]);
+			}
+		}
+
+		bool flipsTriangles(const Collapse& collapse) const {
+			bool flips{false};
+			forEachTriangle(collapse.from, [this, &collapse, &flips](std::size_t triangle) {
+				const std::uint32_t* corners{&indices_[3u * triangle]};
+				if (corners[0] == collapse.to || corners[1] == collapse.to || corners[2] == collapse.to) {
+					// The triangle disappears with the collapse
+					return;
+				}
+				glm::vec3 positions[3];
+				glm::vec3 moved_positions[3];
+				for (std::size_t corner{0u}; corner < 3u; ++corner) {
+					positions[corner] = getPosition(corners[corner]);
+					moved_positions[corner] = getPosition(corners[corner] == collapse.from ? collapse.to : corners[corner]);
+				}
+				const glm::vec3 normal{glm::cross(positions[1] - positions[0], positions[2] - positions[0])};
+				const glm::vec3 moved_normal{
+					glm::cross(moved_positions[1] - moved_positions[0], moved_positions[2] - moved_positions[0])
+				};
+				// Turning by more than about 75 degrees flips the triangle, or makes it a sliver
+				if (glm::dot(normal, moved_normal) <= MAX_NORMAL_TURN_COSINE * glm::length(normal) * glm::length(moved_normal)) {
+					flips = true;
+				}
+			});
+			return flips;
+		}
+	};
+
+} // namespace
+
+std::vector<MeshLod> mesh_simplifier::generateLods(
+	const std::vector<Vertex>& vertices,
+	const std::vector<std::uint32_t>& indices,
+	std::size_t max_lod_count,
+	float reduction
+) {
+	std::vector<MeshLod> lods;
+	Simplifier simplifier{vertices, indices};
+
+	// Every level continues simplifying the previous one, with the quadrics of the full mesh
+	std::size_t previous_triangle_count{simplifier.getTriangleCount()};
+	while (lods.size() < max_lod_count) {
+		const std::size_t target_triangle_count{
+			static_cast<std::size_t>(static_cast<float>(previous_triangle_count) * reduction)
+		};
+		if (target_triangle_count < MIN_LOD_TRIANGLE_COUNT) {
+			break;
+		}
+
+		while (simplifier.getTriangleCount() > target_triangle_count && simplifier.runPass(target_triangle_count)) {
+		}
+
+		// Levels which barely simplify the previous one only waste memory
+		const std::size_t triangle_count{simplifier.getTriangleCount()};
+		if (triangle_count * 10u > previous_triangle_count * 9u) {
+			break;
+		}
+
+		MeshLod lod{simplifier.getIndices(), simplifier.getError()};
+		mesh_optimizer::optimizeVertexCache(lod.indices, vertices.size());
+		lods.push_back(std::move(lod));
+		previous_triangle_count = triangle_count;
+	}
+	return lods;
+}
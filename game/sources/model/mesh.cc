@@ -1,9 +1,153 @@
 #include "game/headers/model/mesh.hh"
 
+#include "game/headers/utility/hash.hh"
+
+#include "external/glm/glm/geometric.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
 #include <utility>
 
-Mesh::Mesh(std::vector<Triangle>&& triangles, std::vector<Texture>&& textures, Material material):
-	triangles_{std::move(triangles)},
+namespace {
+
+	// Positions are compared bit by bit, like the vertex deduplicator does
+	struct PositionHash {
+		std::size_t operator()(const glm::vec3& position) const {
+			return static_cast<std::size_t>(hash_aux::fnv1a(&position, sizeof(glm::vec3)));
+		}
+	};
+	struct PositionEqual {
+		bool operator()(const glm::vec3& first, const glm::vec3& second) const {
+			return std::memcmp(&first, &second, sizeof(glm::vec3)) == 0;
+		}
+	};
+
+} // namespace
+
+Mesh::Mesh(
+	std::vector<Vertex>&& vertices,
+	std::vector<std::uint32_t>&& indices,
+	std::vector<Texture>&& textures,
+	Material material,
+	std::vector<MeshLod>&& lods,
+	std::vector<VertexSkin>&& skin
+):
+	vertices_{std::move(vertices)},
+	indices_{std::move(indices)},
 	textures_{std::move(textures)},
-	material_{material} {
+	skin_{std::move(skin)},
+	material_{material},
+	lods_{std::move(lods)},
+	bounds_{computeBounds(vertices_)},
+	bounding_sphere_{computeBoundingSphere(vertices_, bounds_)} {
+	if (!skin_.empty() && skin_.size() != vertices_.size()) {
+		throw std::invalid_argument("a skinned mesh needs a skin for every vertex");
+	}
+	updateMemoryRecord();
+}
+
+bool Mesh::isSkinned() const {
+	return !skin_.empty() || is_skinned_;
+}
+
+const MemoryUsage& Mesh::getMemoryUsage() const {
+	return memory_.getUsage();
+}
+
+void Mesh::updateMemoryRecord() {
+	std::size_t index_bytes{indices_.capacity() * sizeof(std::uint32_t)};
+	for (const MeshLod& lod : lods_) {
+		index_bytes += lod.indices.capacity() * sizeof(std::uint32_t);
+	}
+	for (const Submesh& submesh : submeshes_) {
+		index_bytes += sizeof(Submesh) + submesh.levels.capacity() * sizeof(IndexRange);
+	}
+	memory_.set(
+		MemoryDomain::Cpu,
+		MemoryCategory::Vertices,
+		vertices_.capacity() * sizeof(Vertex) + skin_.capacity() * sizeof(VertexSkin)
+	);
+	memory_.set(MemoryDomain::Cpu, MemoryCategory::Indices, index_bytes);
+	memory_.set(
+		MemoryDomain::Cpu,
+		MemoryCategory::Collision,
+		collision_.positions.capacity() * sizeof(glm::vec3) + collision_.indices.capacity() * sizeof(std::uint32_t)
+	);
+}
+
+void Mesh::releaseGeometry() {
+	if (!is_geometry_resident_) {
+		return;
+	}
+	if (is_collision_source_) {
+		collision_ = buildCollisionGeometry();
+	}
+
+	// Swapping with empty vectors, as clear() keeps the capacity
+	is_skinned_ = isSkinned();
+	std::vector<Vertex>().swap(vertices_);
+	std::vector<VertexSkin>().swap(skin_);
+	std::vector<std::uint32_t>().swap(indices_);
+	for (MeshLod& lod : lods_) {
+		std::vector<std::uint32_t>().swap(lod.indices);
+	}
+	is_geometry_resident_ = false;
+	updateMemoryRecord();
+}
+
+bool Mesh::isGeometryResident() const {
+	return is_geometry_resident_;
+}
+
+CollisionGeometry Mesh::buildCollisionGeometry() const {
+	CollisionGeometry collision;
+	collision.indices.reserve(indices_.size());
+
+	std::vector<std::uint32_t> remap(vertices_.size());
+	std::unordered_map<glm::vec3, std::uint32_t, PositionHash, PositionEqual> position_indices;
+	position_indices.reserve(vertices_.size());
+	for (std::size_t i{0u}; i < vertices_.size(); ++i) {
+		const std::uint32_t next_index{static_cast<std::uint32_t>(collision.positions.size())};
+		const auto [it, inserted]{position_indices.emplace(vertices_[i].position, next_index)};
+		if (inserted) {
+			collision.positions.push_back(vertices_[i].position);
+		}
+		remap[i] = it->second;
+	}
+	collision.positions.shrink_to_fit();
+
+	for (std::uint32_t index : indices_) {
+		collision.indices.push_back(remap[index]);
+	}
+	return collision;
+}
+
+BoundingBox Mesh::computeBounds(const std::vector<Vertex>& vertices) {
+	if (vertices.empty()) {
+		return {glm::vec3(0.0f), glm::vec3(0.0f)};
+	}
+	BoundingBox bounds{vertices.front().position, vertices.front().position};
+	for (const Vertex& vertex : vertices) {
+		bounds.min = glm::min(bounds.min, vertex.position);
+		bounds.max = glm::max(bounds.max, vertex.position);
+	}
+	return bounds;
+}
+
+BoundingSphere Mesh::computeBoundingSphere(const std::vector<Vertex>& vertices, const BoundingBox& bounds) {
+	const glm::vec3 center{0.5f * (bounds.min + bounds.max)};
+	float radius_squared{0.0f};
+	for (const Vertex& vertex : vertices) {
+		const glm::vec3 offset{vertex.position - center};
+		radius_squared = std::max(radius_squared, glm::dot(offset, offset));
+	}
+	return {center, std::sqrt(radius_squared)};
+}
+
+bool Mesh::hasShortIndices() const {
+	return vertices_.size() <= std::numeric_limits<std::uint16_t>::max() + 1u;
 }
@@ -0,0 +1,83 @@
+#include "game/headers/model/model-loader.hh"
+
+#include "game/headers/model/mesh-simplifier.hh"
+#include "game/headers/model/static-batcher.hh"
+#include "game/headers/service-locator.hh"
+
+#include <sstream>
+#include <utility>
+
+std::future<std::shared_ptr<Model>> ModelLoader::loadModelAsync(const std::string& path, ModelLoadOptions options) {
+	return ServiceLocator::getInstance().getThreadPool().submit([this, path, options]() {
+		std::shared_ptr<Model> model{loadModel(path)};
+		if (options.is_static) {
+			StaticBatchReport report;
+			model = static_batcher::batch(*model, report);
+			std::ostringstream message;
+			message << "Batched " << path << ": " << report.mesh_count << " -> " << report.batched_mesh_count
+				<< " meshes, " << report.merged_mesh_count << " of them merged";
+			ServiceLocator::getInstance().getLogger()->Info(message.str());
+		}
+		if (options.is_collision_source) {
+			model->setCollisionSource(true);
+		}
+		return model;
+	});
+}
+
+std::shared_ptr<Mesh> ModelLoader::buildMesh(
+	std::vector<Vertex>&& vertices,
+	std::vector<std::uint32_t>&& indices,
+	std::vector<Texture>&& textures,
+	const Material& material,
+	MeshOptimizationReport& report
+) {
+	return buildMesh(std::move(vertices), std::move(indices), std::move(textures), {}, material, report);
+}
+
+std::shared_ptr<Mesh> ModelLoader::buildMesh(
+	std::vector<Vertex>&& vertices,
+	std::vector<std::uint32_t>&& indices,
+	std::vector<Texture>&& textures,
+	std::vector<VertexSkin>&& skin,
+	const Material& material,
+	MeshOptimizationReport& report
+) {
+	report = mesh_optimizer::optimize(vertices, indices, skin);
+	// Levels of detail index the same vertices, so they share the skin
+	std::vector<MeshLod> lods{mesh_simplifier::generateLods(vertices, indices)};
+
+	return std::make_shared<Mesh>(
+		std::move(vertices),
+		std::move(indices),
+		std::move(textures),
+		material,
+		std::move(lods),
+		std::move(skin)
+	);
+}
+
+void ModelLoader::logOptimizationReports(const std::string& path, const std::vector<MeshOptimizationReport>& reports) {
+	MeshOptimizationReport total{};
+	for (const MeshOptimizationReport& report : reports) {
+		total.before += report.before;
+		total.after += report.after;
+	}
+
+	std::ostringstream message;
+	message << "Optimized " << path << ": "
+		<< "ACMR " << total.before.getACMR() << " -> " << total.after.getACMR() << ", "
+		<< "ATVR " << total.before.getATVR() << " -> " << total.after.getATVR();
+	ServiceLocator::getInstance().getLogger()->Info(message.str());
+}
+
+void ModelLoader::logCompressionReports(const std::string& path, const std::vector<AnimationCompressionReport>& reports) {
+	for (const AnimationCompressionReport& report : reports) {
+		std::ostringstream message;
+		message << "Compressed animation " << report.clip << " of " << path << ": "
+			<< report.raw_bytes << " -> " << report.compressed_bytes << " bytes (" << report.getRatio() << "x), "
+			<< report.key_count << " of " << report.frame_count << " keys, "
+			<< "max error " << report.max_error;
+		ServiceLocator::getInstance().getLogger()->Info(message.str());
+	}
+}
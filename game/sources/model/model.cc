@@ -1,5 +1,107 @@
 #include "game/headers/model/model.hh"
 
+#include <stdexcept>
+#include <unordered_set>
+
 Model::Model(std::vector<std::shared_ptr<Mesh>>&& meshes, std::vector<Light>&& lights):
 	meshes_{std::move(meshes)}, lights_{std::move(lights)} {
+	const std::uint32_t root{transforms_.addNode(TransformHierarchy::NO_PARENT, glm::mat4(1.0f))};
+	mesh_nodes_.assign(meshes_.size(), root);
+	updateMemoryRecord();
+}
+
+Model::Model(
+	std::vector<std::shared_ptr<Mesh>>&& meshes,
+	std::vector<std::uint32_t>&& mesh_nodes,
+	TransformHierarchy&& transforms,
+	std::vector<Light>&& lights,
+	Skeleton&& skeleton,
+	std::vector<CompressedAnimationClip>&& animations
+):
+	meshes_{std::move(meshes)},
+	mesh_nodes_{std::move(mesh_nodes)},
+	transforms_{std::move(transforms)},
+	lights_{std::move(lights)},
+	skeleton_{std::move(skeleton)},
+	animations_{std::move(animations)} {
+	if (mesh_nodes_.size() != meshes_.size()) {
+		throw std::invalid_argument("every mesh needs a node");
+	}
+	for (std::uint32_t node : mesh_nodes_) {
+		if (node >= transforms_.getNodeCount()) {
+			throw std::invalid_argument("a mesh's node does not exist");
+		}
+	}
+
+	// Skins, and clips index the skeleton's joints
+	const std::size_t joint_count{skeleton_.getJointCount()};
+	for (const std::shared_ptr<Mesh>& mesh : meshes_) {
+		for (const VertexSkin& skin : mesh->skin_) {
+			for (std::size_t i{0u}; i < 4u; ++i) {
+				if (skin.weights[i] != 0.0f && skin.joints[i] >= joint_count) {
+					throw std::invalid_argument("a mesh's skin refers to a joint which does not exist");
+				}
+			}
+		}
+	}
+	for (const CompressedAnimationClip& animation : animations_) {
+		if (animation.joint_count != joint_count || animation.frame_count == 0u || animation.joints.size() != joint_count) {
+			throw std::invalid_argument("an animation does not match the model's skeleton: " + animation.name);
+		}
+		// Sampling trusts every track to have keys within the clip's key stream
+		for (const JointTracks& tracks : animation.joints) {
+			for (const AnimationTrack& track : {tracks.translation, tracks.rotation, tracks.scale}) {
+				if (track.key_count == 0u
+						|| track.first_key > animation.keys.size()
+						|| track.key_count > animation.keys.size() - track.first_key) {
+					throw std::invalid_argument("an animation's track is outside of its keys: " + animation.name);
+				}
+			}
+		}
+	}
+	updateMemoryRecord();
+}
+
+const CompressedAnimationClip* Model::findAnimation(const std::string& name) const {
+	for (const CompressedAnimationClip& animation : animations_) {
+		if (animation.name == name) {
+			return &animation;
+		}
+	}
+	return nullptr;
+}
+
+MemoryUsage Model::getMemoryUsage() const {
+	MemoryUsage usage{memory_.getUsage()};
+	std::unordered_set<const Mesh*> counted_meshes;
+	for (const std::shared_ptr<Mesh>& mesh : meshes_) {
+		if (counted_meshes.insert(mesh.get()).second) {
+			usage += mesh->getMemoryUsage();
+		}
+	}
+	return usage;
+}
+
+void Model::updateMemoryRecord() {
+	// Local, and world matrices, parents, and dirty flags of every node
+	const std::size_t node_bytes{
+		transforms_.getNodeCount() * (2u * sizeof(glm::mat4) + sizeof(std::uint32_t) + sizeof(std::uint8_t))
+	};
+	memory_.set(
+		MemoryDomain::Cpu,
+		MemoryCategory::Scene,
+		node_bytes + mesh_nodes_.capacity() * sizeof(std::uint32_t) + lights_.capacity() * sizeof(Light)
+	);
+
+	std::size_t animation_bytes{skeleton_.getMemorySize() + animations_.capacity() * sizeof(CompressedAnimationClip)};
+	for (const CompressedAnimationClip& animation : animations_) {
+		animation_bytes += animation.getMemorySize();
+	}
+	memory_.set(MemoryDomain::Cpu, MemoryCategory::Animation, animation_bytes);
+}
+
+void Model::setCollisionSource(bool is_collision_source) {
+	for (const std::shared_ptr<Mesh>& mesh : meshes_) {
+		mesh->is_collision_source_ = is_collision_source;
+	}
 }
@@ -0,0 +1,170 @@
+#include "game/headers/model/obj/obj-model-loader.hh"
+
+#include "game/headers/model/mesh-cache.hh"
+#include "game/headers/model/vertex-deduplicator.hh"
+#include "game/headers/service-locator.hh"
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+ObjModelLoader::ObjModelLoader(std::unique_ptr<ModelLoader> fallback, bool use_mesh_cache):
+	fallback_{std::move(fallback)}, use_mesh_cache_{use_mesh_cache} {
+}
+
+std::shared_ptr<Model> ObjModelLoader::loadModel(const std::string& path) {
+	if (!isObjFile(path)) {
+		if (fallback_ == nullptr) {
+			throw std::invalid_argument("not an OBJ file: " + path);
+		}
+		return fallback_->loadModel(path);
+	}
+
+	// Skip the parser if the model was already processed
+	if (use_mesh_cache_) {
+		std::shared_ptr<Model> cached_model{mesh_cache::load(path)};
+		if (cached_model) {
+			return cached_model;
+		}
+	}
+
+	std::shared_ptr<Model> model{loadObjModel(path)};
+
+	if (use_mesh_cache_) {
+		try {
+			mesh_cache::store(path, *model);
+		} catch (const std::exception& e) {
+			ServiceLocator::getInstance().getLogger()->Warning(std::string("cannot cache a model: ") + e.what());
+		}
+	}
+
+	return model;
+}
+
+bool ObjModelLoader::isObjFile(const std::string& path) {
+	std::string extension{std::filesystem::path(path).extension().string()};
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) {
+		return static_cast<char>(std::tolower(c));
+	});
+	return extension == ".obj";
+}
+
+std::shared_ptr<Model> ObjModelLoader::loadObjModel(const std::string& path) const {
+	ObjScene scene;
+	{
+		const AssetFile file{ServiceLocator::getInstance().getFileSystem().open(path)};
+		scene = obj_parser::parse(
+			reinterpret_cast<const char*>(file.data()),
+			file.size(),
+			ServiceLocator::getInstance().getThreadPool()
+		);
+	}
+	const std::unordered_map<std::string, ObjMaterial> materials{loadMaterials(path, scene)};
+
+	// Every object is a node under the root, like Assimp places them
+	std::vector<const ObjMesh*> scene_meshes;
+	std::vector<std::uint32_t> mesh_nodes;
+	TransformHierarchy transforms;
+	const std::uint32_t root{transforms.addNode(TransformHierarchy::NO_PARENT, glm::mat4(1.0f))};
+	for (const ObjObject& object : scene.objects) {
+		const std::uint32_t node{transforms.addNode(root, glm::mat4(1.0f))};
+		for (const ObjMesh& mesh : object.meshes) {
+			if (!mesh.corners.empty()) {
+				scene_meshes.push_back(&mesh);
+				mesh_nodes.push_back(node);
+			}
+		}
+	}
+
+	// Converting the meshes in parallel, each into its own slot, so the order stays the same
+	std::vector<std::shared_ptr<Mesh>> meshes(scene_meshes.size());
+	std::vector<MeshOptimizationReport> reports(scene_meshes.size());
+	ServiceLocator::getInstance().getThreadPool().parallelFor(
+		scene_meshes.size(),
+		[&scene, &scene_meshes, &materials, &meshes, &reports](std::size_t i) {
+			meshes[i] = processMesh(scene, *scene_meshes[i], materials, reports[i]);
+		}
+	);
+	logOptimizationReports(path, reports);
+
+	// OBJ files have no lights
+	return std::make_shared<Model>(std::move(meshes), std::move(mesh_nodes), std::move(transforms), std::vector<Light>{});
+}
+
+std::unordered_map<std::string, ObjMaterial> ObjModelLoader::loadMaterials(const std::string& path, const ObjScene& scene) {
+	// Library paths are relative to the OBJ file
+	const std::filesystem::path directory{std::filesystem::path(path).parent_path()};
+
+	std::unordered_map<std::string, ObjMaterial> materials;
+	for (const std::string& library : scene.material_libraries) {
+		const std::string library_path{(directory / library).string()};
+		try {
+			const AssetFile file{ServiceLocator::getInstance().getFileSystem().open(library_path)};
+			std::unordered_map<std::string, ObjMaterial> library_materials{
+				obj_parser::parseMaterials(reinterpret_cast<const char*>(file.data()), file.size())
+			};
+			// A material defined by several libraries keeps its first definition
+			materials.insert(library_materials.begin(), library_materials.end());
+		} catch (const std::runtime_error& e) {
+			ServiceLocator::getInstance().getLogger()->Warning(
+				"cannot load a material library: " + library_path + ": " + e.what()
+			);
+		}
+	}
+	return materials;
+}
+
+std::shared_ptr<Mesh> ObjModelLoader::processMesh(
+	const ObjScene& scene,
+	const ObjMesh& mesh,
+	const std::unordered_map<std::string, ObjMaterial>& materials,
+	MeshOptimizationReport& report
+) {
+	// Setting up unique vertices, and triangle indices
+	VertexDeduplicator deduplicator{mesh.corners.size()};
+	std::vector<std::uint32_t> indices;
+	indices.reserve(mesh.corners.size());
+	for (std::size_t i{0u}; i + 2u < mesh.corners.size(); i += 3u) {
+		Vertex triangle[3]{};
+		for (std::size_t j{0u}; j < 3u; ++j) {
+			const ObjCorner& corner{mesh.corners[i + j]};
+			triangle[j].position = scene.positions[corner.position];
+			if (mesh.has_normals && corner.normal != ObjCorner::NO_INDEX) {
+				triangle[j].normal = scene.normals[corner.normal];
+			}
+			if (mesh.has_tex_coords) {
+				// Texture coordinates are flipped vertically, as OpenGL's images start at the bottom
+				const glm::vec2 tex_coords{
+					corner.tex_coords != ObjCorner::NO_INDEX ? scene.tex_coords[corner.tex_coords] : glm::vec2(0.0f)
+				};
+				triangle[j].tex_coords = {tex_coords.x, 1.0f - tex_coords.y};
+			}
+		}
+
+		// Faces without normals are flat shaded
+		if (!mesh.has_normals) {
+			const glm::vec3 normal{
+				glm::cross(triangle[1].position - triangle[0].position, triangle[2].position - triangle[0].position)
+			};
+			const float length{glm::length(normal)};
+			for (Vertex& vertex : triangle) {
+				vertex.normal = length > 0.0f ? normal / length : glm::vec3(0.0f);
+			}
+		}
+
+		for (const Vertex& vertex : triangle) {
+			indices.push_back(deduplicator.add(vertex));
+		}
+	}
+
+	// Setting up a material
+	const auto it{materials.find(mesh.material)};
+	ObjMaterial material{it != materials.end() ? it->second : obj_parser::getDefaultMaterial()};
+
+	return buildMesh(deduplicator.takeVertices(), std::move(indices), std::move(material.textures), material.material, report);
+}
@@ -0,0 +1,542 @@
+#include "game/headers/model/obj/obj-parser.hh"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+namespace {
+
+	// Files smaller than this are parsed by a single thread
+	constexpr std::size_t MIN_CHUNK_SIZE{1u << 20u};
+
+	// Text between two line boundaries
+	struct Chunk {
+		const char* begin;
+		const char* end;
+	};
+
+	struct AttributeCounts {
+		std::size_t positions{0u};
+		std::size_t tex_coords{0u};
+		std::size_t normals{0u};
+	};
+
+	// Lines which change the state faces are grouped by
+	enum class GroupStart {
+		// Faces continuing the previous chunk's state
+		Continue,
+		Object,
+		Group,
+		Material
+	};
+
+	// Faces of a chunk following a state change
+	struct FaceGroup {
+		GroupStart start{GroupStart::Continue};
+		std::string name;
+		std::vector<ObjCorner> corners;
+		bool has_tex_coords{false};
+		bool has_normals{false};
+	};
+
+	struct ChunkResult {
+		std::vector<FaceGroup> groups;
+		std::vector<std::string> material_libraries;
+	};
+
+	bool isSpace(char c) {
+		return c == ' ' || c == '\t';
+	}
+
+	std::string_view trim(const char* begin, const char* end) {
+		while (begin < end && isSpace(*begin)) {
+			++begin;
+		}
+		while (end > begin && (isSpace(end[-1]) || end[-1] == '\r')) {
+			--end;
+		}
+		return {begin, static_cast<std::size_t>(end - begin)};
+	}
+
+	// Calls func with every line of the text, without its surrounding whitespace
+	template <typename F>
+	void forEachLine(const char* begin, const char* end, F&& func) {
+		while (begin < end) {
+			const char* line_end{static_cast<const char*>(std::memchr(begin, '\n', end - begin))};
+			if (line_end == nullptr) {
+				line_end = end;
+			}
+			func(trim(begin, line_end));
+			begin = line_end + 1;
+		}
+	}
+
+	// Splits the line into its keyword, and the keyword's arguments
+	std::string_view splitKeyword(std::string_view line, std::string_view& arguments) {
+		std::size_t keyword_end{0u};
+		while (keyword_end < line.size() && !isSpace(line[keyword_end])) {
+			++keyword_end;
+		}
+		arguments = trim(line.data() + keyword_end, line.data() + line.size());
+		return line.substr(0u, keyword_end);
+	}
+
+	const char* skipSpaces(const char* it, const char* end) {
+		while (it < end && isSpace(*it)) {
+			++it;
+		}
+		return it;
+	}
+
+#if !defined(__cpp_lib_to_chars)
+	constexpr double POWERS_OF_TEN[]{
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	/**
+	 * Standard libraries without floating point std::from_chars get this instead. Up to 19 significant
+	 * digits are accumulated into an integer, and scaled by an exactly representable power of ten,
+	 * which is within a unit in the last place of the correctly rounded float.
+	 */
+	std::from_chars_result parseDecimal(const char* it, const char* end, float& value) {
+		const char* const start{it};
+		const bool is_negative{it < end && *it == '-'};
+		if (is_negative) {
+			++it;
+		}
+
+		std::uint64_t mantissa{0u};
+		int digit_count{0};
+		int exponent{0};
+		bool has_digits{false};
+		for (; it < end && *it >= '0' && *it <= '9'; ++it) {
+			has_digits = true;
+			if (digit_count < 19) {
+				mantissa = 10u * mantissa + static_cast<std::uint64_t>(*it - '0');
+				digit_count += mantissa != 0u;
+			} else {
+				++exponent;
+			}
+		}
+		if (it < end && *it == '.') {
+			for (++it; it < end && *it >= '0' && *it <= '9'; ++it) {
+				has_digits = true;
+				if (digit_count < 19) {
+					mantissa = 10u * mantissa + static_cast<std::uint64_t>(*it - '0');
+					digit_count += mantissa != 0u;
+					--exponent;
+				}
+			}
+		}
+		if (!has_digits) {
+			return {start, std::errc::invalid_argument};
+		}
+		if (it < end && (*it == 'e' || *it == 'E')) {
+			const char* exponent_begin{it + 1};
+			if (exponent_begin < end && *exponent_begin == '+') {
+				++exponent_begin;
+			}
+			int written_exponent;
+			const std::from_chars_result result{std::from_chars(exponent_begin, end, written_exponent)};
+			if (result.ec == std::errc{}) {
+				exponent += written_exponent;
+				it = result.ptr;
+			}
+		}
+
+		double scaled{static_cast<double>(mantissa)};
+		if (exponent >= 0) {
+			scaled *= exponent <= 22 ? POWERS_OF_TEN[exponent] : std::pow(10.0, exponent);
+		} else {
+			scaled /= exponent >= -22 ? POWERS_OF_TEN[-exponent] : std::pow(10.0, -exponent);
+		}
+		value = static_cast<float>(is_negative ? -scaled : scaled);
+		return {it, std::errc{}};
+	}
+#endif
+
+	const char* parseFloat(const char* it, const char* end, float& value) {
+		it = skipSpaces(it, end);
+		// Neither parser accepts an explicit plus sign
+		if (it < end && *it == '+') {
+			++it;
+		}
+#if defined(__cpp_lib_to_chars)
+		const std::from_chars_result result{std::from_chars(it, end, value)};
+#else
+		const std::from_chars_result result{parseDecimal(it, end, value)};
+#endif
+		if (result.ec != std::errc{}) {
+			throw std::runtime_error("invalid number in an OBJ file: " + std::string(it, end));
+		}
+		return result.ptr;
+	}
+
+	// Missing trailing components are zero
+	template <std::size_t N>
+	void parseFloats(std::string_view arguments, float (&values)[N], std::size_t required_count) {
+		const char* it{arguments.data()};
+		const char* const end{arguments.data() + arguments.size()};
+		for (std::size_t i{0u}; i < N; ++i) {
+			it = skipSpaces(it, end);
+			if (it == end) {
+				if (i < required_count) {
+					throw std::runtime_error("missing vertex components in an OBJ file: " + std::string(arguments));
+				}
+				values[i] = 0.0f;
+				continue;
+			}
+			it = parseFloat(it, end, values[i]);
+		}
+	}
+
+	// Resolves a one-based, or a negative index relative to the attributes preceding it
+	std::uint32_t resolveIndex(long long index, std::size_t preceding_count, std::size_t total_count) {
+		const long long resolved{index > 0 ? index - 1 : static_cast<long long>(preceding_count) + index};
+		if (index == 0 || resolved < 0 || resolved >= static_cast<long long>(total_count)) {
+			throw std::runtime_error("face index out of range in an OBJ file: " + std::to_string(index));
+		}
+		return static_cast<std::uint32_t>(resolved);
+	}
+
+	// Parses "v", "v/vt", "v//vn", or "v/vt/vn"
+	const char* parseCorner(
+		const char* it,
+		const char* end,
+		const AttributeCounts& preceding,
+		const AttributeCounts& total,
+		ObjCorner& corner
+	) {
+		long long index;
+		std::from_chars_result result{std::from_chars(it, end, index)};
+		if (result.ec != std::errc{}) {
+			throw std::runtime_error("invalid face in an OBJ file: " + std::string(it, end));
+		}
+		corner.position = resolveIndex(index, preceding.positions, total.positions);
+		corner.tex_coords = ObjCorner::NO_INDEX;
+		corner.normal = ObjCorner::NO_INDEX;
+		it = result.ptr;
+
+		if (it < end && *it == '/') {
+			++it;
+			if (it < end && *it != '/') {
+				result = std::from_chars(it, end, index);
+				if (result.ec != std::errc{}) {
+					throw std::runtime_error("invalid face in an OBJ file: " + std::string(it, end));
+				}
+				corner.tex_coords = resolveIndex(index, preceding.tex_coords, total.tex_coords);
+				it = result.ptr;
+			}
+			if (it < end && *it == '/') {
+				++it;
+				result = std::from_chars(it, end, index);
+				if (result.ec != std::errc{}) {
+					throw std::runtime_error("invalid face in an OBJ file: " + std::string(it, end));
+				}
+				corner.normal = resolveIndex(index, preceding.normals, total.normals);
+				it = result.ptr;
+			}
+		}
+		return it;
+	}
+
+	std::vector<Chunk> splitIntoChunks(const char* data, std::size_t size, std::size_t max_chunk_count) {
+		const std::size_t chunk_count{std::max<std::size_t>(1u, std::min(max_chunk_count, size / MIN_CHUNK_SIZE))};
+		const char* const end{data + size};
+
+		std::vector<Chunk> chunks;
+		const char* begin{data};
+		for (std::size_t i{1u}; i <= chunk_count && begin < end; ++i) {
+			const char* chunk_end{end};
+			if (i < chunk_count) {
+				// Extending the chunk to the end of the line it splits
+				chunk_end = std::max(begin, data + size / chunk_count * i);
+				const void* line_end{std::memchr(chunk_end, '\n', end - chunk_end)};
+				chunk_end = line_end != nullptr ? static_cast<const char*>(line_end) + 1 : end;
+			}
+			chunks.push_back({begin, chunk_end});
+			begin = chunk_end;
+		}
+		return chunks;
+	}
+
+	AttributeCounts countAttributes(const Chunk& chunk) {
+		AttributeCounts counts;
+		forEachLine(chunk.begin, chunk.end, [&counts](std::string_view line) {
+			if (line.size() < 2u || line[0] != 'v') {
+				return;
+			}
+			if (isSpace(line[1])) {
+				++counts.positions;
+			} else if (line.size() > 2u && isSpace(line[2])) {
+				counts.tex_coords += line[1] == 't';
+				counts.normals += line[1] == 'n';
+			}
+		});
+		return counts;
+	}
+
+	/**
+	 * Parses the chunk's attributes into the scene's arrays, after those of the preceding chunks,
+	 * and collects the chunk's faces.
+	 */
+	ChunkResult parseChunk(const Chunk& chunk, AttributeCounts preceding, const AttributeCounts& total, ObjScene& scene) {
+		ChunkResult result;
+		result.groups.emplace_back();
+
+		std::vector<ObjCorner> face;
+		forEachLine(chunk.begin, chunk.end, [&](std::string_view line) {
+			if (line.empty() || line[0] == '#') {
+				return;
+			}
+			std::string_view arguments;
+			const std::string_view keyword{splitKeyword(line, arguments)};
+
+			if (keyword == "v") {
+				float values[3];
+				parseFloats(arguments, values, 3u);
+				scene.positions[preceding.positions++] = {values[0], values[1], values[2]};
+			} else if (keyword == "vt") {
+				float values[2];
+				parseFloats(arguments, values, 1u);
+				scene.tex_coords[preceding.tex_coords++] = {values[0], values[1]};
+			} else if (keyword == "vn") {
+				float values[3];
+				parseFloats(arguments, values, 3u);
+				scene.normals[preceding.normals++] = {values[0], values[1], values[2]};
+			} else if (keyword == "f") {
+				face.clear();
+				const char* it{arguments.data()};
+				const char* const end{arguments.data() + arguments.size()};
+				while ((it = skipSpaces(it, end)) < end) {
+					ObjCorner corner;
+					it = parseCorner(it, end, preceding, total, corner);
+					face.push_back(corner);
+				}
+
+				// Points, and lines are not drawn
+				FaceGroup& group{result.groups.back()};
+				for (std::size_t i{1u}; i + 1u < face.size(); ++i) {
+					group.corners.push_back(face[0]);
+					group.corners.push_back(face[i]);
+					group.corners.push_back(face[i + 1u]);
+				}
+				for (const ObjCorner& corner : face) {
+					group.has_tex_coords |= corner.tex_coords != ObjCorner::NO_INDEX;
+					group.has_normals |= corner.normal != ObjCorner::NO_INDEX;
+				}
+			} else if (keyword == "o" || keyword == "g" || keyword == "usemtl") {
+				FaceGroup group;
+				group.start = keyword == "o" ? GroupStart::Object : (keyword == "g" ? GroupStart::Group : GroupStart::Material);
+				group.name = std::string(arguments);
+				result.groups.push_back(std::move(group));
+			} else if (keyword == "mtllib") {
+				result.material_libraries.emplace_back(arguments);
+			}
+			// Smoothing groups, and other statements do not affect the meshes
+		});
+		return result;
+	}
+
+	/**
+	 * Joins the chunks' faces into objects, and meshes, following the state changes in file order.
+	 * Mirrors Assimp's OBJ parser: 'o' always starts an object, 'g' starts one when the group name
+	 * changes, and 'usemtl' starts a mesh when the current one has faces of another material.
+	 */
+	void groupFaces(std::vector<ChunkResult>& chunks, ObjScene& scene) {
+		std::string material{obj_parser::DEFAULT_MATERIAL_NAME};
+		std::string active_group;
+
+		const auto start_object{[&scene, &material](std::string name) {
+			ObjObject object;
+			object.name = std::move(name);
+			object.meshes.emplace_back();
+			object.meshes.back().material = material;
+			scene.objects.push_back(std::move(object));
+		}};
+
+		for (ChunkResult& chunk : chunks) {
+			for (std::string& library : chunk.material_libraries) {
+				scene.material_libraries.push_back(std::move(library));
+			}
+
+			for (FaceGroup& group : chunk.groups) {
+				switch (group.start) {
+					case GroupStart::Continue:
+						break;
+					case GroupStart::Object:
+						if (!group.name.empty()) {
+							start_object(group.name);
+						}
+						break;
+					case GroupStart::Group:
+						if (group.name != active_group) {
+							start_object(group.name);
+							active_group = group.name;
+						}
+						break;
+					case GroupStart::Material:
+						if (group.name == material) {
+							break;
+						}
+						material = group.name;
+						if (!scene.objects.empty()) {
+							std::vector<ObjMesh>& meshes{scene.objects.back().meshes};
+							if (!meshes.back().corners.empty()) {
+								meshes.emplace_back();
+							}
+							meshes.back().material = material;
+						}
+						break;
+				}
+
+				if (group.corners.empty()) {
+					continue;
+				}
+				if (scene.objects.empty()) {
+					start_object(obj_parser::DEFAULT_OBJECT_NAME);
+				}
+				ObjMesh& mesh{scene.objects.back().meshes.back()};
+				if (mesh.corners.empty()) {
+					mesh.corners = std::move(group.corners);
+				} else {
+					mesh.corners.insert(mesh.corners.end(), group.corners.cbegin(), group.corners.cend());
+				}
+				mesh.has_tex_coords |= group.has_tex_coords;
+				mesh.has_normals |= group.has_normals;
+			}
+		}
+	}
+
+	void parseColor(std::string_view arguments, glm::vec3& color) {
+		float values[3];
+		parseFloats(arguments, values, 3u);
+		color = {values[0], values[1], values[2]};
+	}
+
+	// The texture's path follows its options, and may contain spaces
+	std::string parseTexturePath(std::string_view arguments) {
+		while (!arguments.empty() && arguments[0] == '-') {
+			std::string_view rest;
+			const std::string_view option{splitKeyword(arguments, rest)};
+
+			std::size_t value_count{1u};
+			if (option == "-mm") {
+				value_count = 2u;
+			} else if (option == "-o" || option == "-s" || option == "-t") {
+				value_count = 3u;
+			}
+			for (std::size_t i{0u}; i < value_count && !rest.empty(); ++i) {
+				splitKeyword(rest, rest);
+			}
+			arguments = rest;
+		}
+		return std::string(arguments);
+	}
+
+	/**
+	 * A material has a single texture of each type, a later map replaces the earlier one.
+	 * Diffuse textures precede specular ones, in the order Assimp's materials are read in.
+	 */
+	void setTexture(std::vector<Texture>& textures, const std::string& type, std::string path) {
+		textures.erase(
+			std::remove_if(textures.begin(), textures.end(), [&type](const Texture& texture) {
+				return texture.type == type;
+			}),
+			textures.end()
+		);
+		if (path.empty()) {
+			return;
+		}
+		const auto position{type == "texture_diffuse" ? textures.begin() : textures.end()};
+		textures.insert(position, {type, std::move(path)});
+	}
+
+} // namespace
+
+ObjMaterial obj_parser::getDefaultMaterial() {
+	ObjMaterial material{};
+	material.material.color_ambient = glm::vec3(0.0f);
+	material.material.color_diffuse = glm::vec3(0.6f);
+	material.material.color_specular = glm::vec3(0.0f);
+	material.material.shininess = 0.0f;
+	return material;
+}
+
+ObjScene obj_parser::parse(const char* data, std::size_t size, ThreadPool& pool) {
+	const std::vector<Chunk> chunks{splitIntoChunks(data, size, pool.getThreadCount() + 1u)};
+
+	// Counting every chunk's attributes first, so each chunk knows where its attributes go,
+	// and what negative indices refer to
+	std::vector<AttributeCounts> counts(chunks.size());
+	pool.parallelFor(chunks.size(), [&chunks, &counts](std::size_t i) {
+		counts[i] = countAttributes(chunks[i]);
+	});
+
+	std::vector<AttributeCounts> preceding(chunks.size());
+	AttributeCounts total;
+	for (std::size_t i{0u}; i < chunks.size(); ++i) {
+		preceding[i] = total;
+		total.positions += counts[i].positions;
+		total.tex_coords += counts[i].tex_coords;
+		total.normals += counts[i].normals;
+	}
+
+	ObjScene scene;
+	scene.positions.resize(total.positions);
+	scene.tex_coords.resize(total.tex_coords);
+	scene.normals.resize(total.normals);
+
+	std::vector<ChunkResult> results(chunks.size());
+	pool.parallelFor(chunks.size(), [&chunks, &preceding, &total, &scene, &results](std::size_t i) {
+		results[i] = parseChunk(chunks[i], preceding[i], total, scene);
+	});
+
+	groupFaces(results, scene);
+	return scene;
+}
+
+std::unordered_map<std::string, ObjMaterial> obj_parser::parseMaterials(const char* data, std::size_t size) {
+	std::unordered_map<std::string, ObjMaterial> materials;
+	ObjMaterial* material{nullptr};
+
+	forEachLine(data, data + size, [&materials, &material](std::string_view line) {
+		if (line.empty() || line[0] == '#') {
+			return;
+		}
+		std::string_view arguments;
+		const std::string_view keyword{splitKeyword(line, arguments)};
+
+		if (keyword == "newmtl") {
+			material = &materials[std::string(arguments)];
+			*material = getDefaultMaterial();
+			return;
+		}
+		if (material == nullptr) {
+			return;
+		}
+
+		if (keyword == "Ka") {
+			parseColor(arguments, material->material.color_ambient);
+		} else if (keyword == "Kd") {
+			parseColor(arguments, material->material.color_diffuse);
+		} else if (keyword == "Ks") {
+			parseColor(arguments, material->material.color_specular);
+		} else if (keyword == "Ns") {
+			float values[1];
+			parseFloats(arguments, values, 1u);
+			material->material.shininess = values[0];
+		} else if (keyword == "map_Kd") {
+			setTexture(material->textures, "texture_diffuse", parseTexturePath(arguments));
+		} else if (keyword == "map_Ks") {
+			setTexture(material->textures, "texture_specular", parseTexturePath(arguments));
+		}
+	});
+	return materials;
+}
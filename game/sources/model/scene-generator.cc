@@ -0,0 +1,445 @@
+#include "game/headers/model/scene-generator.hh"
+
+#include "external/glm/glm/ext/matrix_transform.hpp"
+#include "external/glm/glm/ext/scalar_constants.hpp"
+
+#include "game/headers/service-locator.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+	constexpr const char* INSTANCES_EXTENSION{".instances"};
+	constexpr float RIPPLE_HEIGHT{0.05f};
+	constexpr float MIN_MESH_SCALE{1.0f};
+	constexpr float MAX_MESH_SCALE{5.0f};
+	constexpr std::uint32_t CHECKER_CELLS{8u};
+
+	/**
+	 * Same numbers on every platform, unlike the standard distributions.
+	 */
+	class Random {
+	public:
+		explicit Random(std::uint32_t seed): engine_{seed} {
+		}
+
+		float uniform(float min, float max) {
+			return min + (max - min) * static_cast<float>(engine_() >> 8u) * (1.0f / 16777216.0f);
+		}
+
+		glm::vec3 color(float min, float max) {
+			const float r{uniform(min, max)};
+			const float g{uniform(min, max)};
+			const float b{uniform(min, max)};
+			return {r, g, b};
+		}
+	private:
+		std::mt19937 engine_;
+	};
+
+	// Every part of the scene draws from its own sequence, so they can be generated in any order
+	std::uint32_t getSeed(std::uint32_t seed, std::uint32_t stream, std::size_t index) {
+		return seed * 2654435761u ^ stream * 40503u ^ static_cast<std::uint32_t>(index) * 2246822519u;
+	}
+
+	enum SeedStream : std::uint32_t {
+		MeshStream = 1u,
+		MaterialStream,
+		TextureStream,
+		LightStream
+	};
+
+	std::string getTexturePath(const SceneGeneratorSettings& settings, std::size_t texture) {
+		return (fs::path(settings.directory) / (settings.name + "-texture-" + std::to_string(texture) + ".tga")).generic_string();
+	}
+
+	std::string getMaterialName(std::size_t material, const Mesh& mesh) {
+		std::string name{"material-" + std::to_string(material)};
+		if (!mesh.textures_.empty()) {
+			name += "-" + fs::path(mesh.textures_.front().path).stem().string();
+		}
+		return name;
+	}
+
+	/**
+	 * Rippled square grid in the XZ plane, of unit size, centered at the origin, facing up.
+	 */
+	std::shared_ptr<Mesh> generateMesh(
+		std::size_t triangle_count,
+		const Material& material,
+		std::vector<Texture>&& textures,
+		Random& random
+	) {
+		const std::uint32_t cells{std::max(
+			1u,
+			static_cast<std::uint32_t>(std::ceil(std::sqrt(static_cast<double>(triangle_count) / 2.0)))
+		)};
+		const std::uint32_t row_size{cells + 1u};
+		const float frequency_x{random.uniform(1.0f, 3.0f) * 2.0f * glm::pi<float>()};
+		const float frequency_z{random.uniform(1.0f, 3.0f) * 2.0f * glm::pi<float>()};
+		const float phase_x{random.uniform(0.0f, 2.0f * glm::pi<float>())};
+		const float phase_z{random.uniform(0.0f, 2.0f * glm::pi<float>())};
+
+		std::vector<Vertex> vertices;
+		vertices.reserve(static_cast<std::size_t>(row_size) * row_size);
+		for (std::uint32_t row{0u}; row < row_size; ++row) {
+			for (std::uint32_t column{0u}; column < row_size; ++column) {
+				const float u{static_cast<float>(column) / cells};
+				const float v{static_cast<float>(row) / cells};
+				const float x{u - 0.5f};
+				const float z{v - 0.5f};
+				const float wave_x{x * frequency_x + phase_x};
+				const float wave_z{z * frequency_z + phase_z};
+
+				Vertex vertex;
+				vertex.position = glm::vec3(x, RIPPLE_HEIGHT * std::sin(wave_x) * std::cos(wave_z), z);
+				// From the height's partial derivatives
+				vertex.normal = glm::normalize(glm::vec3(
+					-RIPPLE_HEIGHT * frequency_x * std::cos(wave_x) * std::cos(wave_z),
+					1.0f,
+					RIPPLE_HEIGHT * frequency_z * std::sin(wave_x) * std::sin(wave_z)
+				));
+				vertex.tex_coords = glm::vec2(u, v);
+				vertices.push_back(vertex);
+			}
+		}
+
+		std::vector<std::uint32_t> indices;
+		indices.reserve(static_cast<std::size_t>(cells) * cells * 6u);
+		for (std::uint32_t row{0u}; row < cells; ++row) {
+			for (std::uint32_t column{0u}; column < cells; ++column) {
+				const std::uint32_t corner{row * row_size + column};
+				// Counter-clockwise seen from above
+				indices.insert(indices.end(), {
+					corner, corner + row_size, corner + 1u,
+					corner + 1u, corner + row_size, corner + row_size + 1u
+				});
+			}
+		}
+
+		return std::make_shared<Mesh>(std::move(vertices), std::move(indices), std::move(textures), material);
+	}
+
+	GeneratedTexture generateTexture(const SceneGeneratorSettings& settings, std::size_t index) {
+		Random random{getSeed(settings.seed, TextureStream, index)};
+		const glm::vec3 first{random.color(0.2f, 1.0f)};
+		const glm::vec3 second{random.color(0.0f, 0.6f)};
+
+		GeneratedTexture texture;
+		texture.path = getTexturePath(settings, index);
+		texture.width = std::max(1u, settings.texture_size);
+		texture.height = texture.width;
+		texture.pixels.resize(static_cast<std::size_t>(texture.width) * texture.height * 4u);
+
+		// A checkerboard, so the texture coordinates are easy to inspect
+		const std::uint32_t cell_size{std::max(1u, texture.width / CHECKER_CELLS)};
+		for (std::uint32_t y{0u}; y < texture.height; ++y) {
+			for (std::uint32_t x{0u}; x < texture.width; ++x) {
+				const glm::vec3& color{((x / cell_size + y / cell_size) % 2u == 0u) ? first : second};
+				std::uint8_t* pixel{&texture.pixels[(static_cast<std::size_t>(y) * texture.width + x) * 4u]};
+				pixel[0] = static_cast<std::uint8_t>(color.x * 255.0f);
+				pixel[1] = static_cast<std::uint8_t>(color.y * 255.0f);
+				pixel[2] = static_cast<std::uint8_t>(color.z * 255.0f);
+				pixel[3] = 255u;
+			}
+		}
+		return texture;
+	}
+
+	/**
+	 * Uncompressed 32-bit TGA, which every image loader reads.
+	 */
+	void writeTga(const GeneratedTexture& texture) {
+		if (texture.width > 0xffffu || texture.height > 0xffffu) {
+			throw std::runtime_error("texture is too large for a TGA file: " + texture.path);
+		}
+		const unsigned char header[18]{
+			0u, 0u, 2u,
+			0u, 0u, 0u, 0u, 0u,
+			0u, 0u, 0u, 0u,
+			static_cast<unsigned char>(texture.width & 0xffu), static_cast<unsigned char>(texture.width >> 8u),
+			static_cast<unsigned char>(texture.height & 0xffu), static_cast<unsigned char>(texture.height >> 8u),
+			32u,
+			// Eight bits of alpha, rows from the top
+			0x28u
+		};
+
+		// TGA stores pixels as BGRA
+		std::vector<std::uint8_t> pixels{texture.pixels};
+		for (std::size_t i{0u}; i + 3u < pixels.size(); i += 4u) {
+			std::swap(pixels[i], pixels[i + 2u]);
+		}
+
+		std::ofstream file{texture.path, std::ios::binary | std::ios::trunc};
+		file.write(reinterpret_cast<const char*>(header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(pixels.data()), static_cast<std::streamsize>(pixels.size()));
+		if (!file) {
+			throw std::runtime_error("cannot write a texture: " + texture.path);
+		}
+	}
+
+	template <typename... Values>
+	void appendFormat(std::string& text, const char* format, Values... values) {
+		char buffer[128];
+		const int length{std::snprintf(buffer, sizeof(buffer), format, static_cast<double>(values)...)};
+		text.append(buffer, static_cast<std::size_t>(std::max(0, length)));
+	}
+
+	std::ofstream openOutput(const std::string& path) {
+		std::ofstream file{path, std::ios::binary | std::ios::trunc};
+		if (!file) {
+			throw std::runtime_error("cannot create a file: " + path);
+		}
+		return file;
+	}
+
+} // namespace
+
+GeneratedScene scene_generator::generate(const SceneGeneratorSettings& settings) {
+	GeneratedScene scene;
+
+	scene.textures.resize(settings.texture_count);
+	ServiceLocator::getInstance().getThreadPool().parallelFor(
+		settings.texture_count,
+		[&settings, &scene](std::size_t i) {
+			scene.textures[i] = generateTexture(settings, i);
+		}
+	);
+
+	std::vector<Material> materials;
+	materials.reserve(std::max<std::size_t>(1u, settings.material_count));
+	for (std::size_t i{0u}; i < std::max<std::size_t>(1u, settings.material_count); ++i) {
+		Random random{getSeed(settings.seed, MaterialStream, i)};
+		Material material;
+		material.color_diffuse = random.color(0.2f, 0.9f);
+		material.color_ambient = material.color_diffuse * 0.1f;
+		material.color_specular = glm::vec3(random.uniform(0.1f, 0.5f));
+		material.shininess = random.uniform(8.0f, 64.0f);
+		materials.push_back(material);
+	}
+
+	// Every mesh has its own node under the root, scattered over the extent
+	std::vector<std::shared_ptr<Mesh>> meshes(settings.mesh_count);
+	std::vector<glm::mat4> locals(settings.mesh_count);
+	ServiceLocator::getInstance().getThreadPool().parallelFor(
+		settings.mesh_count,
+		[&settings, &scene, &materials, &meshes, &locals](std::size_t i) {
+			Random random{getSeed(settings.seed, MeshStream, i)};
+			std::vector<Texture> textures;
+			if (!scene.textures.empty()) {
+				textures.push_back({"texture_diffuse", scene.textures[i % scene.textures.size()].path});
+			}
+			meshes[i] = generateMesh(settings.triangles_per_mesh, materials[i % materials.size()], std::move(textures), random);
+
+			const float half_extent{settings.extent * 0.5f};
+			const glm::vec3 position{random.uniform(-half_extent, half_extent), 0.0f, random.uniform(-half_extent, half_extent)};
+			const float yaw{random.uniform(0.0f, 2.0f * glm::pi<float>())};
+			const float scale{random.uniform(MIN_MESH_SCALE, MAX_MESH_SCALE)};
+			glm::mat4 local{glm::translate(glm::mat4(1.0f), position)};
+			local = glm::rotate(local, yaw, glm::vec3(0.0f, 1.0f, 0.0f));
+			locals[i] = glm::scale(local, glm::vec3(scale));
+		}
+	);
+
+	TransformHierarchy transforms;
+	const std::uint32_t root{transforms.addNode(TransformHierarchy::NO_PARENT, glm::mat4(1.0f))};
+	std::vector<std::uint32_t> mesh_nodes;
+	mesh_nodes.reserve(settings.mesh_count);
+	for (const glm::mat4& local : locals) {
+		mesh_nodes.push_back(transforms.addNode(root, local));
+	}
+
+	std::vector<Light> lights;
+	lights.reserve(settings.light_count);
+	for (std::size_t i{0u}; i < settings.light_count; ++i) {
+		Random random{getSeed(settings.seed, LightStream, i)};
+		const float half_extent{settings.extent * 0.5f};
+		Light light;
+		light.position = glm::vec3(
+			random.uniform(-half_extent, half_extent),
+			random.uniform(10.0f, 30.0f),
+			random.uniform(-half_extent, half_extent)
+		);
+		light.color_diffuse = random.color(0.5f, 1.0f);
+		light.color_ambient = light.color_diffuse * 0.05f;
+		light.color_specular = light.color_diffuse;
+		lights.push_back(light);
+	}
+
+	scene.model = std::make_shared<Model>(std::move(meshes), std::move(mesh_nodes), std::move(transforms), std::move(lights));
+
+	// Copies of the model on a square grid, far enough apart not to overlap
+	const std::size_t side{static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(settings.instance_count))))};
+	const float spacing{settings.extent + MAX_MESH_SCALE};
+	const float grid_offset{(static_cast<float>(side) - 1.0f) * spacing * 0.5f};
+	scene.instances.reserve(settings.instance_count);
+	for (std::size_t i{0u}; i < settings.instance_count; ++i) {
+		const glm::vec3 position{
+			static_cast<float>(i % side) * spacing - grid_offset,
+			0.0f,
+			static_cast<float>(i / side) * spacing - grid_offset
+		};
+		scene.instances.push_back(glm::translate(glm::mat4(1.0f), position));
+	}
+
+	return scene;
+}
+
+void scene_generator::writeTextures(const GeneratedScene& scene) {
+	for (const GeneratedTexture& texture : scene.textures) {
+		fs::create_directories(fs::path(texture.path).parent_path());
+		writeTga(texture);
+	}
+}
+
+std::string scene_generator::write(const GeneratedScene& scene, const SceneGeneratorSettings& settings) {
+	const fs::path directory{settings.directory};
+	fs::create_directories(directory);
+	writeTextures(scene);
+
+	const Model& model{*scene.model};
+	TransformHierarchy transforms{model.transforms_};
+	transforms.update();
+
+	// Material library, one material per combination of a material, and a texture
+	const std::string library_name{settings.name + ".mtl"};
+	{
+		std::ofstream library{openOutput((directory / library_name).string())};
+		std::vector<std::string> written_names;
+		for (std::size_t i{0u}; i < model.meshes_.size(); ++i) {
+			const Mesh& mesh{*model.meshes_[i]};
+			const std::string name{getMaterialName(i % std::max<std::size_t>(1u, settings.material_count), mesh)};
+			if (std::find(written_names.begin(), written_names.end(), name) != written_names.end()) {
+				continue;
+			}
+			written_names.push_back(name);
+
+			std::string text{"newmtl " + name + "\n"};
+			const Material& material{mesh.material_};
+			appendFormat(text, "Ka %.6g %.6g %.6g\n", material.color_ambient.x, material.color_ambient.y, material.color_ambient.z);
+			appendFormat(text, "Kd %.6g %.6g %.6g\n", material.color_diffuse.x, material.color_diffuse.y, material.color_diffuse.z);
+			appendFormat(text, "Ks %.6g %.6g %.6g\n", material.color_specular.x, material.color_specular.y, material.color_specular.z);
+			appendFormat(text, "Ns %.6g\n", material.shininess);
+			for (const Texture& texture : mesh.textures_) {
+				text += (texture.type == "texture_specular" ? "map_Ks " : "map_Kd ") + texture.path + "\n";
+			}
+			library << text << "\n";
+		}
+		if (!library) {
+			throw std::runtime_error("cannot write a material library: " + library_name);
+		}
+	}
+
+	// The model, with the node transforms applied, as OBJ has no hierarchy
+	const std::string model_path{(directory / (settings.name + ".obj")).generic_string()};
+	{
+		std::ofstream file{openOutput(model_path)};
+		file << "# Generated scene, seed " << settings.seed << "\nmtllib " << library_name << "\n";
+
+		std::string text;
+		std::size_t vertex_offset{1u};
+		for (std::size_t i{0u}; i < model.meshes_.size(); ++i) {
+			const Mesh& mesh{*model.meshes_[i]};
+			const glm::mat4& world{transforms.getWorld(model.mesh_nodes_[i])};
+			const glm::mat3 normal_matrix{glm::transpose(glm::inverse(glm::mat3(world)))};
+
+			text.clear();
+			text += "o mesh-" + std::to_string(i) + "\n";
+			for (const Vertex& vertex : mesh.vertices_) {
+				const glm::vec3 position{world * glm::vec4(vertex.position, 1.0f)};
+				appendFormat(text, "v %.6g %.6g %.6g\n", position.x, position.y, position.z);
+			}
+			for (const Vertex& vertex : mesh.vertices_) {
+				// Loaders flip the texture coordinates
+				appendFormat(text, "vt %.6g %.6g\n", vertex.tex_coords.x, 1.0f - vertex.tex_coords.y);
+			}
+			for (const Vertex& vertex : mesh.vertices_) {
+				const glm::vec3 normal{glm::normalize(normal_matrix * vertex.normal)};
+				appendFormat(text, "vn %.6g %.6g %.6g\n", normal.x, normal.y, normal.z);
+			}
+			text += "usemtl " + getMaterialName(i % std::max<std::size_t>(1u, settings.material_count), mesh) + "\n";
+			for (std::size_t j{0u}; j + 2u < mesh.indices_.size(); j += 3u) {
+				text += "f";
+				for (std::size_t k{0u}; k < 3u; ++k) {
+					const std::string index{std::to_string(vertex_offset + mesh.indices_[j + k])};
+					text += " " + index + "/" + index + "/" + index;
+				}
+				text += "\n";
+			}
+			vertex_offset += mesh.vertices_.size();
+			file << text;
+		}
+		if (!file) {
+			throw std::runtime_error("cannot write a model: " + model_path);
+		}
+	}
+
+	{
+		std::ofstream file{openOutput(getInstancesPath(model_path))};
+		file << "# One column-major transform per instance\n";
+		std::string text;
+		for (const glm::mat4& instance : scene.instances) {
+			text = "instance";
+			for (int column{0}; column < 4; ++column) {
+				appendFormat(text, " %.9g %.9g %.9g", instance[column][0], instance[column][1], instance[column][2]);
+				appendFormat(text, " %.9g", instance[column][3]);
+			}
+			file << text << "\n";
+		}
+		if (!file) {
+			throw std::runtime_error("cannot write an instance list: " + getInstancesPath(model_path));
+		}
+	}
+
+	return model_path;
+}
+
+std::string scene_generator::getInstancesPath(const std::string& model_path) {
+	return fs::path(model_path).replace_extension(INSTANCES_EXTENSION).generic_string();
+}
+
+std::vector<glm::mat4> scene_generator::loadInstances(const std::string& path) {
+	AssetFile list_file;
+	try {
+		list_file = ServiceLocator::getInstance().getFileSystem().open(path);
+	} catch (const std::runtime_error&) {
+		throw std::runtime_error("cannot open an instance list: " + path);
+	}
+	std::istringstream file{std::string(list_file.getText())};
+
+	std::vector<glm::mat4> instances;
+	std::string line;
+	std::size_t line_number{0u};
+	while (std::getline(file, line)) {
+		++line_number;
+		line = line.substr(0u, line.find('#'));
+		std::istringstream entry{line};
+		std::string keyword;
+		if (!(entry >> keyword)) {
+			continue;
+		}
+		if (keyword != "instance") {
+			throw std::runtime_error("unknown entry in an instance list: " + path + ":" + std::to_string(line_number));
+		}
+		glm::mat4 instance;
+		for (int column{0}; column < 4; ++column) {
+			for (int row{0}; row < 4; ++row) {
+				if (!(entry >> instance[column][row])) {
+					throw std::runtime_error("invalid instance in an instance list: " + path + ":" + std::to_string(line_number));
+				}
+			}
+		}
+		instances.push_back(instance);
+	}
+	return instances;
+}
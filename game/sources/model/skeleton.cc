@@ -0,0 +1,97 @@
+#include "game/headers/model/skeleton.hh"
+
+#include "external/glm/glm/geometric.hpp"
+
+#include <cmath>
+
+glm::mat4 JointTransform::toMatrix() const {
+	const float x{rotation.x};
+	const float y{rotation.y};
+	const float z{rotation.z};
+	const float w{rotation.w};
+
+	// Rotation matrix columns of the unit quaternion, scaled per axis
+	glm::mat4 matrix(1.0f);
+	matrix[0] = glm::vec4(1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y + z * w), 2.0f * (x * z - y * w), 0.0f) * scale.x;
+	matrix[1] = glm::vec4(2.0f * (x * y - z * w), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z + x * w), 0.0f) * scale.y;
+	matrix[2] = glm::vec4(2.0f * (x * z + y * w), 2.0f * (y * z - x * w), 1.0f - 2.0f * (x * x + y * y), 0.0f) * scale.z;
+	matrix[3] = glm::vec4(translation, 1.0f);
+	return matrix;
+}
+
+JointTransform JointTransform::fromMatrix(const glm::mat4& matrix) {
+	JointTransform transform;
+	transform.translation = glm::vec3(matrix[3]);
+
+	glm::vec3 axes[3]{glm::vec3(matrix[0]), glm::vec3(matrix[1]), glm::vec3(matrix[2])};
+	transform.scale = glm::vec3(glm::length(axes[0]), glm::length(axes[1]), glm::length(axes[2]));
+	// A mirroring transform keeps its reflection in the scale
+	if (glm::dot(glm::cross(axes[0], axes[1]), axes[2]) < 0.0f) {
+		transform.scale.x = -transform.scale.x;
+	}
+	for (int i{0}; i < 3; ++i) {
+		if (transform.scale[i] != 0.0f) {
+			axes[i] /= transform.scale[i];
+		}
+	}
+
+	// Shepperd's method, from the largest of the diagonal, and the trace, for stability
+	const float m00{axes[0].x};
+	const float m11{axes[1].y};
+	const float m22{axes[2].z};
+	const float trace{m00 + m11 + m22};
+	glm::vec4 q;
+	if (trace > 0.0f) {
+		const float s{2.0f * std::sqrt(1.0f + trace)};
+		q = glm::vec4((axes[1].z - axes[2].y) / s, (axes[2].x - axes[0].z) / s, (axes[0].y - axes[1].x) / s, 0.25f * s);
+	} else if (m00 > m11 && m00 > m22) {
+		const float s{2.0f * std::sqrt(1.0f + m00 - m11 - m22)};
+		q = glm::vec4(0.25f * s, (axes[1].x + axes[0].y) / s, (axes[2].x + axes[0].z) / s, (axes[1].z - axes[2].y) / s);
+	} else if (m11 > m22) {
+		const float s{2.0f * std::sqrt(1.0f + m11 - m00 - m22)};
+		q = glm::vec4((axes[1].x + axes[0].y) / s, 0.25f * s, (axes[2].y + axes[1].z) / s, (axes[2].x - axes[0].z) / s);
+	} else {
+		const float s{2.0f * std::sqrt(1.0f + m22 - m00 - m11)};
+		q = glm::vec4((axes[2].x + axes[0].z) / s, (axes[2].y + axes[1].z) / s, 0.25f * s, (axes[0].y - axes[1].x) / s);
+	}
+	transform.rotation = glm::normalize(q);
+	return transform;
+}
+
+std::size_t Skeleton::getJointCount() const {
+	return parents.size();
+}
+
+bool Skeleton::isEmpty() const {
+	return parents.empty();
+}
+
+std::uint32_t Skeleton::findJoint(const std::string& name) const {
+	for (std::size_t i{0u}; i < joint_names.size(); ++i) {
+		if (joint_names[i] == name) {
+			return static_cast<std::uint32_t>(i);
+		}
+	}
+	return NO_JOINT;
+}
+
+std::size_t Skeleton::getMemorySize() const {
+	std::size_t name_bytes{joint_names.capacity() * sizeof(std::string)};
+	for (const std::string& name : joint_names) {
+		name_bytes += name.capacity();
+	}
+	return name_bytes
+		+ parents.capacity() * sizeof(std::uint32_t)
+		+ bind_pose.capacity() * sizeof(JointTransform)
+		+ inverse_binds.capacity() * sizeof(glm::mat4);
+}
+
+const float* AnimationClip::getChannel(std::size_t frame, JointChannel channel) const {
+	const std::size_t padded_joint_count{getPaddedJointCount(joint_count)};
+	return samples.data() + (frame * JOINT_CHANNEL_COUNT + static_cast<std::size_t>(channel)) * padded_joint_count;
+}
+
+float* AnimationClip::getChannel(std::size_t frame, JointChannel channel) {
+	const std::size_t padded_joint_count{getPaddedJointCount(joint_count)};
+	return samples.data() + (frame * JOINT_CHANNEL_COUNT + static_cast<std::size_t>(channel)) * padded_joint_count;
+}
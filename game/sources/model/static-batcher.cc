@@ -0,0 +1,189 @@
+#include "game/headers/model/static-batcher.hh"
+
+#include "external/glm/glm/geometric.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+	// A mesh of the model, and the transform of its node
+	struct BatchPart {
+		std::size_t mesh_index;
+		glm::mat4 transform;
+	};
+
+	bool isBatchable(const Mesh& mesh) {
+		return !mesh.isSkinned() && mesh.isGeometryResident();
+	}
+
+	// Meshes with the same key are drawn with the same state
+	std::string getBatchKey(const Mesh& mesh) {
+		std::string key(reinterpret_cast<const char*>(&mesh.material_), sizeof(Material));
+		for (const Texture& texture : mesh.textures_) {
+			key += texture.type;
+			key += '\0';
+			key += texture.path;
+			key += '\0';
+		}
+		return key;
+	}
+
+	// A mesh with fewer levels of detail than its batch contributes its coarsest level to the rest
+	const std::vector<std::uint32_t>& getLevelIndices(const Mesh& mesh, std::size_t level) {
+		if (level == 0u || mesh.lods_.empty()) {
+			return mesh.indices_;
+		}
+		return mesh.lods_[std::min(level, mesh.lods_.size()) - 1u].indices;
+	}
+
+	float getLevelError(const Mesh& mesh, std::size_t level) {
+		if (level == 0u || mesh.lods_.empty()) {
+			return 0.0f;
+		}
+		return mesh.lods_[std::min(level, mesh.lods_.size()) - 1u].error;
+	}
+
+	float getMaxScale(const glm::mat4& transform) {
+		return std::max({
+			glm::length(glm::vec3(transform[0])),
+			glm::length(glm::vec3(transform[1])),
+			glm::length(glm::vec3(transform[2]))
+		});
+	}
+
+	// A mirroring transform turns the triangles around, so their winding is reversed to keep them facing out
+	IndexRange appendIndices(
+		const std::vector<std::uint32_t>& source,
+		std::uint32_t base_vertex,
+		bool is_mirrored,
+		std::vector<std::uint32_t>& indices
+	) {
+		const IndexRange range{static_cast<std::uint32_t>(indices.size()), static_cast<std::uint32_t>(source.size())};
+		for (std::size_t i{0u}; i + 2u < source.size(); i += 3u) {
+			indices.push_back(base_vertex + source[i]);
+			indices.push_back(base_vertex + source[is_mirrored ? i + 2u : i + 1u]);
+			indices.push_back(base_vertex + source[is_mirrored ? i + 1u : i + 2u]);
+		}
+		return range;
+	}
+
+	/**
+	 * Appends the parts' vertices, moved into the batch's space, and their triangles, level of detail by level.
+	 * The parts were optimized for the vertex cache one by one, their triangles stay in the same order.
+	 */
+	std::shared_ptr<Mesh> mergeMeshes(const Model& model, const std::vector<BatchPart>& parts) {
+		std::size_t vertex_count{0u};
+		std::size_t level_count{1u};
+		bool is_collision_source{false};
+		for (const BatchPart& part : parts) {
+			const Mesh& mesh{*model.meshes_[part.mesh_index]};
+			vertex_count += mesh.vertices_.size();
+			level_count = std::max(level_count, mesh.lods_.size() + 1u);
+			is_collision_source = is_collision_source || mesh.is_collision_source_;
+		}
+
+		std::vector<Vertex> vertices;
+		vertices.reserve(vertex_count);
+		std::vector<std::uint32_t> indices;
+		std::vector<MeshLod> lods(level_count - 1u, MeshLod{{}, 0.0f});
+		std::vector<Submesh> submeshes(parts.size());
+		for (std::size_t i{0u}; i < parts.size(); ++i) {
+			const Mesh& mesh{*model.meshes_[parts[i].mesh_index]};
+			const glm::mat4& transform{parts[i].transform};
+			const glm::mat3 normal_transform{glm::transpose(glm::inverse(glm::mat3(transform)))};
+			const bool is_mirrored{glm::determinant(glm::mat3(transform)) < 0.0f};
+			const float scale{getMaxScale(transform)};
+
+			const std::uint32_t base_vertex{static_cast<std::uint32_t>(vertices.size())};
+			Submesh& submesh{submeshes[i]};
+			submesh.bounds = {glm::vec3(std::numeric_limits<float>::max()), glm::vec3(std::numeric_limits<float>::lowest())};
+			for (const Vertex& vertex : mesh.vertices_) {
+				const glm::vec3 position{transform * glm::vec4(vertex.position, 1.0f)};
+				vertices.push_back({position, glm::normalize(normal_transform * vertex.normal), vertex.tex_coords});
+				submesh.bounds.min = glm::min(submesh.bounds.min, position);
+				submesh.bounds.max = glm::max(submesh.bounds.max, position);
+			}
+
+			submesh.levels.reserve(level_count);
+			for (std::size_t level{0u}; level < level_count; ++level) {
+				std::vector<std::uint32_t>& level_indices{level == 0u ? indices : lods[level - 1u].indices};
+				submesh.levels.push_back(appendIndices(getLevelIndices(mesh, level), base_vertex, is_mirrored, level_indices));
+				if (level > 0u) {
+					lods[level - 1u].error = std::max(lods[level - 1u].error, getLevelError(mesh, level) * scale);
+				}
+			}
+		}
+
+		const Mesh& first_mesh{*model.meshes_[parts.front().mesh_index]};
+		std::shared_ptr<Mesh> batch{
+			std::make_shared<Mesh>(
+				std::move(vertices),
+				std::move(indices),
+				std::vector<Texture>(first_mesh.textures_),
+				first_mesh.material_,
+				std::move(lods)
+			)
+		};
+		batch->submeshes_ = std::move(submeshes);
+		batch->is_collision_source_ = is_collision_source;
+		batch->updateMemoryRecord();
+		return batch;
+	}
+
+} // namespace
+
+std::shared_ptr<Model> static_batcher::batch(const Model& model, StaticBatchReport& report) {
+	TransformHierarchy transforms{model.transforms_};
+	transforms.update();
+
+	// Batches in the order of their first mesh, so the same model is always batched the same way
+	std::vector<std::shared_ptr<Mesh>> meshes;
+	std::vector<std::uint32_t> mesh_nodes;
+	std::vector<std::vector<BatchPart>> batches;
+	std::unordered_map<std::string, std::size_t> batch_indices;
+	for (std::size_t i{0u}; i < model.meshes_.size(); ++i) {
+		const Mesh& mesh{*model.meshes_[i]};
+		if (!isBatchable(mesh)) {
+			meshes.push_back(model.meshes_[i]);
+			mesh_nodes.push_back(model.mesh_nodes_[i]);
+			continue;
+		}
+		const auto [entry, is_new]{batch_indices.try_emplace(getBatchKey(mesh), batches.size())};
+		if (is_new) {
+			batches.emplace_back();
+		}
+		batches[entry->second].push_back({i, transforms.getWorld(model.mesh_nodes_[i])});
+	}
+
+	report = {model.meshes_.size(), 0u, 0u};
+	std::uint32_t batch_node{TransformHierarchy::NO_PARENT};
+	for (const std::vector<BatchPart>& parts : batches) {
+		// A single mesh gains nothing, it keeps its node
+		if (parts.size() == 1u) {
+			meshes.push_back(model.meshes_[parts.front().mesh_index]);
+			mesh_nodes.push_back(model.mesh_nodes_[parts.front().mesh_index]);
+			continue;
+		}
+		if (batch_node == TransformHierarchy::NO_PARENT) {
+			batch_node = transforms.addNode(TransformHierarchy::NO_PARENT, glm::mat4(1.0f));
+		}
+		meshes.push_back(mergeMeshes(model, parts));
+		mesh_nodes.push_back(batch_node);
+		report.merged_mesh_count += parts.size();
+	}
+	report.batched_mesh_count = meshes.size();
+
+	return std::make_shared<Model>(
+		std::move(meshes),
+		std::move(mesh_nodes),
+		std::move(transforms),
+		std::vector<Light>(model.lights_),
+		Skeleton(model.skeleton_),
+		std::vector<CompressedAnimationClip>(model.animations_)
+	);
+}
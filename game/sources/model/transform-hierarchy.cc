@@ -0,0 +1,87 @@
+#include "game/headers/model/transform-hierarchy.hh"
+
+#include <algorithm>
+#include <stdexcept>
+
+TransformHierarchy::TransformHierarchy(std::vector<std::uint32_t>&& parents, std::vector<glm::mat4>&& locals):
+		parents_{std::move(parents)},
+		locals_{std::move(locals)},
+		worlds_(locals_.size(), glm::mat4(1.0f)),
+		is_dirty_(locals_.size(), 1u) {
+	if (parents_.size() != locals_.size()) {
+		throw std::invalid_argument("every node needs a parent, and a local transform");
+	}
+	for (std::size_t node{0u}; node < parents_.size(); ++node) {
+		if (parents_[node] != NO_PARENT && parents_[node] >= node) {
+			throw std::invalid_argument("a node's parent must precede it");
+		}
+	}
+	update();
+}
+
+std::uint32_t TransformHierarchy::addNode(std::uint32_t parent, const glm::mat4& local) {
+	const std::uint32_t node{static_cast<std::uint32_t>(parents_.size())};
+	if (parent != NO_PARENT && parent >= node) {
+		throw std::invalid_argument("a node's parent must be added before the node");
+	}
+
+	parents_.push_back(parent);
+	locals_.push_back(local);
+	worlds_.push_back(parent == NO_PARENT ? local : worlds_[parent] * local);
+	is_dirty_.push_back(0u);
+	return node;
+}
+
+std::size_t TransformHierarchy::getNodeCount() const {
+	return parents_.size();
+}
+
+std::uint32_t TransformHierarchy::getParent(std::uint32_t node) const {
+	return parents_[node];
+}
+
+const glm::mat4& TransformHierarchy::getLocal(std::uint32_t node) const {
+	return locals_[node];
+}
+
+void TransformHierarchy::setLocal(std::uint32_t node, const glm::mat4& local) {
+	locals_[node] = local;
+	is_dirty_[node] = 1u;
+	first_dirty_node_ = std::min<std::size_t>(first_dirty_node_, node);
+}
+
+const glm::mat4& TransformHierarchy::getWorld(std::uint32_t node) const {
+	return worlds_[node];
+}
+
+bool TransformHierarchy::update() {
+	const std::size_t node_count{parents_.size()};
+	if (first_dirty_node_ >= node_count) {
+		return false;
+	}
+
+	// Parents precede their children, so a parent's dirty flag and world matrix are final when its children are visited
+	bool has_changed{false};
+	for (std::size_t node{first_dirty_node_}; node < node_count; ++node) {
+		const std::uint32_t parent{parents_[node]};
+		if (parent != NO_PARENT && is_dirty_[parent]) {
+			is_dirty_[node] = 1u;
+		}
+		if (is_dirty_[node]) {
+			worlds_[node] = parent == NO_PARENT ? locals_[node] : worlds_[parent] * locals_[node];
+			has_changed = true;
+		}
+	}
+
+	std::fill(is_dirty_.begin() + first_dirty_node_, is_dirty_.end(), 0u);
+	first_dirty_node_ = node_count;
+	return has_changed;
+}
+
+const std::vector<std::uint32_t>& TransformHierarchy::getParents() const {
+	return parents_;
+}
+
+const std::vector<glm::mat4>& TransformHierarchy::getLocals() const {
+	return locals_;
+}
@@ -0,0 +1,244 @@
+#include "game/headers/model/vertex-compression.hh"
+
+#include "external/glm/glm/geometric.hpp"
+#include "external/glm/glm/ext/scalar_constants.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+	constexpr float UNORM16_MAX{65535.0f};
+	constexpr float SNORM16_MAX{32767.0f};
+
+	std::int16_t toSnorm16(float value) {
+		return static_cast<std::int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * SNORM16_MAX));
+	}
+
+	float fromSnorm16(std::int16_t value) {
+		return std::max(static_cast<float>(value) / SNORM16_MAX, -1.0f);
+	}
+
+	std::uint16_t toUnorm16(float value) {
+		return static_cast<std::uint16_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * UNORM16_MAX));
+	}
+
+	glm::vec3 getQuantizationScale(const BoundingBox& bounds) {
+		return bounds.max - bounds.min;
+	}
+
+	template <typename EncodedVertex>
+	void encodeAttributes(const Vertex& vertex, EncodedVertex& encoded) {
+		vertex_compression::encodeOctahedral(vertex.normal, encoded.normal);
+		encoded.tex_coords[0] = vertex_compression::floatToHalf(vertex.tex_coords.x);
+		encoded.tex_coords[1] = vertex_compression::floatToHalf(vertex.tex_coords.y);
+	}
+
+	QuantizedVertex quantize(const Vertex& vertex, const BoundingBox& bounds) {
+		const glm::vec3 scale{getQuantizationScale(bounds)};
+		QuantizedVertex encoded;
+		for (int i{0}; i < 3; ++i) {
+			const float relative{scale[i] > 0.0f ? (vertex.position[i] - bounds.min[i]) / scale[i] : 0.0f};
+			encoded.position[i] = toUnorm16(relative);
+		}
+		encoded.position[3] = 0;
+		encodeAttributes(vertex, encoded);
+		return encoded;
+	}
+
+	CompactVertex compact(const Vertex& vertex) {
+		CompactVertex encoded;
+		encoded.position[0] = vertex.position.x;
+		encoded.position[1] = vertex.position.y;
+		encoded.position[2] = vertex.position.z;
+		encodeAttributes(vertex, encoded);
+		return encoded;
+	}
+
+	template <typename EncodedVertex>
+	void appendVertex(std::vector<unsigned char>& data, const EncodedVertex& vertex) {
+		const unsigned char* bytes{reinterpret_cast<const unsigned char*>(&vertex)};
+		data.insert(data.end(), bytes, bytes + sizeof(EncodedVertex));
+	}
+
+} // namespace
+
+EncodedVertices vertex_compression::encode(const Mesh& mesh, VertexFormat format) {
+	EncodedVertices encoded;
+	encoded.position_scale = glm::vec3(1.0f);
+	encoded.position_offset = glm::vec3(0.0f);
+
+	switch (format) {
+		case VertexFormat::Full: {
+			encoded.stride = sizeof(Vertex);
+			const unsigned char* bytes{reinterpret_cast<const unsigned char*>(mesh.vertices_.data())};
+			encoded.data.assign(bytes, bytes + mesh.vertices_.size() * sizeof(Vertex));
+			break;
+		}
+		case VertexFormat::Compact: {
+			encoded.stride = sizeof(CompactVertex);
+			encoded.data.reserve(mesh.vertices_.size() * sizeof(CompactVertex));
+			for (const Vertex& vertex : mesh.vertices_) {
+				appendVertex(encoded.data, compact(vertex));
+			}
+			break;
+		}
+		case VertexFormat::CompactQuantized: {
+			encoded.stride = sizeof(QuantizedVertex);
+			encoded.position_scale = getQuantizationScale(mesh.bounds_);
+			encoded.position_offset = mesh.bounds_.min;
+			encoded.data.reserve(mesh.vertices_.size() * sizeof(QuantizedVertex));
+			for (const Vertex& vertex : mesh.vertices_) {
+				appendVertex(encoded.data, quantize(vertex, mesh.bounds_));
+			}
+			break;
+		}
+	}
+	return encoded;
+}
+
+QuantizationError vertex_compression::measureError(const Mesh& mesh, VertexFormat format) {
+	QuantizationError error{0.0f, 0.0f, 0.0f};
+	if (format == VertexFormat::Full) {
+		return error;
+	}
+
+	const glm::vec3 scale{getQuantizationScale(mesh.bounds_)};
+	for (const Vertex& vertex : mesh.vertices_) {
+		glm::vec3 position{vertex.position};
+		std::int16_t normal[2];
+		std::uint16_t tex_coords[2];
+		if (format == VertexFormat::CompactQuantized) {
+			const QuantizedVertex encoded{quantize(vertex, mesh.bounds_)};
+			for (int i{0}; i < 3; ++i) {
+				position[i] = encoded.position[i] / UNORM16_MAX * scale[i] + mesh.bounds_.min[i];
+			}
+			std::memcpy(normal, encoded.normal, sizeof(normal));
+			std::memcpy(tex_coords, encoded.tex_coords, sizeof(tex_coords));
+		} else {
+			const CompactVertex encoded{compact(vertex)};
+			std::memcpy(normal, encoded.normal, sizeof(normal));
+			std::memcpy(tex_coords, encoded.tex_coords, sizeof(tex_coords));
+		}
+
+		error.max_position_error = std::max(error.max_position_error, glm::length(position - vertex.position));
+
+		if (glm::length(vertex.normal) > 0.0f) {
+			const glm::vec3 decoded_normal{decodeOctahedral(normal)};
+			const glm::vec3 original_normal{glm::normalize(vertex.normal)};
+			// atan2 stays precise for the tiny angles acos cannot resolve in single precision
+			const float radians{std::atan2(
+				glm::length(glm::cross(decoded_normal, original_normal)),
+				glm::dot(decoded_normal, original_normal)
+			)};
+			const float degrees{radians * 180.0f / glm::pi<float>()};
+			error.max_normal_error = std::max(error.max_normal_error, degrees);
+		}
+
+		const glm::vec2 decoded_tex_coords{halfToFloat(tex_coords[0]), halfToFloat(tex_coords[1])};
+		error.max_tex_coords_error = std::max(
+			error.max_tex_coords_error,
+			glm::length(decoded_tex_coords - vertex.tex_coords)
+		);
+	}
+	return error;
+}
+
+std::uint16_t vertex_compression::floatToHalf(float value) {
+	std::uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+
+	const std::uint32_t sign{(bits >> 16) & 0x8000u};
+	const std::int32_t exponent{static_cast<std::int32_t>((bits >> 23) & 0xffu) - 127 + 15};
+	std::uint32_t mantissa{bits & 0x7fffffu};
+
+	if (((bits >> 23) & 0xffu) == 0xffu) {
+		// Infinity, or NaN
+		return static_cast<std::uint16_t>(sign | 0x7c00u | (mantissa != 0 ? 0x200u : 0u));
+	}
+	if (exponent >= 31) {
+		// Too large, clamped to infinity
+		return static_cast<std::uint16_t>(sign | 0x7c00u);
+	}
+	if (exponent <= 0) {
+		if (exponent < -10) {
+			// Too small, flushed to zero
+			return static_cast<std::uint16_t>(sign);
+		}
+		// Subnormal half, rounded to nearest
+		mantissa |= 0x800000u;
+		const int shift{14 - exponent};
+		std::uint32_t half_mantissa{mantissa >> shift};
+		if ((mantissa >> (shift - 1)) & 1u) {
+			++half_mantissa;
+		}
+		return static_cast<std::uint16_t>(sign | half_mantissa);
+	}
+
+	// Normal half, rounded to nearest; a carry correctly increments the exponent
+	std::uint32_t half{sign | (static_cast<std::uint32_t>(exponent) << 10) | (mantissa >> 13)};
+	if (mantissa & 0x1000u) {
+		++half;
+	}
+	return static_cast<std::uint16_t>(half);
+}
+
+float vertex_compression::halfToFloat(std::uint16_t value) {
+	const std::uint32_t sign{static_cast<std::uint32_t>(value & 0x8000u) << 16};
+	std::uint32_t exponent{(value >> 10) & 0x1fu};
+	std::uint32_t mantissa{value & 0x3ffu};
+
+	std::uint32_t bits;
+	if (exponent == 0) {
+		if (mantissa == 0) {
+			bits = sign;
+		} else {
+			// Subnormal half, normalized for the float
+			exponent = 127 - 15 + 1;
+			while ((mantissa & 0x400u) == 0) {
+				mantissa <<= 1;
+				--exponent;
+			}
+			mantissa &= 0x3ffu;
+			bits = sign | (exponent << 23) | (mantissa << 13);
+		}
+	} else if (exponent == 31) {
+		bits = sign | 0x7f800000u | (mantissa << 13);
+	} else {
+		bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+	}
+
+	float result;
+	std::memcpy(&result, &bits, sizeof(result));
+	return result;
+}
+
+void vertex_compression::encodeOctahedral(glm::vec3 normal, std::int16_t encoded[2]) {
+	const float length{std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z)};
+	if (length == 0.0f) {
+		encoded[0] = 0;
+		encoded[1] = 0;
+		return;
+	}
+	float x{normal.x / length};
+	float y{normal.y / length};
+	if (normal.z < 0.0f) {
+		// Folding the lower hemisphere over the diagonals
+		const float folded_x{(1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f)};
+		const float folded_y{(1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f)};
+		x = folded_x;
+		y = folded_y;
+	}
+	encoded[0] = toSnorm16(x);
+	encoded[1] = toSnorm16(y);
+}
+
+glm::vec3 vertex_compression::decodeOctahedral(const std::int16_t encoded[2]) {
+	glm::vec3 normal{fromSnorm16(encoded[0]), fromSnorm16(encoded[1]), 0.0f};
+	normal.z = 1.0f - std::fabs(normal.x) - std::fabs(normal.y);
+	const float t{std::max(-normal.z, 0.0f)};
+	normal.x += normal.x >= 0.0f ? -t : t;
+	normal.y += normal.y >= 0.0f ? -t : t;
+	return glm::normalize(normal);
+}
@@ -0,0 +1,36 @@
+#include "game/headers/model/vertex-deduplicator.hh"
+
+#include "game/headers/utility/hash.hh"
+
+#include <cstring>
+#include <utility>
+
+VertexDeduplicator::VertexDeduplicator(std::size_t expected_vertex_count) {
+	index_map_.reserve(expected_vertex_count);
+	vertices_.reserve(expected_vertex_count);
+}
+
+std::uint32_t VertexDeduplicator::add(const Vertex& vertex) {
+	const std::uint32_t next_index{static_cast<std::uint32_t>(vertices_.size())};
+	const auto [it, inserted]{index_map_.emplace(vertex, next_index)};
+	if (inserted) {
+		vertices_.push_back(vertex);
+	}
+	return it->second;
+}
+
+std::vector<Vertex> VertexDeduplicator::takeVertices() {
+	index_map_.clear();
+	return std::move(vertices_);
+}
+
+std::size_t VertexDeduplicator::VertexHash::operator()(const Vertex& vertex) const {
+	static_assert(sizeof(Vertex) == 8 * sizeof(float), "Vertex must not contain padding");
+
+	const std::uint64_t hash{hash_aux::fnv1a(&vertex, sizeof(Vertex))};
+	return static_cast<std::size_t>(hash);
+}
+
+bool VertexDeduplicator::VertexEqual::operator()(const Vertex& first, const Vertex& second) const {
+	return std::memcmp(&first, &second, sizeof(Vertex)) == 0;
+}
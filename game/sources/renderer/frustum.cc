@@ -0,0 +1,146 @@
+#include "game/headers/renderer/frustum.hh"
+
+#include "game/headers/utility/simd.hh"
+
+#include "external/glm/glm/geometric.hpp"
+
+#include <cmath>
+#include <limits>
+
+namespace {
+
+	constexpr float PADDING_BOX_DISTANCE{1e30f};
+
+	// Pads the arrays to whole SIMD vectors before a volume is added past their end
+	template <typename... Arrays>
+	void reserveVolume(std::size_t count, std::vector<std::uint8_t>& visible, float padding, Arrays&... arrays) {
+		if (count < visible.size()) {
+			return;
+		}
+		const std::size_t size{count + simd::MAX_LANE_COUNT};
+		visible.resize(size, 0u);
+		(arrays.resize(size, padding), ...);
+	}
+
+	// Writes which lanes of the step are inside, from their outside mask
+	void storeVisible(simd::Floats outside, std::uint8_t* visible) {
+		const int outside_bits{simd::getMaskBits(outside)};
+		for (std::size_t lane{0u}; lane < simd::LANE_COUNT; ++lane) {
+			visible[lane] = static_cast<std::uint8_t>(((outside_bits >> lane) & 1) == 0);
+		}
+	}
+
+} // namespace
+
+void CullingSpheres::clear() {
+	center_x.clear();
+	center_y.clear();
+	center_z.clear();
+	radius.clear();
+	visible.clear();
+	count = 0u;
+}
+
+std::size_t CullingSpheres::add(const glm::vec3& center, float sphere_radius) {
+	// Padding spheres are behind every plane, whatever their centers
+	reserveVolume(count, visible, 0.0f, center_x, center_y, center_z);
+	radius.resize(visible.size(), std::numeric_limits<float>::lowest());
+	center_x[count] = center.x;
+	center_y[count] = center.y;
+	center_z[count] = center.z;
+	radius[count] = sphere_radius;
+	return count++;
+}
+
+glm::vec3 CullingSpheres::getCenter(std::size_t index) const {
+	return {center_x[index], center_y[index], center_z[index]};
+}
+
+void CullingBoxes::clear() {
+	center_x.clear();
+	center_y.clear();
+	center_z.clear();
+	extent_x.clear();
+	extent_y.clear();
+	extent_z.clear();
+	visible.clear();
+	count = 0u;
+}
+
+std::size_t CullingBoxes::add(const glm::vec3& center, const glm::vec3& extent) {
+	// Padding boxes have no extent, and are so far away along x that a bounded frustum never reaches them.
+	// Infinity would make the products with planes parallel to x undefined.
+	reserveVolume(count, visible, 0.0f, center_y, center_z, extent_x, extent_y, extent_z);
+	center_x.resize(visible.size(), PADDING_BOX_DISTANCE);
+	center_x[count] = center.x;
+	center_y[count] = center.y;
+	center_z[count] = center.z;
+	extent_x[count] = extent.x;
+	extent_y[count] = extent.y;
+	extent_z[count] = extent.z;
+	return count++;
+}
+
+Frustum::Frustum(const glm::mat4& view_projection) {
+	// Rows of the matrix, a clip space point is inside where -w <= x, y, z <= w
+	glm::vec4 rows[4];
+	for (int row{0}; row < 4; ++row) {
+		rows[row] = {view_projection[0][row], view_projection[1][row], view_projection[2][row], view_projection[3][row]};
+	}
+	planes_ = {
+		rows[3] + rows[0],
+		rows[3] - rows[0],
+		rows[3] + rows[1],
+		rows[3] - rows[1],
+		rows[3] + rows[2],
+		rows[3] - rows[2]
+	};
+	for (glm::vec4& plane : planes_) {
+		plane /= glm::length(glm::vec3(plane));
+	}
+}
+
+void Frustum::cull(CullingSpheres& spheres) const {
+	const simd::Floats zero{simd::broadcast(0.0f)};
+	for (std::size_t i{0u}; i < spheres.count; i += simd::LANE_COUNT) {
+		const simd::Floats x{simd::load(spheres.center_x.data() + i)};
+		const simd::Floats y{simd::load(spheres.center_y.data() + i)};
+		const simd::Floats z{simd::load(spheres.center_z.data() + i)};
+		const simd::Floats radius{simd::load(spheres.radius.data() + i)};
+
+		// Outside once the center is further than the radius behind a plane
+		simd::Floats outside{simd::lessThan(radius, zero)};
+		for (const glm::vec4& plane : planes_) {
+			simd::Floats distance{simd::add(simd::mul(x, simd::broadcast(plane.x)), simd::broadcast(plane.w))};
+			distance = simd::add(distance, simd::mul(y, simd::broadcast(plane.y)));
+			distance = simd::add(distance, simd::mul(z, simd::broadcast(plane.z)));
+			outside = simd::maskOr(outside, simd::lessThan(simd::add(distance, radius), zero));
+		}
+		storeVisible(outside, spheres.visible.data() + i);
+	}
+}
+
+void Frustum::cull(CullingBoxes& boxes) const {
+	const simd::Floats zero{simd::broadcast(0.0f)};
+	for (std::size_t i{0u}; i < boxes.count; i += simd::LANE_COUNT) {
+		const simd::Floats x{simd::load(boxes.center_x.data() + i)};
+		const simd::Floats y{simd::load(boxes.center_y.data() + i)};
+		const simd::Floats z{simd::load(boxes.center_z.data() + i)};
+		const simd::Floats extent_x{simd::load(boxes.extent_x.data() + i)};
+		const simd::Floats extent_y{simd::load(boxes.extent_y.data() + i)};
+		const simd::Floats extent_z{simd::load(boxes.extent_z.data() + i)};
+
+		// Outside once the center is further behind a plane than the box reaches towards it
+		simd::Floats outside{simd::lessThan(zero, zero)};
+		for (const glm::vec4& plane : planes_) {
+			simd::Floats distance{simd::add(simd::mul(x, simd::broadcast(plane.x)), simd::broadcast(plane.w))};
+			distance = simd::add(distance, simd::mul(y, simd::broadcast(plane.y)));
+			distance = simd::add(distance, simd::mul(z, simd::broadcast(plane.z)));
+			simd::Floats reach{simd::mul(extent_x, simd::broadcast(std::fabs(plane.x)))};
+			reach = simd::add(reach, simd::mul(extent_y, simd::broadcast(std::fabs(plane.y))));
+			reach = simd::add(reach, simd::mul(extent_z, simd::broadcast(std::fabs(plane.z))));
+			outside = simd::maskOr(outside, simd::lessThan(simd::add(distance, reach), zero));
+		}
+		storeVisible(outside, boxes.visible.data() + i);
+	}
+}
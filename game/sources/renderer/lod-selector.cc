@@ -0,0 +1,42 @@
+#include "game/headers/renderer/lod-selector.hh"
+
+#include "external/glm/glm/geometric.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+LodSelector::LodSelector(const Camera& camera, const Screen& screen, const RendererSettings& settings):
+		camera_position_{camera.pos},
+		clip_near_{camera.clipNear},
+		pixels_per_unit_{static_cast<float>(screen.height) / (2.0f * std::tan(0.5f * camera.fov))},
+		error_pixels_{settings.lod_error_pixels},
+		hysteresis_{settings.lod_hysteresis} {
+}
+
+std::size_t LodSelector::select(
+	const glm::vec3& center,
+	float radius,
+	const std::vector<float>& level_errors,
+	std::size_t current_level
+) const {
+	if (level_errors.empty()) {
+		return 0u;
+	}
+
+	// Distance to the mesh's bounding sphere, the closest any of its errors can be
+	const float distance{std::max(getDistance(center, radius), clip_near_)};
+	const float pixels_per_unit{pixels_per_unit_ / distance};
+
+	std::size_t level{std::min(current_level, level_errors.size() - 1u)};
+	while (level > 0u && level_errors[level] * pixels_per_unit > error_pixels_) {
+		--level;
+	}
+	while (level + 1u < level_errors.size() && level_errors[level + 1u] * pixels_per_unit <= error_pixels_ * (1.0f - hysteresis_)) {
+		++level;
+	}
+	return level;
+}
+
+float LodSelector::getDistance(const glm::vec3& center, float radius) const {
+	return std::max(glm::length(center - camera_position_) - radius, 0.0f);
+}
@@ -0,0 +1,43 @@
+#include "game/headers/renderer/opengl/opengl-baked-texture.hh"
+
+#include "external/glad/glad.h"
+
+#include <vector>
+
+bool upload_baked_texture(const BakedTexture& baked_texture) {
+	GLenum internal_format;
+	switch (baked_texture.getFormat()) {
+		case BakedTextureFormat::BC1:
+			internal_format = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+			break;
+		case BakedTextureFormat::BC3:
+			internal_format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+			break;
+		case BakedTextureFormat::BC4:
+			internal_format = GL_COMPRESSED_RED_RGTC1;
+			break;
+		default:
+			return false;
+	}
+	// RGTC is core since OpenGL 3.0, S3TC is still an extension
+	if (internal_format != GL_COMPRESSED_RED_RGTC1 && !GLAD_GL_EXT_texture_compression_s3tc) {
+		return false;
+	}
+
+	const std::vector<BakedMipLevel>& mip_levels{baked_texture.getMipLevels()};
+	for (std::size_t level{0}; level < mip_levels.size(); ++level) {
+		glCompressedTexImage2D(
+			GL_TEXTURE_2D,
+			static_cast<GLint>(level),
+			internal_format,
+			mip_levels[level].width,
+			mip_levels[level].height,
+			0,
+			static_cast<GLsizei>(mip_levels[level].size),
+			mip_levels[level].data
+		);
+	}
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(mip_levels.size()) - 1);
+	return true;
+}
@@ -1,124 +1,602 @@
 #include "game/headers/renderer/opengl/opengl-drawable-mesh.hh"
 
+#include "game/headers/animation/skinning.hh"
+#include "game/headers/model/vertex-compression.hh"
+#include "game/headers/renderer/opengl/opengl-drawable-model.hh"
+#include "game/headers/service-locator.hh"
+#include "game/headers/utility/hash.hh"
+
 #include "external/glad/glad.h"
-#define STB_IMAGE_IMPLEMENTATION
-#include "external/stb/stb_image.h"
 
-OpenGLDrawableMesh::OpenGLDrawableMesh(std::shared_ptr<Mesh> mesh, Shader& shader):
-		mesh_{mesh}, shader_{shader}, vertex_count_{mesh->triangles_.size() * 3u} {
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <utility>
+
+namespace {
+
+	// Vertex attribute locations of the per-instance model matrix, one per column
+	constexpr unsigned int INSTANCE_MATRIX_LOCATION{3u};
+	// Instance slot in the model, which locates the instance's skinning matrices
+	constexpr unsigned int INSTANCE_SLOT_LOCATION{7u};
+	constexpr unsigned int JOINTS_LOCATION{8u};
+	constexpr unsigned int WEIGHTS_LOCATION{9u};
+
+	float getMaxScale(const glm::mat4& transform) {
+		return std::max({
+			glm::length(glm::vec3(transform[0])),
+			glm::length(glm::vec3(transform[1])),
+			glm::length(glm::vec3(transform[2]))
+		});
+	}
+
+	std::uint32_t getMaterialKey(const Material& material) {
+		return static_cast<std::uint32_t>(hash_aux::fnv1a(&material, sizeof(Material)));
+	}
+
+	std::uint32_t getTexturesKey(const std::vector<Texture>& textures) {
+		std::uint64_t hash{hash_aux::FNV_OFFSET_BASIS};
+		for (const Texture& texture : textures) {
+			hash = hash_aux::fnv1a(texture.path.data(), texture.path.size(), hash);
+		}
+		return static_cast<std::uint32_t>(hash);
+	}
+
+} // namespace
+
+OpenGLDrawableMesh::OpenGLDrawableMesh(
+	std::shared_ptr<Mesh> mesh,
+	Shader& shader,
+	OpenGLTextureCache& texture_cache,
+	const RendererSettings& settings
+):
+		mesh_{mesh},
+		shader_{shader},
+		texture_cache_{texture_cache},
+		settings_{settings},
+		bounds_center_{mesh->bounding_sphere_.center},
+		bounds_radius_{mesh->bounding_sphere_.radius},
+		is_skinned_{mesh->isSkinned()},
+		is_gpu_skinned_{is_skinned_ && settings.skinning_mode == SkinningMode::Gpu},
+		is_cpu_skinned_{is_skinned_ && settings.skinning_mode == SkinningMode::Cpu},
+		material_key_{getMaterialKey(mesh->material_)},
+		textures_key_{getTexturesKey(mesh->textures_)} {
+	lod_errors_.push_back(0.0f);
+	for (const MeshLod& lod : mesh->lods_) {
+		lod_errors_.push_back(lod.error);
+	}
+}
+
+OpenGLDrawableMesh::OpenGLDrawableMesh(OpenGLDrawableMesh&& other) noexcept:
+		mesh_{std::move(other.mesh_)},
+		shader_{other.shader_},
+		texture_cache_{other.texture_cache_},
+		settings_{other.settings_},
+		lod_ranges_{std::move(other.lod_ranges_)},
+		lod_errors_{std::move(other.lod_errors_)},
+		bounds_center_{other.bounds_center_},
+		bounds_radius_{other.bounds_radius_},
+		instance_lod_levels_{std::move(other.instance_lod_levels_)},
+		lod_instances_{std::move(other.lod_instances_)},
+		lod_distances_{std::move(other.lod_distances_)},
+		first_sphere_{other.first_sphere_},
+		submesh_boxes_{std::move(other.submesh_boxes_)},
+		submesh_draws_{std::move(other.submesh_draws_)},
+		is_drawing_submeshes_{other.is_drawing_submeshes_},
+		instance_buffer_{other.instance_buffer_},
+		instance_slot_buffer_{other.instance_slot_buffer_},
+		is_skinned_{other.is_skinned_},
+		is_gpu_skinned_{other.is_gpu_skinned_},
+		is_cpu_skinned_{other.is_cpu_skinned_},
+		skin_vbo_{std::exchange(other.skin_vbo_, 0u)},
+		skinned_vertices_{std::move(other.skinned_vertices_)},
+		index_type_{other.index_type_},
+		index_size_{other.index_size_},
+		position_scale_{other.position_scale_},
+		position_offset_{other.position_offset_},
+		has_octahedral_normals_{other.has_octahedral_normals_},
+		vao_{std::exchange(other.vao_, 0u)},
+		vbo_{std::exchange(other.vbo_, 0u)},
+		ebo_{std::exchange(other.ebo_, 0u)},
+		is_uploaded_{std::exchange(other.is_uploaded_, false)},
+		memory_{std::move(other.memory_)},
+		opengl_textures_{std::move(other.opengl_textures_)},
+		material_key_{other.material_key_},
+		textures_key_{other.textures_key_} {
+}
+
+OpenGLDrawableMesh::~OpenGLDrawableMesh() {
+	// The instance buffers belong to the model
+	if (vao_ != 0u) {
+		glDeleteVertexArrays(1, &vao_);
+	}
+	if (vbo_ != 0u) {
+		glDeleteBuffers(1, &vbo_);
+	}
+	if (ebo_ != 0u) {
+		glDeleteBuffers(1, &ebo_);
+	}
+	if (skin_vbo_ != 0u) {
+		glDeleteBuffers(1, &skin_vbo_);
+	}
+}
+
+void OpenGLDrawableMesh::upload(unsigned int instance_buffer, unsigned int instance_slot_buffer) {
+	if (is_uploaded_) {
+		return;
+	}
+	if (!mesh_->isGeometryResident()) {
+		ServiceLocator::getInstance().getLogger()->Error("cannot upload a mesh whose geometry was released, load its model again");
+		return;
+	}
+	instance_buffer_ = instance_buffer;
+	instance_slot_buffer_ = instance_slot_buffer;
 	setupVertices();
 	setupTextures();
+	is_uploaded_ = true;
+
+	// Skinning on the CPU reads the vertices every frame
+	if (settings_.release_uploaded_geometry && !is_cpu_skinned_) {
+		mesh_->releaseGeometry();
+	}
+}
+
+bool OpenGLDrawableMesh::isUploaded() const {
+	return is_uploaded_;
+}
+
+void OpenGLDrawableMesh::addInstanceSlot() {
+	instance_lod_levels_.push_back(0u);
+}
+
+void OpenGLDrawableMesh::removeInstanceSlot(std::size_t slot) {
+	// Mirrors the model's swap-and-pop removal
+	instance_lod_levels_[slot] = instance_lod_levels_.back();
+	instance_lod_levels_.pop_back();
+}
+
+void OpenGLDrawableMesh::addBounds(
+	const std::vector<glm::mat4>& transforms,
+	const glm::mat4& node_transform,
+	CullingSpheres& spheres
+) {
+	first_sphere_ = spheres.count;
+	if (!is_uploaded_) {
+		return;
+	}
+	const glm::mat4 mesh_transform{is_skinned_ ? glm::mat4(1.0f) : node_transform};
+	for (const glm::mat4& transform : transforms) {
+		const glm::mat4 world{transform * mesh_transform};
+		spheres.add(glm::vec3(world * glm::vec4(bounds_center_, 1.0f)), bounds_radius_ * getMaxScale(world));
+	}
+}
+
+void OpenGLDrawableMesh::prepareInstances(
+	const LodSelector& selector,
+	const Frustum& frustum,
+	const CullingSpheres& spheres,
+	const std::vector<glm::mat4>& transforms,
+	const glm::mat4& node_transform,
+	std::vector<glm::mat4>& instance_stream,
+	std::vector<std::uint32_t>& instance_slot_stream,
+	CullingStats& stats
+) {
+	is_drawing_submeshes_ = false;
+	if (!is_uploaded_) {
+		lod_instances_.clear();
+		return;
+	}
+	const glm::mat4 mesh_transform{is_skinned_ ? glm::mat4(1.0f) : node_transform};
+	const auto isVisible{[&](std::size_t instance) {
+		return is_skinned_ || spheres.visible[first_sphere_ + instance] != 0u;
+	}};
+
+	// Selecting every visible instance's level of detail, counting the instances of every level, and finding their closest
+	lod_instances_.assign(lod_ranges_.size(), {0u, 0u});
+	lod_distances_.assign(lod_ranges_.size(), std::numeric_limits<float>::max());
+	std::size_t visible_count{0u};
+	std::size_t last_visible{0u};
+	for (std::size_t i{0u}; i < transforms.size(); ++i) {
+		if (!isVisible(i)) {
+			continue;
+		}
+		const std::size_t sphere{first_sphere_ + i};
+		const glm::vec3 center{spheres.getCenter(sphere)};
+		const float radius{spheres.radius[sphere]};
+		const std::size_t level{selector.select(center, radius, lod_errors_, instance_lod_levels_[i])};
+		instance_lod_levels_[i] = level;
+		++lod_instances_[level].instance_count;
+		lod_distances_[level] = std::min(lod_distances_[level], selector.getDistance(center, radius));
+		++visible_count;
+		last_visible = i;
+	}
+	if (!is_skinned_) {
+		stats.instance_count += transforms.size();
+		stats.visible_instance_count += visible_count;
+	}
+
+	// A static batch is usually placed once, its submeshes are culled when it is
+	bool is_last_visible_culled{false};
+	if (visible_count == 1u && !is_skinned_ && !mesh_->submeshes_.empty()) {
+		const std::size_t level{instance_lod_levels_[last_visible]};
+		if (!cullSubmeshes(frustum, transforms[last_visible] * mesh_transform, level, stats)) {
+			is_last_visible_culled = true;
+			lod_instances_[level].instance_count = 0u;
+		}
+	}
+
+	// Appending the transforms grouped by level, as every level is a separate draw call
+	std::size_t first_instance{instance_stream.size()};
+	for (InstanceRange& instances : lod_instances_) {
+		instances.first_instance = first_instance;
+		first_instance += instances.instance_count;
+		instances.instance_count = 0u;
+	}
+	instance_stream.resize(first_instance);
+	instance_slot_stream.resize(first_instance);
+	for (std::size_t i{0u}; i < transforms.size(); ++i) {
+		if (!isVisible(i) || (is_last_visible_culled && i == last_visible)) {
+			continue;
+		}
+		InstanceRange& instances{lod_instances_[instance_lod_levels_[i]]};
+		const std::size_t position{instances.first_instance + instances.instance_count++};
+		instance_stream[position] = transforms[i] * mesh_transform;
+		instance_slot_stream[position] = static_cast<std::uint32_t>(i);
+	}
+}
+
+bool OpenGLDrawableMesh::cullSubmeshes(const Frustum& frustum, const glm::mat4& world, std::size_t level, CullingStats& stats) {
+	const std::vector<Submesh>& submeshes{mesh_->submeshes_};
+	submesh_boxes_.clear();
+	for (const Submesh& submesh : submeshes) {
+		const glm::vec3 center{0.5f * (submesh.bounds.min + submesh.bounds.max)};
+		const glm::vec3 extent{0.5f * (submesh.bounds.max - submesh.bounds.min)};
+		// The box around the transformed box
+		glm::vec3 world_extent{0.0f};
+		for (int axis{0}; axis < 3; ++axis) {
+			for (int column{0}; column < 3; ++column) {
+				world_extent[axis] += std::fabs(world[column][axis]) * extent[column];
+			}
+		}
+		submesh_boxes_.add(glm::vec3(world * glm::vec4(center, 1.0f)), world_extent);
+	}
+	frustum.cull(submesh_boxes_);
+
+	// Adjacent submeshes' triangles follow each other, so runs of visible submeshes are drawn at once
+	submesh_draws_.clear();
+	std::size_t visible_count{0u};
+	for (std::size_t i{0u}; i < submeshes.size(); ++i) {
+		if (submesh_boxes_.visible[i] == 0u) {
+			continue;
+		}
+		++visible_count;
+		const IndexRange& range{submeshes[i].levels[level]};
+		const std::size_t first_index{lod_ranges_[level].first_index + range.first_index};
+		if (!submesh_draws_.empty() && submesh_draws_.back().first_index + submesh_draws_.back().index_count == first_index) {
+			submesh_draws_.back().index_count += range.index_count;
+		} else {
+			submesh_draws_.push_back({first_index, range.index_count});
+		}
+	}
+	stats.submesh_count += submeshes.size();
+	stats.visible_submesh_count += visible_count;
+	is_drawing_submeshes_ = visible_count < submeshes.size();
+	return visible_count > 0u;
+}
+
+void OpenGLDrawableMesh::skinInstances(
+	const std::vector<std::uint32_t>& instance_slot_stream,
+	const std::vector<glm::mat4>& skinning_matrices,
+	std::size_t joint_count
+) {
+	if (!is_cpu_skinned_ || lod_instances_.empty()) {
+		return;
+	}
+
+	// The mesh's instances are one range of the stream, every level's instances after the previous level's
+	const std::size_t first_instance{lod_instances_.front().first_instance};
+	std::size_t instance_count{0u};
+	for (const InstanceRange& instances : lod_instances_) {
+		instance_count += instances.instance_count;
+	}
+	const std::size_t vertex_count{mesh_->vertices_.size()};
+	skinned_vertices_.resize(instance_count * vertex_count);
+	ServiceLocator::getInstance().getThreadPool().parallelFor(instance_count, [&](std::size_t i) {
+		const std::uint32_t slot{instance_slot_stream[first_instance + i]};
+		skinning::skinVertices(
+			mesh_->vertices_.data(),
+			mesh_->skin_.data(),
+			vertex_count,
+			skinning_matrices.data() + slot * joint_count,
+			skinned_vertices_.data() + i * vertex_count
+		);
+	});
+
+	// Orphaning the last frame's vertices, like the instance stream
+	const GLsizeiptr size{static_cast<GLsizeiptr>(skinned_vertices_.size() * sizeof(Vertex))};
+	glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+	glBufferData(GL_ARRAY_BUFFER, size, NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, size, skinned_vertices_.data());
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	memory_.set(MemoryDomain::Gpu, MemoryCategory::Vertices, static_cast<std::size_t>(size));
+	memory_.set(MemoryDomain::Cpu, MemoryCategory::Animation, skinned_vertices_.capacity() * sizeof(Vertex));
 }
 
 void OpenGLDrawableMesh::setupVertices() {
-	std::vector<Vertex> vertices;
-	for (const auto& triangle : mesh_->triangles_) {
-		vertices.push_back(triangle.vertices[0]);
-		vertices.push_back(triangle.vertices[1]);
-		vertices.push_back(triangle.vertices[2]);
+	// Vertices skinned on the CPU are streamed at full precision, the bind pose fills the buffer until then
+	VertexFormat format{is_cpu_skinned_ ? VertexFormat::Full : settings_.vertex_format};
+	if (format == VertexFormat::CompactQuantized) {
+		const glm::vec3 extent{mesh_->bounds_.max - mesh_->bounds_.min};
+		const float max_extent{std::max({extent.x, extent.y, extent.z})};
+		if (!mesh_->submeshes_.empty() || max_extent > settings_.max_quantized_extent) {
+			format = VertexFormat::Compact;
+		}
+	}
+	const EncodedVertices vertices{vertex_compression::encode(*mesh_, format)};
+	position_scale_ = vertices.position_scale;
+	position_offset_ = vertices.position_offset;
+	has_octahedral_normals_ = format != VertexFormat::Full;
+
+	if (settings_.validate_vertex_format && format != VertexFormat::Full) {
+		const QuantizationError error{vertex_compression::measureError(*mesh_, format)};
+		std::ostringstream message;
+		message << "Vertex quantization error of a mesh with " << mesh_->vertices_.size() << " vertices: "
+			<< "position " << error.max_position_error << ", "
+			<< "normal " << error.max_normal_error << " degrees, "
+			<< "texture coordinates " << error.max_tex_coords_error;
+		ServiceLocator::getInstance().getLogger()->Info(message.str());
 	}
 
 	glGenVertexArrays(1, &vao_);
 	glGenBuffers(1, &vbo_);
+	glGenBuffers(1, &ebo_);
 
 	glBindVertexArray(vao_);
 
 	// Copying vertices
 	glBindBuffer(GL_ARRAY_BUFFER, vbo_);
-	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
+	glBufferData(
+		GL_ARRAY_BUFFER,
+		vertices.data.size(),
+		vertices.data.data(),
+		is_cpu_skinned_ ? GL_STREAM_DRAW : GL_STATIC_DRAW
+	);
+	memory_.set(MemoryDomain::Gpu, MemoryCategory::Vertices, vertices.data.size());
 
-	// Pointer for a vertex's position
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (GLvoid*) 0);
+	// Every level of detail shares the vertices, their indices follow each other in one buffer
+	std::vector<std::uint32_t> indices{mesh_->indices_};
+	lod_ranges_.push_back({0u, mesh_->indices_.size()});
+	for (const MeshLod& lod : mesh_->lods_) {
+		lod_ranges_.push_back({indices.size(), lod.indices.size()});
+		indices.insert(indices.end(), lod.indices.cbegin(), lod.indices.cend());
+	}
+
+	// Copying indices, narrowed to 16 bits when every vertex is addressable by them
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_);
+	if (mesh_->hasShortIndices()) {
+		const std::vector<std::uint16_t> short_indices(indices.cbegin(), indices.cend());
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, short_indices.size() * sizeof(std::uint16_t), short_indices.data(), GL_STATIC_DRAW);
+		index_type_ = GL_UNSIGNED_SHORT;
+		index_size_ = sizeof(std::uint16_t);
+	} else {
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(std::uint32_t), indices.data(), GL_STATIC_DRAW);
+		index_type_ = GL_UNSIGNED_INT;
+		index_size_ = sizeof(std::uint32_t);
+	}
+	memory_.set(MemoryDomain::Gpu, MemoryCategory::Indices, indices.size() * index_size_);
 
-	// Pointer for a vertex's normal
+	glEnableVertexAttribArray(0);
 	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (GLvoid*) offsetof(Vertex, normal));
-	
-	// Pointer for a vertex's texture coordinates
 	glEnableVertexAttribArray(2);
-	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (GLvoid*) offsetof(Vertex, tex_coords));
 
-	glBindVertexArray(0);
-}
+	// Pointers for a vertex's position, normal, and texture coordinates
+	const GLsizei stride{static_cast<GLsizei>(vertices.stride)};
+	switch (format) {
+		case VertexFormat::Full:
+			glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*) offsetof(Vertex, position));
+			glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*) offsetof(Vertex, normal));
+			glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (GLvoid*) offsetof(Vertex, tex_coords));
+			break;
+		case VertexFormat::Compact:
+			glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*) offsetof(CompactVertex, position));
+			glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, stride, (GLvoid*) offsetof(CompactVertex, normal));
+			glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, stride, (GLvoid*) offsetof(CompactVertex, tex_coords));
+			break;
+		case VertexFormat::CompactQuantized:
+			glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, stride, (GLvoid*) offsetof(QuantizedVertex, position));
+			glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, stride, (GLvoid*) offsetof(QuantizedVertex, normal));
+			glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, stride, (GLvoid*) offsetof(QuantizedVertex, tex_coords));
+			break;
+	}
 
-static unsigned int load_texture_from_file(const std::string& file_path);
+	// An instance's model matrix takes one location per column, the pointers are set when drawing
+	for (unsigned int column{0u}; column < 4u; ++column) {
+		glEnableVertexAttribArray(INSTANCE_MATRIX_LOCATION + column);
+		glVertexAttribDivisor(INSTANCE_MATRIX_LOCATION + column, 1);
+	}
 
-void OpenGLDrawableMesh::setupTextures() {
-	for (const Texture& texture : mesh_->textures_) {
-		// Load the texture
-		unsigned int texture_id{load_texture_from_file(texture.path)};
-		// Save the texture
-		opengl_textures_.push_back({texture_id, texture});
+	// Joints, and weights of every vertex in a buffer of their own, the vertex formats stay the same
+	if (is_gpu_skinned_) {
+		const std::size_t skin_size{mesh_->skin_.size() * sizeof(VertexSkin)};
+		glGenBuffers(1, &skin_vbo_);
+		glBindBuffer(GL_ARRAY_BUFFER, skin_vbo_);
+		glBufferData(GL_ARRAY_BUFFER, skin_size, mesh_->skin_.data(), GL_STATIC_DRAW);
+		memory_.set(MemoryDomain::Gpu, MemoryCategory::Vertices, vertices.data.size() + skin_size);
+
+		glEnableVertexAttribArray(JOINTS_LOCATION);
+		glVertexAttribIPointer(JOINTS_LOCATION, 4, GL_UNSIGNED_SHORT, sizeof(VertexSkin), (GLvoid*) offsetof(VertexSkin, joints));
+		glEnableVertexAttribArray(WEIGHTS_LOCATION);
+		glVertexAttribPointer(WEIGHTS_LOCATION, 4, GL_FLOAT, GL_FALSE, sizeof(VertexSkin), (GLvoid*) offsetof(VertexSkin, weights));
+
+		glEnableVertexAttribArray(INSTANCE_SLOT_LOCATION);
+		glVertexAttribDivisor(INSTANCE_SLOT_LOCATION, 1);
 	}
+
+	glBindVertexArray(0);
 }
 
-void OpenGLDrawableMesh::draw() const {
-	// Setting up the mesh's textures
+void OpenGLDrawableMesh::setupTextures() {
+	// Samplers are numbered by type, texture_diffuse1, texture_diffuse2, and so on
 	unsigned int diffuse_n{1u};
 	unsigned int specular_n{1u};
-	for (unsigned int i{0u}; i < opengl_textures_.size(); i++) {
-		glActiveTexture(GL_TEXTURE0 + i);
-
+	for (const Texture& texture : mesh_->textures_) {
 		std::string number;
-		const std::string name{opengl_textures_[i].texture.type};
-
-		if (name == "texture_diffuse") {
+		if (texture.type == "texture_diffuse") {
 			number = std::to_string(diffuse_n++);
-		} else if (name == "texture_specular") {
+		} else if (texture.type == "texture_specular") {
 			number = std::to_string(specular_n++);
 		}
+		const ShaderUniform<int> sampler{shader_.getUniform<int>(texture.type + number)};
 
-		glUniform1i(glGetUniformLocation(shader_.id, (name + number).c_str()), i);
-		glBindTexture(GL_TEXTURE_2D, opengl_textures_[i].id);
+		// Textures are shared with every other mesh which uses the same image
+		opengl_textures_.push_back({texture_cache_.acquire(texture.path), texture, sampler});
 	}
+}
 
-	glActiveTexture(GL_TEXTURE0);
+void OpenGLDrawableMesh::submit(OpenGLRenderQueue& queue, const OpenGLDrawableModel& model) const {
+	if (!is_uploaded_) {
+		return;
+	}
+	for (std::size_t level{0u}; level < lod_instances_.size(); ++level) {
+		if (lod_instances_[level].instance_count == 0u) {
+			continue;
+		}
+		const std::uint64_t sort_key{
+			draw_key::make(
+				RenderPass::Opaque,
+				shader_.id,
+				material_key_,
+				textures_key_,
+				vao_,
+				draw_key::getDepth(lod_distances_[level])
+			)
+		};
+		queue.submit(sort_key, {&model, this, static_cast<std::uint32_t>(level)});
+	}
+}
 
-	// Setting the mesh's material properties
-	Material material{mesh_->material_};
-	shader_.setVec3("material.color_ambient", material.color_ambient);
-	shader_.setVec3("material.color_diffuse", material.color_diffuse);
-	shader_.setVec3("material.color_specular", material.color_specular);
-	shader_.setFloat("material.shininess", material.shininess);
+bool OpenGLDrawableMesh::hasSameMaterial(const OpenGLDrawableMesh& other) const {
+	return std::memcmp(&mesh_->material_, &other.mesh_->material_, sizeof(Material)) == 0;
+}
+
+bool OpenGLDrawableMesh::hasSameTextures(const OpenGLDrawableMesh& other) const {
+	if (opengl_textures_.size() != other.opengl_textures_.size()) {
+		return false;
+	}
+	for (std::size_t i{0u}; i < opengl_textures_.size(); ++i) {
+		const OpenGLTexture& texture{opengl_textures_[i]};
+		const OpenGLTexture& other_texture{other.opengl_textures_[i]};
+		// A texture still streaming in is bound as its placeholder, so the bound names are compared
+		if (texture.sampler.index != other_texture.sampler.index
+				|| texture.cached_texture->getId() != other_texture.cached_texture->getId()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void OpenGLDrawableMesh::setMaterial(const Shader& shader, const OpenGLMeshUniforms& uniforms) const {
+	const Material& material{mesh_->material_};
+	shader.set(uniforms.color_ambient, material.color_ambient);
+	shader.set(uniforms.color_diffuse, material.color_diffuse);
+	shader.set(uniforms.color_specular, material.color_specular);
+	shader.set(uniforms.shininess, material.shininess);
+}
+
+void OpenGLDrawableMesh::bindTextures(const Shader& shader) const {
+	for (unsigned int i{0u}; i < opengl_textures_.size(); i++) {
+		glActiveTexture(GL_TEXTURE0 + i);
+		shader.set(opengl_textures_[i].sampler, static_cast<int>(i));
+		glBindTexture(GL_TEXTURE_2D, opengl_textures_[i].cached_texture->getId());
+	}
+	glActiveTexture(GL_TEXTURE0);
+}
 
-	// Drawing the mesh
+void OpenGLDrawableMesh::bindVertexArray(const Shader& shader, const OpenGLMeshUniforms& uniforms) const {
+	shader.set(uniforms.vertex_position_scale, position_scale_);
+	shader.set(uniforms.vertex_position_offset, position_offset_);
+	shader.set(uniforms.vertex_octahedral_normals, has_octahedral_normals_);
+	shader.set(uniforms.skinned, is_gpu_skinned_);
 	glBindVertexArray(vao_);
-	glDrawArrays(GL_TRIANGLES, 0, vertex_count_);
-	glBindVertexArray(0);
 }
 
-static unsigned int load_texture_from_file(const std::string& file_path) {
-	int image_width, image_height, color_channels;
-	unsigned char* data;
-	unsigned int texture_id{0};
-
-	data = stbi_load(file_path.c_str(), &image_width, &image_height, &color_channels, 0);
-	if (data != NULL) {
-		GLenum format{GL_RGB};
-		if (color_channels == 1) {
-			format = GL_RED;
-		} else if (color_channels == 3) {
-			format = GL_RGB;
-		} else if (color_channels == 4) {
-			format = GL_RGBA;
+void OpenGLDrawableMesh::drawLevel(std::size_t level) const {
+	const InstanceRange& instances{lod_instances_[level]};
+	const LodRange& lod{lod_ranges_[level]};
+
+	if (is_cpu_skinned_) {
+		// Every instance has its own skinned vertices, so it is a draw call of its own
+		const std::size_t vertex_count{mesh_->vertices_.size()};
+		const std::size_t first_instance{lod_instances_.front().first_instance};
+		for (std::size_t i{0u}; i < instances.instance_count; ++i) {
+			const std::size_t instance{instances.first_instance + i};
+			setInstancePointers(instance);
+			glDrawElementsInstancedBaseVertex(
+				GL_TRIANGLES,
+				lod.index_count,
+				index_type_,
+				(GLvoid*) (lod.first_index * index_size_),
+				1,
+				static_cast<GLint>((instance - first_instance) * vertex_count)
+			);
 		}
+		return;
+	}
 
-		glGenTextures(1, &texture_id);
-		glBindTexture(GL_TEXTURE_2D, texture_id);
+	setInstancePointers(instances.first_instance);
+	if (is_gpu_skinned_) {
+		glBindBuffer(GL_ARRAY_BUFFER, instance_slot_buffer_);
+		glVertexAttribIPointer(
+			INSTANCE_SLOT_LOCATION,
+			1,
+			GL_UNSIGNED_INT,
+			sizeof(std::uint32_t),
+			(GLvoid*) (instances.first_instance * sizeof(std::uint32_t))
+		);
+	}
+	if (is_drawing_submeshes_) {
+		for (const LodRange& range : submesh_draws_) {
+			glDrawElementsInstanced(
+				GL_TRIANGLES,
+				range.index_count,
+				index_type_,
+				(GLvoid*) (range.first_index * index_size_),
+				instances.instance_count
+			);
+		}
+		return;
+	}
+	glDrawElementsInstanced(
+		GL_TRIANGLES,
+		lod.index_count,
+		index_type_,
+		(GLvoid*) (lod.first_index * index_size_),
+		instances.instance_count
+	);
+}
 
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+void OpenGLDrawableMesh::setInstancePointers(std::size_t first_instance) const {
+	glBindBuffer(GL_ARRAY_BUFFER, instance_buffer_);
+	for (unsigned int column{0u}; column < 4u; ++column) {
+		glVertexAttribPointer(
+			INSTANCE_MATRIX_LOCATION + column,
+			4,
+			GL_FLOAT,
+			GL_FALSE,
+			sizeof(glm::mat4),
+			(GLvoid*) (first_instance * sizeof(glm::mat4) + column * sizeof(glm::vec4))
+		);
+	}
+}
 
-		glTexImage2D(GL_TEXTURE_2D, 0, format, image_width, image_height, 0, format, GL_UNSIGNED_BYTE, data);
-		glGenerateMipmap(GL_TEXTURE_2D);
+const MemoryUsage& OpenGLDrawableMesh::getMemoryUsage() const {
+	return memory_.getUsage();
+}
 
-		stbi_image_free(data);
-	} else {
-		std::cout << "Cannot load a texture data! Path: " << file_path << std::endl;
-		stbi_image_free(data);
-	}
-	return texture_id;
+const std::vector<OpenGLTexture>& OpenGLDrawableMesh::getTextures() const {
+	return opengl_textures_;
 }
@@ -1,13 +1,250 @@
 #include "game/headers/renderer/opengl/opengl-drawable-model.hh"
 
-OpenGLDrawableModel::OpenGLDrawableModel(std::shared_ptr<Model> model, Shader& shader) {
+#include "external/glad/glad.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_set>
+
+OpenGLDrawableModel::OpenGLDrawableModel(
+	std::shared_ptr<Model> model,
+	Shader& shader,
+	OpenGLTextureCache& texture_cache,
+	const RendererSettings& settings
+):
+		model_{model},
+		settings_{settings},
+		joint_count_{model->skeleton_.getJointCount()} {
 	for (std::shared_ptr<Mesh> mesh : model->meshes_) {
-		meshes_.emplace_back(mesh, shader);
+		meshes_.emplace_back(mesh, shader, texture_cache, settings);
+	}
+}
+
+OpenGLDrawableModel::~OpenGLDrawableModel() {
+	if (instance_buffer_ != 0u) {
+		glDeleteBuffers(1, &instance_buffer_);
+		glDeleteBuffers(1, &instance_slot_buffer_);
+	}
+	if (skinning_texture_ != 0u) {
+		glDeleteTextures(1, &skinning_texture_);
+		glDeleteBuffers(1, &skinning_buffer_);
+	}
+}
+
+void OpenGLDrawableModel::upload() {
+	createInstanceBuffer();
+	for (OpenGLDrawableMesh& mesh : meshes_) {
+		mesh.upload(instance_buffer_, instance_slot_buffer_);
+	}
+}
+
+void OpenGLDrawableModel::uploadMesh(std::size_t index) {
+	createInstanceBuffer();
+	meshes_.at(index).upload(instance_buffer_, instance_slot_buffer_);
+}
+
+std::size_t OpenGLDrawableModel::getMeshCount() const {
+	return meshes_.size();
+}
+
+void OpenGLDrawableModel::addInstance(ModelInstanceId instance, const glm::mat4& transform) {
+	instance_slots_.emplace(instance, instance_ids_.size());
+	instance_ids_.push_back(instance);
+	instance_transforms_.push_back(transform);
+	// Identity skinning matrices draw the bind pose
+	skinning_matrices_.resize(skinning_matrices_.size() + joint_count_, glm::mat4(1.0f));
+	are_skinning_matrices_changed_ = true;
+	for (OpenGLDrawableMesh& mesh : meshes_) {
+		mesh.addInstanceSlot();
+	}
+}
+
+void OpenGLDrawableModel::setInstanceTransform(ModelInstanceId instance, const glm::mat4& transform) {
+	instance_transforms_[instance_slots_.at(instance)] = transform;
+}
+
+void OpenGLDrawableModel::setInstanceSkinningMatrices(ModelInstanceId instance, const std::vector<glm::mat4>& skinning_matrices) {
+	if (skinning_matrices.size() != joint_count_) {
+		throw std::invalid_argument("an instance needs a skinning matrix for every joint of its model's skeleton");
+	}
+	const std::size_t slot{instance_slots_.at(instance)};
+	std::copy(skinning_matrices.cbegin(), skinning_matrices.cend(), skinning_matrices_.begin() + slot * joint_count_);
+	are_skinning_matrices_changed_ = true;
+}
+
+void OpenGLDrawableModel::removeInstance(ModelInstanceId instance) {
+	const auto it{instance_slots_.find(instance)};
+	if (it == instance_slots_.end()) {
+		return;
+	}
+	const std::size_t slot{it->second};
+	instance_slots_.erase(it);
+
+	// Moving the last instance into the removed one's slot
+	if (slot + 1u != instance_ids_.size()) {
+		instance_ids_[slot] = instance_ids_.back();
+		instance_transforms_[slot] = instance_transforms_.back();
+		instance_slots_[instance_ids_[slot]] = slot;
+		std::copy(skinning_matrices_.cend() - joint_count_, skinning_matrices_.cend(), skinning_matrices_.begin() + slot * joint_count_);
+	}
+	instance_ids_.pop_back();
+	instance_transforms_.pop_back();
+	skinning_matrices_.resize(skinning_matrices_.size() - joint_count_);
+	are_skinning_matrices_changed_ = true;
+	for (OpenGLDrawableMesh& mesh : meshes_) {
+		mesh.removeInstanceSlot(slot);
+	}
+}
+
+std::size_t OpenGLDrawableModel::getInstanceCount() const {
+	return instance_ids_.size();
+}
+
+void OpenGLDrawableModel::addBounds(CullingSpheres& spheres) {
+	// Only nodes moved since the last frame are recomputed
+	model_->transforms_.update();
+
+	for (std::size_t i{0u}; i < meshes_.size(); ++i) {
+		const glm::mat4& node_transform{model_->transforms_.getWorld(model_->mesh_nodes_[i])};
+		meshes_[i].addBounds(instance_transforms_, node_transform, spheres);
+	}
+}
+
+void OpenGLDrawableModel::prepareInstances(
+	const LodSelector& selector,
+	const Frustum& frustum,
+	const CullingSpheres& spheres,
+	CullingStats& stats
+) {
+	instance_stream_.clear();
+	instance_slot_stream_.clear();
+	for (std::size_t i{0u}; i < meshes_.size(); ++i) {
+		const glm::mat4& node_transform{model_->transforms_.getWorld(model_->mesh_nodes_[i])};
+		meshes_[i].prepareInstances(
+			selector,
+			frustum,
+			spheres,
+			instance_transforms_,
+			node_transform,
+			instance_stream_,
+			instance_slot_stream_,
+			stats
+		);
+	}
+	if (instance_buffer_ == 0u || instance_stream_.empty()) {
+		updateMemoryRecord();
+		return;
+	}
+
+	// Orphaning the last frame's storage, so the driver does not wait for draws still reading it
+	glBindBuffer(GL_ARRAY_BUFFER, instance_buffer_);
+	const GLsizeiptr size{static_cast<GLsizeiptr>(instance_stream_.size() * sizeof(glm::mat4))};
+	glBufferData(GL_ARRAY_BUFFER, size, NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, size, instance_stream_.data());
+	std::size_t gpu_bytes{static_cast<std::size_t>(size)};
+
+	// Only skinned meshes read the instances' slots
+	if (isSkinned()) {
+		glBindBuffer(GL_ARRAY_BUFFER, instance_slot_buffer_);
+		const GLsizeiptr slot_size{static_cast<GLsizeiptr>(instance_slot_stream_.size() * sizeof(std::uint32_t))};
+		glBufferData(GL_ARRAY_BUFFER, slot_size, NULL, GL_STREAM_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, slot_size, instance_slot_stream_.data());
+		gpu_bytes += static_cast<std::size_t>(slot_size);
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	memory_.set(MemoryDomain::Gpu, MemoryCategory::Instances, gpu_bytes);
+
+	if (isSkinned()) {
+		if (settings_.skinning_mode == SkinningMode::Gpu) {
+			uploadSkinningMatrices();
+		} else {
+			for (OpenGLDrawableMesh& mesh : meshes_) {
+				mesh.skinInstances(instance_slot_stream_, skinning_matrices_, joint_count_);
+			}
+		}
+	}
+	updateMemoryRecord();
+}
+
+void OpenGLDrawableModel::uploadSkinningMatrices() {
+	if (!are_skinning_matrices_changed_ || skinning_matrices_.empty()) {
+		return;
+	}
+	are_skinning_matrices_changed_ = false;
+
+	// Every matrix is four texels, one per column
+	const GLsizeiptr size{static_cast<GLsizeiptr>(skinning_matrices_.size() * sizeof(glm::mat4))};
+	if (skinning_texture_ == 0u) {
+		glGenBuffers(1, &skinning_buffer_);
+		glGenTextures(1, &skinning_texture_);
+		glBindBuffer(GL_TEXTURE_BUFFER, skinning_buffer_);
+		glBufferData(GL_TEXTURE_BUFFER, size, NULL, GL_STREAM_DRAW);
+		glBindTexture(GL_TEXTURE_BUFFER, skinning_texture_);
+		glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, skinning_buffer_);
+		glBindTexture(GL_TEXTURE_BUFFER, 0);
+	}
+
+	// Orphaning like the instance stream, the texture keeps referring to the buffer
+	glBindBuffer(GL_TEXTURE_BUFFER, skinning_buffer_);
+	glBufferData(GL_TEXTURE_BUFFER, size, NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_TEXTURE_BUFFER, 0, size, skinning_matrices_.data());
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+	memory_.set(MemoryDomain::Gpu, MemoryCategory::Animation, static_cast<std::size_t>(size));
+}
+
+void OpenGLDrawableModel::submit(OpenGLRenderQueue& queue) const {
+	for (const OpenGLDrawableMesh& mesh : meshes_) {
+		mesh.submit(queue, *this);
+	}
+}
+
+bool OpenGLDrawableModel::bindSkinning(const Shader& shader, const OpenGLMeshUniforms& uniforms) const {
+	if (!isSkinned() || settings_.skinning_mode != SkinningMode::Gpu || skinning_texture_ == 0u) {
+		return false;
+	}
+	glActiveTexture(GL_TEXTURE0 + SKINNING_TEXTURE_UNIT);
+	glBindTexture(GL_TEXTURE_BUFFER, skinning_texture_);
+	glActiveTexture(GL_TEXTURE0);
+	shader.set(uniforms.joint_count, static_cast<int>(joint_count_));
+	return true;
+}
+
+bool OpenGLDrawableModel::isSkinned() const {
+	return joint_count_ > 0u;
+}
+
+void OpenGLDrawableModel::createInstanceBuffer() {
+	if (instance_buffer_ == 0u) {
+		glGenBuffers(1, &instance_buffer_);
+		glGenBuffers(1, &instance_slot_buffer_);
 	}
 }
 
-void OpenGLDrawableModel::draw() const {
-	for (OpenGLDrawableMesh mesh : meshes_) {
-		mesh.draw();
+MemoryUsage OpenGLDrawableModel::getMemoryUsage() const {
+	MemoryUsage usage{model_->getMemoryUsage()};
+	usage += memory_.getUsage();
+
+	std::unordered_set<const OpenGLCachedTexture*> textures;
+	for (const OpenGLDrawableMesh& mesh : meshes_) {
+		usage += mesh.getMemoryUsage();
+		for (const OpenGLTexture& texture : mesh.getTextures()) {
+			if (textures.insert(texture.cached_texture.get()).second) {
+				usage += texture.cached_texture->getMemoryUsage();
+			}
+		}
 	}
-}
\ No newline at end of file
+	return usage;
+}
+
+void OpenGLDrawableModel::updateMemoryRecord() {
+	const std::size_t instance_bytes{
+		instance_ids_.capacity() * sizeof(ModelInstanceId)
+			+ instance_transforms_.capacity() * sizeof(glm::mat4)
+			+ instance_slots_.size() * (sizeof(ModelInstanceId) + sizeof(std::size_t))
+			+ instance_stream_.capacity() * sizeof(glm::mat4)
+			+ instance_slot_stream_.capacity() * sizeof(std::uint32_t)
+	};
+	memory_.set(MemoryDomain::Cpu, MemoryCategory::Instances, instance_bytes);
+	memory_.set(MemoryDomain::Cpu, MemoryCategory::Animation, skinning_matrices_.capacity() * sizeof(glm::mat4));
+}
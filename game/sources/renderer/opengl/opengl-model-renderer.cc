@@ -1,5 +1,6 @@
 #include "game/headers/renderer/opengl/opengl-model-renderer.hh"
 
+#include "game/headers/renderer/opengl/uniform-blocks.hh"
 #include "game/headers/service-locator.hh"
 
 #include "external/glad/glad.h"
@@ -10,9 +11,16 @@
 #include "external/glm/glm/ext/matrix_clip_space.hpp"
 #include "external/glm/glm/ext/matrix_transform.hpp"
 
-void OpenGLModelRenderer::init(Screen screen, const Camera* camera) {
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+void OpenGLModelRenderer::init(Screen screen, const Camera* camera, RendererSettings settings) {
 	screen_ = screen;
 	camera_ = camera;
+	settings_ = settings;
 
 	// Setting up OpenGL
 	glViewport(0, 0, screen_.width, screen_.height);
@@ -28,14 +36,113 @@ void OpenGLModelRenderer::init(Screen screen, const Camera* camera) {
 
 	mesh_shader_ = Shader("game/shaders/mesh-vertex.gls", "game/shaders/mesh-fragment.gls");
 	mesh_shader_.use();
-	
-	mesh_shader_.setVec3("light.color_ambient", glm::vec3(0.5f));
-	mesh_shader_.setVec3("light.color_diffuse", glm::vec3(0.5f));
-	mesh_shader_.setVec3("light.color_specular", glm::vec3(1.0f));
+	frame_uniforms_.init(uniform_blocks::FRAME_BINDING, sizeof(uniform_blocks::Frame));
+	light_uniforms_.init(uniform_blocks::LIGHT_BINDING, sizeof(uniform_blocks::Light));
+
+	// Set even without skinned models, a sampler left at unit 0 would clash with the meshes' textures
+	mesh_shader_.set(
+		mesh_shader_.getUniform<int>("skinning_matrices"),
+		static_cast<int>(OpenGLDrawableModel::SKINNING_TEXTURE_UNIT)
+	);
+	mesh_shader_.set(mesh_shader_.getUniform<bool>("skinned"), false);
+	render_queue_ = OpenGLRenderQueue{mesh_shader_};
 };
 
 void OpenGLModelRenderer::addModel(std::shared_ptr<Model> model) {
-	models_.emplace_back(model, mesh_shader_);
+	addInstance(model, glm::mat4(1.0f));
+	getDrawable(model).upload();
+}
+
+void OpenGLModelRenderer::addModel(std::future<std::shared_ptr<Model>> model) {
+	pending_models_.push_back(std::move(model));
+}
+
+void OpenGLModelRenderer::update() {
+	// Picking up models which finished loading
+	for (auto it{pending_models_.begin()}; it != pending_models_.end();) {
+		if (it->wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+			++it;
+			continue;
+		}
+
+		try {
+			addInstance(it->get(), glm::mat4(1.0f));
+		} catch (const std::exception& e) {
+			ServiceLocator::getInstance().getLogger()->Error(std::string("cannot load a model: ") + e.what());
+		}
+		it = pending_models_.erase(it);
+	}
+
+	upload_queue_.process(settings_.upload_budget_ms);
+	texture_cache_.update(settings_.texture_upload_budget_ms);
+}
+
+ModelInstanceId OpenGLModelRenderer::addInstance(std::shared_ptr<Model> model, const glm::mat4& transform) {
+	const ModelInstanceId instance{next_instance_id_++};
+	getDrawable(model).addInstance(instance, transform);
+	instance_models_.emplace(instance, model.get());
+	return instance;
+}
+
+void OpenGLModelRenderer::setInstanceTransform(ModelInstanceId instance, const glm::mat4& transform) {
+	const auto it{instance_models_.find(instance)};
+	if (it != instance_models_.end()) {
+		models_.at(it->second)->setInstanceTransform(instance, transform);
+	}
+}
+
+void OpenGLModelRenderer::setInstanceSkinningMatrices(
+	ModelInstanceId instance,
+	const std::vector<glm::mat4>& skinning_matrices
+) {
+	const auto it{instance_models_.find(instance)};
+	if (it != instance_models_.end()) {
+		models_.at(it->second)->setInstanceSkinningMatrices(instance, skinning_matrices);
+	}
+}
+
+void OpenGLModelRenderer::removeInstance(ModelInstanceId instance) {
+	const auto it{instance_models_.find(instance)};
+	if (it == instance_models_.end()) {
+		return;
+	}
+	const auto model_it{models_.find(it->second)};
+	model_it->second->removeInstance(instance);
+	if (model_it->second->getInstanceCount() == 0u) {
+		// Queued uploads of the model only hold weak pointers, they are skipped
+		models_.erase(model_it);
+	}
+	instance_models_.erase(it);
+}
+
+OpenGLDrawableModel& OpenGLModelRenderer::getDrawable(const std::shared_ptr<Model>& model) {
+	const auto it{models_.find(model.get())};
+	if (it != models_.end()) {
+		return *it->second;
+	}
+
+	// The model's last drawable may have released the geometry a new one would upload
+	for (const std::shared_ptr<Mesh>& mesh : model->meshes_) {
+		if (!mesh->isGeometryResident()) {
+			throw std::invalid_argument("cannot draw a model whose geometry was released, load it again");
+		}
+	}
+	const auto drawable{std::make_shared<OpenGLDrawableModel>(model, mesh_shader_, texture_cache_, settings_)};
+	models_.emplace(model.get(), drawable);
+	queueUpload(drawable);
+	return *drawable;
+}
+
+void OpenGLModelRenderer::queueUpload(const std::shared_ptr<OpenGLDrawableModel>& model) {
+	// Every mesh is a separate job, so a big model is spread across several frames
+	const std::weak_ptr<OpenGLDrawableModel> weak_model{model};
+	for (std::size_t i{0}; i < model->getMeshCount(); ++i) {
+		upload_queue_.push([weak_model, i]() {
+			if (std::shared_ptr<OpenGLDrawableModel> model{weak_model.lock()}) {
+				model->uploadMesh(i);
+			}
+		});
+	}
 }
 
 void OpenGLModelRenderer::draw() const {
@@ -43,29 +150,23 @@ void OpenGLModelRenderer::draw() const {
 	glClearColor(0.1f, 0.1f, 0.15f, 1.0f);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-	// Common matrices
-	const glm::mat4 mat_model{glm::mat4(1.0f)};
-	const glm::mat4 mat_view{
-		glm::lookAt(
-			camera_->pos,
-			camera_->pos + camera_->lookAt,
-			camera_->viewUp
-		)
-	};
-	const glm::mat4 mat_projection{glm::perspective(
+	// Frame data, meshes take their model matrices from their instances
+	const double current_time{ServiceLocator::getInstance().getCurrentTime()};
+	uniform_blocks::Frame frame{};
+	frame.view = glm::lookAt(
+		camera_->pos,
+		camera_->pos + camera_->lookAt,
+		camera_->viewUp
+	);
+	frame.projection = glm::perspective(
 		camera_->fov,
 		static_cast<float>(screen_.width) / screen_.height,
 		camera_->clipNear,
 		camera_->clipFar
-	)};
-
-	// Setting up projection and view matrices
-	mesh_shader_.use();
-	mesh_shader_.setMat4("mat_model", mat_model);
-	mesh_shader_.setMat4("mat_view", mat_view);
-	mesh_shader_.setMat4("mat_projection", mat_projection);
-	mesh_shader_.setMat4("frag_mat_model", mat_model);
-	mesh_shader_.setMat4("frag_mat_view", mat_view);
+	);
+	frame.camera_position = camera_->pos;
+	frame.time = static_cast<float>(current_time);
+	frame_uniforms_.update(frame);
 
 	// Setting a single light
 	constexpr float LIGHT_ROTATION_RADIUS{30.0f};
@@ -75,19 +176,61 @@ void OpenGLModelRenderer::draw() const {
 		2.0f * glm::pi<float>() / LIGHT_ROTATION_PERIOD
 	};
 	const float light_rotation_angle{
-		static_cast<float>(LIGHT_ROTATION_ANGULAR_SPEED * ServiceLocator::getInstance().getCurrentTime())
+		static_cast<float>(LIGHT_ROTATION_ANGULAR_SPEED * current_time)
 	};
-	mesh_shader_.setVec3(
-		"light.position",
-		LIGHT_ROTATION_CENTER
-			+ glm::vec3(
-				LIGHT_ROTATION_RADIUS * cos(light_rotation_angle),
-				0.0f,
-				LIGHT_ROTATION_RADIUS * sin(light_rotation_angle)
-			)
-	);
+	uniform_blocks::Light light{};
+	light.position = LIGHT_ROTATION_CENTER
+		+ glm::vec3(
+			LIGHT_ROTATION_RADIUS * cos(light_rotation_angle),
+			0.0f,
+			LIGHT_ROTATION_RADIUS * sin(light_rotation_angle)
+		);
+	light.color_ambient = glm::vec3(0.5f);
+	light.color_diffuse = glm::vec3(0.5f);
+	light.color_specular = glm::vec3(1.0f);
+	light_uniforms_.update(light);
 
-	for (OpenGLDrawableModel model : models_) {
-		model.draw();
+	mesh_shader_.use();
+
+	// Every instance's bounds are culled at once, in whole SIMD vectors
+	const Frustum frustum{frame.projection * frame.view};
+	culling_spheres_.clear();
+	for (const auto& [model, drawable] : models_) {
+		drawable->addBounds(culling_spheres_);
+	}
+	frustum.cull(culling_spheres_);
+
+	// Every model's draws are sorted together, so draws with the same state follow each other across models
+	const LodSelector lod_selector{*camera_, screen_, settings_};
+	culling_stats_ = {};
+	render_queue_.clear();
+	for (const auto& [model, drawable] : models_) {
+		drawable->prepareInstances(lod_selector, frustum, culling_spheres_, culling_stats_);
+		drawable->submit(render_queue_);
 	}
+	render_queue_.sort();
+	render_queue_.execute();
 };
+
+MemoryUsage OpenGLModelRenderer::getMemoryUsage(const Model& model) const {
+	const auto it{models_.find(&model)};
+	if (it == models_.end()) {
+		return {};
+	}
+	return it->second->getMemoryUsage();
+}
+
+CullingStats OpenGLModelRenderer::getCullingStats() const {
+	return culling_stats_;
+}
+
+MemoryUsage OpenGLModelRenderer::getMemoryUsage() const {
+	MemoryUsage usage{texture_cache_.getMemoryUsage()};
+	for (const auto& [model, drawable] : models_) {
+		// Textures are already counted by the cache
+		MemoryUsage model_usage{drawable->getMemoryUsage()};
+		model_usage.bytes[static_cast<std::size_t>(MemoryDomain::Gpu)][static_cast<std::size_t>(MemoryCategory::Textures)] = 0u;
+		usage += model_usage;
+	}
+	return usage;
+}
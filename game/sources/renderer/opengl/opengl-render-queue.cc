@@ -0,0 +1,70 @@
+#include "game/headers/renderer/opengl/opengl-render-queue.hh"
+
+#include "game/headers/renderer/opengl/opengl-drawable-mesh.hh"
+#include "game/headers/renderer/opengl/opengl-drawable-model.hh"
+
+#include "external/glad/glad.h"
+
+OpenGLMeshUniforms::OpenGLMeshUniforms(const Shader& shader):
+		color_ambient{shader.getUniform<glm::vec3>("material.color_ambient")},
+		color_diffuse{shader.getUniform<glm::vec3>("material.color_diffuse")},
+		color_specular{shader.getUniform<glm::vec3>("material.color_specular")},
+		shininess{shader.getUniform<float>("material.shininess")},
+		vertex_position_scale{shader.getUniform<glm::vec3>("vertex_position_scale")},
+		vertex_position_offset{shader.getUniform<glm::vec3>("vertex_position_offset")},
+		vertex_octahedral_normals{shader.getUniform<bool>("vertex_octahedral_normals")},
+		skinned{shader.getUniform<bool>("skinned")},
+		joint_count{shader.getUniform<int>("joint_count")} {
+}
+
+OpenGLRenderQueue::OpenGLRenderQueue(const Shader& shader):
+		shader_{&shader},
+		uniforms_{shader} {
+}
+
+void OpenGLRenderQueue::clear() {
+	packets_.clear();
+	order_.clear();
+}
+
+void OpenGLRenderQueue::submit(std::uint64_t sort_key, const OpenGLDrawPacket& packet) {
+	order_.push_back({sort_key, static_cast<std::uint32_t>(packets_.size())});
+	packets_.push_back(packet);
+}
+
+void OpenGLRenderQueue::sort() {
+	radix_sort::sort(order_, scratch_);
+}
+
+void OpenGLRenderQueue::execute() const {
+	// What the previous packets left bound, a packet with the same state as them sets nothing
+	const OpenGLDrawableModel* skinning_model{nullptr};
+	const OpenGLDrawableMesh* material_mesh{nullptr};
+	const OpenGLDrawableMesh* textures_mesh{nullptr};
+	const OpenGLDrawableMesh* vertex_array_mesh{nullptr};
+	for (const SortEntry& entry : order_) {
+		const OpenGLDrawPacket& packet{packets_[entry.index]};
+		const OpenGLDrawableMesh& mesh{*packet.mesh};
+		if (packet.model != skinning_model && packet.model->bindSkinning(*shader_, uniforms_)) {
+			skinning_model = packet.model;
+		}
+		if (material_mesh == nullptr || !mesh.hasSameMaterial(*material_mesh)) {
+			mesh.setMaterial(*shader_, uniforms_);
+			material_mesh = &mesh;
+		}
+		if (textures_mesh == nullptr || !mesh.hasSameTextures(*textures_mesh)) {
+			mesh.bindTextures(*shader_);
+			textures_mesh = &mesh;
+		}
+		if (&mesh != vertex_array_mesh) {
+			mesh.bindVertexArray(*shader_, uniforms_);
+			vertex_array_mesh = &mesh;
+		}
+		mesh.drawLevel(packet.level);
+	}
+	glBindVertexArray(0);
+}
+
+std::size_t OpenGLRenderQueue::getPacketCount() const {
+	return packets_.size();
+}
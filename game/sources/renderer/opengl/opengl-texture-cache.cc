@@ -0,0 +1,352 @@
+#include "game/headers/renderer/opengl/opengl-texture-cache.hh"
+
+#include "game/headers/service-locator.hh"
+#include "game/headers/renderer/opengl/opengl-baked-texture.hh"
+#include "game/headers/texture/baked-texture.hh"
+
+#include "external/glad/glad.h"
+#define STB_IMAGE_IMPLEMENTATION
+#include "external/stb/stb_image.h"
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+OpenGLCachedTexture::OpenGLCachedTexture(unsigned int id): id_{id} {
+}
+
+OpenGLCachedTexture::~OpenGLCachedTexture() {
+	glDeleteTextures(1, &id_);
+}
+
+unsigned int OpenGLCachedTexture::getId() const {
+	return id_;
+}
+
+bool OpenGLCachedTexture::isLoaded() const {
+	return is_loaded_;
+}
+
+const MemoryUsage& OpenGLCachedTexture::getMemoryUsage() const {
+	return memory_.getUsage();
+}
+
+OpenGLTextureCache::~OpenGLTextureCache() {
+	// Workers may still be writing into mapped pixel buffers
+	for (PendingUpload& upload : pending_uploads_) {
+		if (upload.stage == UploadStage::Copying) {
+			upload.copied.wait();
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, upload.pixel_buffer.id);
+			glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+			free_pixel_buffers_.push_back(upload.pixel_buffer);
+		} else if (upload.stage == UploadStage::Transferring) {
+			glDeleteSync(static_cast<GLsync>(upload.transferred));
+			free_pixel_buffers_.push_back(upload.pixel_buffer);
+		} else {
+			upload.decoded.wait();
+		}
+	}
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	for (const PixelBuffer& buffer : free_pixel_buffers_) {
+		glDeleteBuffers(1, &buffer.id);
+	}
+}
+
+std::shared_ptr<OpenGLCachedTexture> OpenGLTextureCache::acquire(const std::string& path) {
+	const std::string resolved_path{resolvePath(path)};
+
+	std::weak_ptr<OpenGLCachedTexture>& cached{textures_[resolved_path]};
+	std::shared_ptr<OpenGLCachedTexture> texture{cached.lock()};
+	if (texture) {
+		return texture;
+	}
+
+	unsigned int texture_id;
+	glGenTextures(1, &texture_id);
+	glBindTexture(GL_TEXTURE_2D, texture_id);
+
+	// Not using std::make_shared, so the texture's memory is not held by the cache's weak pointer
+	texture = std::shared_ptr<OpenGLCachedTexture>(new OpenGLCachedTexture(texture_id));
+	cached = texture;
+
+	// Baked textures need neither decoding, nor mipmap generation
+	const std::size_t baked_size{loadBakedTexture(resolved_path)};
+	if (baked_size > 0) {
+		texture->is_loaded_ = true;
+		texture->memory_.set(MemoryDomain::Gpu, MemoryCategory::Textures, baked_size);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		return texture;
+	}
+
+	// The texture holds a placeholder texel until its image is uploaded
+	constexpr unsigned char PLACEHOLDER_TEXEL[4]{128, 128, 128, 255};
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, PLACEHOLDER_TEXEL);
+	texture->memory_.set(MemoryDomain::Gpu, MemoryCategory::Textures, sizeof(PLACEHOLDER_TEXEL));
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	PendingUpload upload;
+	upload.texture = texture;
+	upload.path = resolved_path;
+	upload.decoded = ServiceLocator::getInstance().getThreadPool().submit([resolved_path]() {
+		return decodeImage(resolved_path);
+	});
+	pending_uploads_.push_back(std::move(upload));
+
+	return texture;
+}
+
+void OpenGLTextureCache::update(double budget_ms) {
+	using Clock = std::chrono::steady_clock;
+	const Clock::time_point start{Clock::now()};
+	const std::chrono::duration<double, std::milli> budget{budget_ms};
+
+	// Entries of textures nobody holds anymore, otherwise every image ever loaded keeps its path
+	for (auto it{textures_.begin()}; it != textures_.end();) {
+		if (it->second.expired()) {
+			it = textures_.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	for (auto it{pending_uploads_.begin()}; it != pending_uploads_.end();) {
+		if (Clock::now() - start >= budget) {
+			break;
+		}
+
+		bool is_done{false};
+		if (it->stage == UploadStage::Decoding) {
+			if (it->decoded.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+				is_done = startCopy(*it);
+			}
+		} else if (it->stage == UploadStage::Copying) {
+			if (it->copied.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+				is_done = finishUpload(*it);
+			}
+		} else {
+			is_done = finishMipmaps(*it);
+		}
+
+		if (is_done) {
+			it = pending_uploads_.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+bool OpenGLTextureCache::startCopy(PendingUpload& upload) {
+	upload.image = upload.decoded.get();
+	if (!upload.image.pixels) {
+		ServiceLocator::getInstance().getLogger()->Error("cannot load a texture: " + upload.path);
+		return true;
+	}
+	if (upload.texture.expired()) {
+		// Nobody uses the texture anymore
+		return true;
+	}
+
+	const std::size_t image_size{
+		static_cast<std::size_t>(upload.image.width) * upload.image.height * upload.image.channels
+	};
+	upload.memory.set(MemoryDomain::Cpu, MemoryCategory::Staging, image_size);
+
+	// Orphaning the buffer's previous storage, so mapping it does not wait for earlier transfers
+	upload.pixel_buffer = acquirePixelBuffer();
+	resizePixelBuffer(upload.pixel_buffer, image_size);
+	void* mapped{glMapBufferRange(
+		GL_PIXEL_UNPACK_BUFFER, 0, image_size,
+		GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT
+	)};
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	if (mapped == nullptr) {
+		ServiceLocator::getInstance().getLogger()->Error("cannot map a pixel buffer for a texture: " + upload.path);
+		free_pixel_buffers_.push_back(upload.pixel_buffer);
+		return true;
+	}
+
+	// The copy into the mapped buffer runs on a worker
+	std::shared_ptr<unsigned char> pixels{upload.image.pixels};
+	upload.copied = ServiceLocator::getInstance().getThreadPool().submit([mapped, pixels, image_size]() {
+		std::memcpy(mapped, pixels.get(), image_size);
+	});
+	upload.stage = UploadStage::Copying;
+	return false;
+}
+
+bool OpenGLTextureCache::finishUpload(PendingUpload& upload) {
+	upload.copied.get();
+	upload.image.pixels.reset();
+	upload.memory.clear();
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, upload.pixel_buffer.id);
+	glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+	std::shared_ptr<OpenGLCachedTexture> texture{upload.texture.lock()};
+	if (!texture) {
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		free_pixel_buffers_.push_back(upload.pixel_buffer);
+		return true;
+	}
+
+	GLenum format{GL_RGB};
+	if (upload.image.channels == 1) {
+		format = GL_RED;
+	} else if (upload.image.channels == 2) {
+		format = GL_RG;
+	} else if (upload.image.channels == 4) {
+		format = GL_RGBA;
+	}
+
+	glBindTexture(GL_TEXTURE_2D, texture->getId());
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	// Sampling the base level only, until the mipmaps are generated
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	// Rows are tightly packed, whatever the image's width
+	GLint unpack_alignment;
+	glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpack_alignment);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	// Sourcing the pixels from the bound pixel buffer, at offset zero
+	glTexImage2D(
+		GL_TEXTURE_2D, 0, format,
+		upload.image.width, upload.image.height, 0,
+		format, GL_UNSIGNED_BYTE, (GLvoid*) 0
+	);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, unpack_alignment);
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	texture->is_loaded_ = true;
+
+	const std::size_t level_size{
+		static_cast<std::size_t>(upload.image.width) * upload.image.height * upload.image.channels
+	};
+	texture->memory_.set(MemoryDomain::Gpu, MemoryCategory::Textures, level_size);
+
+	// Generating the mipmaps now would wait for the transfer, so they are left for a later frame
+	upload.transferred = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	upload.stage = UploadStage::Transferring;
+	return false;
+}
+
+bool OpenGLTextureCache::finishMipmaps(PendingUpload& upload) {
+	const GLsync fence{static_cast<GLsync>(upload.transferred)};
+	// Flushing, so the fence is signaled without waiting for the end of the frame
+	if (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0) == GL_TIMEOUT_EXPIRED) {
+		return false;
+	}
+	glDeleteSync(fence);
+	upload.transferred = nullptr;
+	free_pixel_buffers_.push_back(upload.pixel_buffer);
+
+	std::shared_ptr<OpenGLCachedTexture> texture{upload.texture.lock()};
+	if (!texture) {
+		return true;
+	}
+
+	glBindTexture(GL_TEXTURE_2D, texture->getId());
+	glGenerateMipmap(GL_TEXTURE_2D);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	// The mipmap chain adds a third, drivers may pad the texels further
+	const std::size_t level_size{
+		static_cast<std::size_t>(upload.image.width) * upload.image.height * upload.image.channels
+	};
+	texture->memory_.set(MemoryDomain::Gpu, MemoryCategory::Textures, level_size + level_size / 3u);
+	return true;
+}
+
+std::size_t OpenGLTextureCache::loadBakedTexture(const std::string& path) {
+	const VirtualFileSystem& file_system{ServiceLocator::getInstance().getFileSystem()};
+	if (!BakedTexture::isAvailable(file_system, path)) {
+		return 0;
+	}
+	std::size_t size{0};
+	try {
+		const BakedTexture baked_texture{file_system, BakedTexture::getBakedPath(path)};
+		if (!upload_baked_texture(baked_texture)) {
+			return 0;
+		}
+		for (const BakedMipLevel& level : baked_texture.getMipLevels()) {
+			size += level.size;
+		}
+	} catch (const std::runtime_error& e) {
+		ServiceLocator::getInstance().getLogger()->Warning(std::string("ignoring a baked texture: ") + e.what());
+		return 0;
+	}
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	return size;
+}
+
+OpenGLTextureCache::PixelBuffer OpenGLTextureCache::acquirePixelBuffer() {
+	if (!free_pixel_buffers_.empty()) {
+		const PixelBuffer buffer{free_pixel_buffers_.back()};
+		free_pixel_buffers_.pop_back();
+		return buffer;
+	}
+	PixelBuffer buffer;
+	glGenBuffers(1, &buffer.id);
+	return buffer;
+}
+
+void OpenGLTextureCache::resizePixelBuffer(PixelBuffer& buffer, std::size_t size) {
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer.id);
+	glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+
+	pixel_buffer_bytes_ = pixel_buffer_bytes_ - buffer.size + size;
+	buffer.size = size;
+	staging_memory_.set(MemoryDomain::Gpu, MemoryCategory::Staging, pixel_buffer_bytes_);
+}
+
+MemoryUsage OpenGLTextureCache::getMemoryUsage() const {
+	MemoryUsage usage{staging_memory_.getUsage()};
+	for (const auto& [path, cached] : textures_) {
+		if (const std::shared_ptr<OpenGLCachedTexture> texture{cached.lock()}) {
+			usage += texture->getMemoryUsage();
+		}
+	}
+	for (const PendingUpload& upload : pending_uploads_) {
+		usage += upload.memory.getUsage();
+	}
+	return usage;
+}
+
+std::string OpenGLTextureCache::resolvePath(const std::string& path) {
+	std::error_code error;
+	const std::filesystem::path resolved{std::filesystem::weakly_canonical(path, error)};
+	if (error) {
+		return std::filesystem::path(path).lexically_normal().string();
+	}
+	return resolved.string();
+}
+
+OpenGLTextureCache::DecodedImage OpenGLTextureCache::decodeImage(const std::string& path) {
+	DecodedImage image;
+	AssetFile file;
+	try {
+		file = ServiceLocator::getInstance().getFileSystem().open(path);
+	} catch (const std::runtime_error&) {
+		return image;
+	}
+	unsigned char* data{stbi_load_from_memory(
+		file.data(), static_cast<int>(file.size()), &image.width, &image.height, &image.channels, 0
+	)};
+	if (data != nullptr) {
+		image.pixels = std::shared_ptr<unsigned char>(data, stbi_image_free);
+	}
+	return image;
+}
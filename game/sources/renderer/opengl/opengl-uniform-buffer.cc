@@ -0,0 +1,83 @@
+#include "game/headers/renderer/opengl/opengl-uniform-buffer.hh"
+
+#include "external/glad/glad.h"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+	// Nanoseconds of every wait for a fence, the wait is repeated until it is signaled
+	constexpr GLuint64 FENCE_WAIT_TIMEOUT{1000000u};
+
+} // namespace
+
+OpenGLUniformBuffer::~OpenGLUniformBuffer() {
+	for (void* fence : fences_) {
+		if (fence != nullptr) {
+			glDeleteSync(static_cast<GLsync>(fence));
+		}
+	}
+	if (buffer_ != 0u) {
+		glDeleteBuffers(1, &buffer_);
+	}
+}
+
+void OpenGLUniformBuffer::init(unsigned int binding, std::size_t size) {
+	GLint alignment{1};
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	const std::size_t region_alignment{static_cast<std::size_t>(alignment > 0 ? alignment : 1)};
+
+	binding_ = binding;
+	size_ = size;
+	region_stride_ = (size + region_alignment - 1u) / region_alignment * region_alignment;
+	glGenBuffers(1, &buffer_);
+	glBindBuffer(GL_UNIFORM_BUFFER, buffer_);
+	glBufferData(GL_UNIFORM_BUFFER, region_stride_ * REGION_COUNT, NULL, GL_STREAM_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void OpenGLUniformBuffer::update(const void* data, std::size_t size) {
+	if (size != size_) {
+		throw std::invalid_argument("a uniform buffer's update must be the size of its block");
+	}
+
+	// Commands issued since the last update are the ones which read its region
+	if (has_written_) {
+		fences_[region_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		region_ = (region_ + 1u) % REGION_COUNT;
+	}
+	waitForRegion(region_);
+
+	const GLintptr offset{static_cast<GLintptr>(region_ * region_stride_)};
+	glBindBuffer(GL_UNIFORM_BUFFER, buffer_);
+	void* region{
+		glMapBufferRange(
+			GL_UNIFORM_BUFFER,
+			offset,
+			static_cast<GLsizeiptr>(size_),
+			GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT
+		)
+	};
+	if (region != nullptr) {
+		std::memcpy(region, data, size_);
+		glUnmapBuffer(GL_UNIFORM_BUFFER);
+	}
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	glBindBufferRange(GL_UNIFORM_BUFFER, binding_, buffer_, offset, static_cast<GLsizeiptr>(size_));
+	has_written_ = true;
+}
+
+void OpenGLUniformBuffer::waitForRegion(std::size_t region) {
+	GLsync fence{static_cast<GLsync>(fences_[region])};
+	if (fence == nullptr) {
+		return;
+	}
+	// The first wait flushes the commands, so the fence is sure to be signaled eventually
+	GLenum status{glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_WAIT_TIMEOUT)};
+	while (status == GL_TIMEOUT_EXPIRED) {
+		status = glClientWaitSync(fence, 0, FENCE_WAIT_TIMEOUT);
+	}
+	glDeleteSync(fence);
+	fences_[region] = nullptr;
+}
@@ -0,0 +1,28 @@
+#include "game/headers/renderer/opengl/opengl-upload-queue.hh"
+
+#include <chrono>
+#include <utility>
+
+void OpenGLUploadQueue::push(Job job) {
+	jobs_.push_back(std::move(job));
+}
+
+void OpenGLUploadQueue::process(double budget_ms) {
+	using Clock = std::chrono::steady_clock;
+	const Clock::time_point start{Clock::now()};
+	const std::chrono::duration<double, std::milli> budget{budget_ms};
+
+	while (!jobs_.empty()) {
+		Job job{std::move(jobs_.front())};
+		jobs_.pop_front();
+		job();
+
+		if (Clock::now() - start >= budget) {
+			break;
+		}
+	}
+}
+
+bool OpenGLUploadQueue::isEmpty() const {
+	return jobs_.empty();
+}
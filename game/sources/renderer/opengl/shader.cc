@@ -1,34 +1,121 @@
 #include "game/headers/renderer/opengl/shader.hh"
 
+#include "game/headers/renderer/opengl/uniform-blocks.hh"
+#include "game/headers/service-locator.hh"
+
 #include "external/glad/glad.h"
 
 #include "external/glm/glm/gtc/type_ptr.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+	bool isSamplerType(unsigned int type) {
+		switch (type) {
+			case GL_SAMPLER_1D:
+			case GL_SAMPLER_2D:
+			case GL_SAMPLER_3D:
+			case GL_SAMPLER_CUBE:
+			case GL_SAMPLER_2D_SHADOW:
+			case GL_SAMPLER_2D_ARRAY:
+			case GL_SAMPLER_2D_MULTISAMPLE:
+			case GL_SAMPLER_BUFFER:
+			case GL_INT_SAMPLER_BUFFER:
+			case GL_UNSIGNED_INT_SAMPLER_BUFFER:
+				return true;
+			default:
+				return false;
+		}
+	}
+
+	// Bytes the value cache keeps for a uniform, the size of any value type which can set it
+	std::size_t getValueSize(unsigned int type) {
+		switch (type) {
+			case GL_FLOAT_VEC3:
+				return sizeof(glm::vec3);
+			case GL_FLOAT_MAT3:
+				return sizeof(glm::mat3);
+			case GL_FLOAT_MAT4:
+				return sizeof(glm::mat4);
+			default:
+				return sizeof(int);
+		}
+	}
+
+	// Whether a uniform of the GL type can be set with values of T
+	template <typename T>
+	bool isSettableWith(unsigned int type);
+
+	template <>
+	bool isSettableWith<bool>(unsigned int type) {
+		return type == GL_BOOL;
+	}
+
+	template <>
+	bool isSettableWith<int>(unsigned int type) {
+		return type == GL_INT || isSamplerType(type);
+	}
+
+	template <>
+	bool isSettableWith<float>(unsigned int type) {
+		return type == GL_FLOAT;
+	}
+
+	template <>
+	bool isSettableWith<glm::vec3>(unsigned int type) {
+		return type == GL_FLOAT_VEC3;
+	}
+
+	template <>
+	bool isSettableWith<glm::mat3>(unsigned int type) {
+		return type == GL_FLOAT_MAT3;
+	}
+
+	template <>
+	bool isSettableWith<glm::mat4>(unsigned int type) {
+		return type == GL_FLOAT_MAT4;
+	}
+
+	void upload(int location, bool value) {
+		glUniform1i(location, value);
+	}
+
+	void upload(int location, int value) {
+		glUniform1i(location, value);
+	}
+
+	void upload(int location, float value) {
+		glUniform1f(location, value);
+	}
+
+	void upload(int location, const glm::vec3& value) {
+		glUniform3fv(location, 1, glm::value_ptr(value));
+	}
+
+	void upload(int location, const glm::mat3& value) {
+		glUniformMatrix3fv(location, 1, GL_FALSE, glm::value_ptr(value));
+	}
+
+	void upload(int location, const glm::mat4& value) {
+		glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value));
+	}
+
+} // namespace
+
 Shader::Shader(const std::string& vertex_shader_path, const std::string& fragment_shader_path) {
-	// 1. retrieve the vertex/fragment source code from filePath
+	// 1. retrieve the vertex/fragment source code through the virtual file system
 	std::string vertexCode;
 	std::string fragmentCode;
-	std::ifstream vShaderFile;
-	std::ifstream fShaderFile;
-	// ensure ifstream objects can throw exceptions:
-	vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-	fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
 	try {
-		// open files
-		vShaderFile.open(vertex_shader_path.c_str());
-		fShaderFile.open(fragment_shader_path.c_str());
-		std::stringstream vShaderStream, fShaderStream;
-		// read file's buffer contents into streams
-		vShaderStream << vShaderFile.rdbuf();
-		fShaderStream << fShaderFile.rdbuf();
-		// close file handlers
-		vShaderFile.close();
-		fShaderFile.close();
-		// convert stream into string
-		vertexCode   = vShaderStream.str();
-		fragmentCode = fShaderStream.str();
-	} catch (std::ifstream::failure &e) {
-		std::cout << "Shader files were not read successfully!" << std::endl;
+		const VirtualFileSystem& file_system{ServiceLocator::getInstance().getFileSystem()};
+		vertexCode = std::string(file_system.open(vertex_shader_path).getText());
+		fragmentCode = std::string(file_system.open(fragment_shader_path).getText());
+	} catch (const std::runtime_error& e) {
+		std::cout << "Shader files were not read successfully! " << e.what() << std::endl;
 		throw;
 	}
 	const char* vShaderCode = vertexCode.c_str();
@@ -70,43 +157,97 @@ Shader::Shader(const std::string& vertex_shader_path, const std::string& fragmen
 
 	glDeleteShader(vertexShader);
 	glDeleteShader(fragmentShader);
+
+	reflectUniforms();
+	bindUniformBlocks();
 }
 
 void Shader::use() const {
 	glUseProgram(id);
 }
 
-void Shader::setBool(const std::string& name, bool value) const {
-	glUniform1i(glGetUniformLocation(id, name.c_str()), (bool) value);
+template <typename T>
+ShaderUniform<T> Shader::getUniform(const std::string& name) const {
+	const auto it{uniform_indices_.find(name)};
+	if (it == uniform_indices_.end()) {
+		return {};
+	}
+	if (!isSettableWith<T>(uniforms_[it->second].type)) {
+		throw std::invalid_argument("the shader's uniform " + name + " cannot be set with values of the requested type");
+	}
+	return {it->second};
 }
 
-void Shader::setInt(const std::string& name, int value) const {
-	glUniform1i(glGetUniformLocation(id, name.c_str()), value);
+template <typename T>
+void Shader::set(ShaderUniform<T> uniform, const T& value) const {
+	if (!uniform.isActive()) {
+		return;
+	}
+	UniformInfo& info{uniforms_[uniform.index]};
+	unsigned char* cached_value{values_.data() + info.value_offset};
+	if (info.has_value && std::memcmp(cached_value, &value, sizeof(T)) == 0) {
+		return;
+	}
+	std::memcpy(cached_value, &value, sizeof(T));
+	info.has_value = true;
+	upload(info.location, value);
 }
 
-void Shader::setFloat(const std::string& name, float value) const {
-	glUniform1f(glGetUniformLocation(id, name.c_str()), value);
-}
+template ShaderUniform<bool> Shader::getUniform<bool>(const std::string& name) const;
+template ShaderUniform<int> Shader::getUniform<int>(const std::string& name) const;
+template ShaderUniform<float> Shader::getUniform<float>(const std::string& name) const;
+template ShaderUniform<glm::vec3> Shader::getUniform<glm::vec3>(const std::string& name) const;
+template ShaderUniform<glm::mat3> Shader::getUniform<glm::mat3>(const std::string& name) const;
+template ShaderUniform<glm::mat4> Shader::getUniform<glm::mat4>(const std::string& name) const;
 
-void Shader::setVec3(const std::string& name, glm::vec3 value) const {
-	glUniform3f(glGetUniformLocation(id, name.c_str()),
-		value.x, value.y, value.z);
-}
+template void Shader::set<bool>(ShaderUniform<bool> uniform, const bool& value) const;
+template void Shader::set<int>(ShaderUniform<int> uniform, const int& value) const;
+template void Shader::set<float>(ShaderUniform<float> uniform, const float& value) const;
+template void Shader::set<glm::vec3>(ShaderUniform<glm::vec3> uniform, const glm::vec3& value) const;
+template void Shader::set<glm::mat3>(ShaderUniform<glm::mat3> uniform, const glm::mat3& value) const;
+template void Shader::set<glm::mat4>(ShaderUniform<glm::mat4> uniform, const glm::mat4& value) const;
 
-void Shader::setMat4(const std::string& name, glm::mat4 value) const {
-	glUniformMatrix4fv(
-		glGetUniformLocation(id, name.c_str()),
-		1,
-		GL_FALSE,
-		glm::value_ptr(value)
-	);
+void Shader::reflectUniforms() {
+	int uniform_count{0};
+	int max_name_length{0};
+	glGetProgramiv(id, GL_ACTIVE_UNIFORMS, &uniform_count);
+	glGetProgramiv(id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_name_length);
+
+	std::vector<char> name_buffer(static_cast<std::size_t>(std::max(max_name_length, 1)));
+	std::size_t value_offset{0u};
+	for (int i{0}; i < uniform_count; ++i) {
+		GLsizei name_length{0};
+		GLint size{0};
+		GLenum type{0u};
+		glGetActiveUniform(id, static_cast<GLuint>(i), static_cast<GLsizei>(name_buffer.size()), &name_length, &size, &type, name_buffer.data());
+		std::string name(name_buffer.data(), static_cast<std::size_t>(name_length));
+
+		// Uniform block members have no location of their own
+		const int location{glGetUniformLocation(id, name.c_str())};
+		if (location < 0) {
+			continue;
+		}
+		const std::size_t array_suffix{name.rfind("[0]")};
+		if (array_suffix != std::string::npos && array_suffix + 3u == name.size()) {
+			name.resize(array_suffix);
+		}
+
+		uniform_indices_.emplace(name, static_cast<std::uint32_t>(uniforms_.size()));
+		uniforms_.push_back({std::move(name), type, location, value_offset, false});
+		value_offset += getValueSize(type);
+	}
+	values_.resize(value_offset);
 }
 
-void Shader::setMat3(const std::string& name, glm::mat3 value) const {
-	glUniformMatrix3fv(
-		glGetUniformLocation(id, name.c_str()),
-		1,
-		GL_FALSE,
-		glm::value_ptr(value)
-	);
+void Shader::bindUniformBlocks() const {
+	const std::pair<const char*, unsigned int> blocks[]{
+		{uniform_blocks::FRAME_BLOCK_NAME, uniform_blocks::FRAME_BINDING},
+		{uniform_blocks::LIGHT_BLOCK_NAME, uniform_blocks::LIGHT_BINDING}
+	};
+	for (const auto& [name, binding] : blocks) {
+		const unsigned int index{glGetUniformBlockIndex(id, name)};
+		if (index != GL_INVALID_INDEX) {
+			glUniformBlockBinding(id, index, binding);
+		}
+	}
 }
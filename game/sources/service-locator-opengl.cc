@@ -0,0 +1,14 @@
+#include "game/headers/service-locator.hh"
+
+#include "game/headers/renderer/opengl/opengl-model-renderer.hh"
+#include "external/glfw/include/GLFW/glfw3.h"
+
+// Services of the window, and its OpenGL context, apart so offline tools link without them
+
+std::unique_ptr<ModelRenderer> ServiceLocator::getModelRenderer() const {
+	return std::make_unique<OpenGLModelRenderer>();
+}
+
+double ServiceLocator::getCurrentTime() const {
+	return glfwGetTime();
+}
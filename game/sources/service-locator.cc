@@ -1,28 +1,43 @@
 #include "game/headers/service-locator.hh"
 
 #include "game/headers/model/assimp/assimp-model-loader.hh"
-#include "game/headers/renderer/opengl/opengl-model-renderer.hh"
+#include "game/headers/model/obj/obj-model-loader.hh"
 #include "game/headers/utility/logger.hh"
 #include "game/headers/utility/console-logger.hh"
-#include "external/glfw/include/GLFW/glfw3.h"
+
+#include <algorithm>
+#include <thread>
 
 ServiceLocator& ServiceLocator::getInstance() {
 	static ServiceLocator* locator{new ServiceLocator()};
 	return *locator;
 }
 
-std::unique_ptr<ModelLoader> ServiceLocator::getModelLoader() const {
-	return std::make_unique<AssimpModelLoader>();
-}
-
-std::unique_ptr<ModelRenderer> ServiceLocator::getModelRenderer() const {
-	return std::make_unique<OpenGLModelRenderer>();
+std::unique_ptr<ModelLoader> ServiceLocator::getModelLoader(ModelLoaderType type) const {
+	if (type == ModelLoaderType::Assimp) {
+		return std::make_unique<AssimpModelLoader>();
+	}
+	return std::make_unique<ObjModelLoader>(std::make_unique<AssimpModelLoader>());
 }
 
 std::unique_ptr<Logger> ServiceLocator::getLogger() const {
 	return std::make_unique<ConsoleLogger>();
 }
 
-double ServiceLocator::getCurrentTime() const {
-	return glfwGetTime();
+ThreadPool& ServiceLocator::getThreadPool() const {
+	// The calling thread usually takes part in the work, so leave one core for it, but keep
+	// a worker on a single core, or when the core count is unknown, so loads still finish
+	static ThreadPool pool{std::max(2u, std::thread::hardware_concurrency()) - 1u};
+	return pool;
+}
+
+MemoryTracker& ServiceLocator::getMemoryTracker() const {
+	// Never destroyed, so records outliving main() can still report to it
+	static MemoryTracker* tracker{new MemoryTracker()};
+	return *tracker;
+}
+
+VirtualFileSystem& ServiceLocator::getFileSystem() const {
+	static VirtualFileSystem file_system;
+	return file_system;
 }
@@ -0,0 +1,118 @@
+#include "game/headers/texture/baked-texture.hh"
+
+#include "game/headers/utility/binary-stream.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+	constexpr char BAKED_TEXTURE_MAGIC[8]{'F', 'P', 'S', 'T', 'E', 'X', '\0', '\0'};
+	constexpr std::uint32_t BAKED_TEXTURE_VERSION{1u};
+	constexpr const char* BAKED_TEXTURE_EXTENSION{".btex"};
+	// Mip levels start at aligned offsets, so they can be handed to the driver as they are
+	constexpr std::size_t MIP_LEVEL_ALIGNMENT{16};
+
+	struct MipLevelRecord {
+		std::uint32_t width;
+		std::uint32_t height;
+		std::uint64_t offset;
+		std::uint64_t size;
+	};
+
+} // namespace
+
+BakedTexture::BakedTexture(const VirtualFileSystem& file_system, const std::string& path):
+		file_{file_system.open(path)} {
+	try {
+		BinaryReader reader{file_.data(), file_.size()};
+
+		const unsigned char* magic{reader.skip(sizeof(BAKED_TEXTURE_MAGIC))};
+		if (std::memcmp(magic, BAKED_TEXTURE_MAGIC, sizeof(BAKED_TEXTURE_MAGIC)) != 0) {
+			throw std::runtime_error("not a baked texture");
+		}
+		if (reader.read<std::uint32_t>() != BAKED_TEXTURE_VERSION) {
+			throw std::runtime_error("unsupported baked texture version");
+		}
+		format_ = static_cast<BakedTextureFormat>(reader.read<std::uint32_t>());
+		const std::uint32_t mip_count{reader.read<std::uint32_t>()};
+
+		mip_levels_.reserve(mip_count);
+		for (std::uint32_t i{0u}; i < mip_count; ++i) {
+			const MipLevelRecord record{reader.read<MipLevelRecord>()};
+			if (record.offset > file_.size() || record.size > file_.size() - record.offset) {
+				throw std::runtime_error("mip level exceeds the file");
+			}
+			mip_levels_.push_back({record.width, record.height, file_.data() + record.offset, record.size});
+		}
+	} catch (const std::out_of_range&) {
+		throw std::runtime_error("truncated baked texture: " + path);
+	} catch (const std::runtime_error& e) {
+		throw std::runtime_error(std::string(e.what()) + ": " + path);
+	}
+}
+
+BakedTextureFormat BakedTexture::getFormat() const {
+	return format_;
+}
+
+const std::vector<BakedMipLevel>& BakedTexture::getMipLevels() const {
+	return mip_levels_;
+}
+
+std::string BakedTexture::getBakedPath(const std::string& source_path) {
+	return source_path + BAKED_TEXTURE_EXTENSION;
+}
+
+bool BakedTexture::isAvailable(const VirtualFileSystem& file_system, const std::string& source_path) {
+	AssetStatus baked_status;
+	if (!file_system.stat(getBakedPath(source_path), baked_status)) {
+		return false;
+	}
+	AssetStatus source_status;
+	// A baked texture without its source is still usable
+	return !file_system.stat(source_path, source_status)
+		|| baked_status.modification_time >= source_status.modification_time;
+}
+
+void BakedTexture::write(
+	const std::string& path,
+	BakedTextureFormat format,
+	std::uint32_t width,
+	std::uint32_t height,
+	const std::vector<std::vector<std::uint8_t>>& mip_levels
+) {
+	BinaryWriter writer;
+	writer.writeArray(BAKED_TEXTURE_MAGIC, sizeof(BAKED_TEXTURE_MAGIC));
+	writer.write(BAKED_TEXTURE_VERSION);
+	writer.write(static_cast<std::uint32_t>(format));
+	writer.write(static_cast<std::uint32_t>(mip_levels.size()));
+
+	// Mip level records, followed by the aligned mip level data
+	const std::size_t records_end{writer.size() + mip_levels.size() * sizeof(MipLevelRecord)};
+	std::uint64_t offset{records_end};
+	for (std::size_t i{0}; i < mip_levels.size(); ++i) {
+		offset = (offset + MIP_LEVEL_ALIGNMENT - 1) / MIP_LEVEL_ALIGNMENT * MIP_LEVEL_ALIGNMENT;
+		const MipLevelRecord record{
+			std::max(1u, width >> i),
+			std::max(1u, height >> i),
+			offset,
+			mip_levels[i].size()
+		};
+		writer.write(record);
+		offset += mip_levels[i].size();
+	}
+	for (const std::vector<std::uint8_t>& level : mip_levels) {
+		writer.align(MIP_LEVEL_ALIGNMENT);
+		writer.writeArray(level.data(), level.size());
+	}
+
+	std::ofstream file{path, std::ios::binary | std::ios::trunc};
+	const std::vector<unsigned char>& buffer{writer.getBuffer()};
+	file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+	if (!file) {
+		throw std::runtime_error("cannot write a baked texture: " + path);
+	}
+}
@@ -0,0 +1,261 @@
+#include "game/headers/texture/block-compression.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+	std::uint16_t packRGB565(const float color[3]) {
+		const int r{static_cast<int>(std::lround(std::clamp(color[0], 0.0f, 255.0f) * 31.0f / 255.0f))};
+		const int g{static_cast<int>(std::lround(std::clamp(color[1], 0.0f, 255.0f) * 63.0f / 255.0f))};
+		const int b{static_cast<int>(std::lround(std::clamp(color[2], 0.0f, 255.0f) * 31.0f / 255.0f))};
+		return static_cast<std::uint16_t>((r << 11) | (g << 5) | b);
+	}
+
+	void unpackRGB565(std::uint16_t packed, int color[3]) {
+		const int r{(packed >> 11) & 31};
+		const int g{(packed >> 5) & 63};
+		const int b{packed & 31};
+		color[0] = (r << 3) | (r >> 2);
+		color[1] = (g << 2) | (g >> 4);
+		color[2] = (b << 3) | (b >> 2);
+	}
+
+	/**
+	 * Finds the block's principal color axis by power iteration on
+	 * the color covariance matrix, and returns the extreme colors along it.
+	 */
+	void findColorEndpoints(const std::uint8_t rgba[64], float max_color[3], float min_color[3]) {
+		float mean[3]{0.0f, 0.0f, 0.0f};
+		for (int i{0}; i < 16; ++i) {
+			for (int c{0}; c < 3; ++c) {
+				mean[c] += rgba[4 * i + c];
+			}
+		}
+		for (float& m : mean) {
+			m /= 16.0f;
+		}
+
+		float covariance[6]{0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+		for (int i{0}; i < 16; ++i) {
+			const float r{rgba[4 * i] - mean[0]};
+			const float g{rgba[4 * i + 1] - mean[1]};
+			const float b{rgba[4 * i + 2] - mean[2]};
+			covariance[0] += r * r;
+			covariance[1] += r * g;
+			covariance[2] += r * b;
+			covariance[3] += g * g;
+			covariance[4] += g * b;
+			covariance[5] += b * b;
+		}
+
+		// Seeding with the covariance column of largest norm, as a fixed seed such as the gray axis
+		// can be orthogonal to the principal axis, for example in isoluminant blocks
+		const float columns[3][3]{
+			{covariance[0], covariance[1], covariance[2]},
+			{covariance[1], covariance[3], covariance[4]},
+			{covariance[2], covariance[4], covariance[5]}
+		};
+		int seed_column{0};
+		float seed_norm{0.0f};
+		for (int column{0}; column < 3; ++column) {
+			const float norm{
+				columns[column][0] * columns[column][0]
+					+ columns[column][1] * columns[column][1]
+					+ columns[column][2] * columns[column][2]
+			};
+			if (norm > seed_norm) {
+				seed_norm = norm;
+				seed_column = column;
+			}
+		}
+
+		// Every texel has the same color
+		if (seed_norm == 0.0f) {
+			for (int c{0}; c < 3; ++c) {
+				max_color[c] = rgba[c];
+				min_color[c] = rgba[c];
+			}
+			return;
+		}
+
+		float axis[3]{columns[seed_column][0], columns[seed_column][1], columns[seed_column][2]};
+		for (int iteration{0}; iteration < 8; ++iteration) {
+			const float x{covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2]};
+			const float y{covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2]};
+			const float z{covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2]};
+			const float length{std::max({std::fabs(x), std::fabs(y), std::fabs(z)})};
+			if (length < 1e-6f) {
+				break;
+			}
+			axis[0] = x / length;
+			axis[1] = y / length;
+			axis[2] = z / length;
+		}
+
+		float min_projection{std::numeric_limits<float>::max()};
+		float max_projection{std::numeric_limits<float>::lowest()};
+		for (int i{0}; i < 16; ++i) {
+			const float projection{
+				(rgba[4 * i] - mean[0]) * axis[0]
+					+ (rgba[4 * i + 1] - mean[1]) * axis[1]
+					+ (rgba[4 * i + 2] - mean[2]) * axis[2]
+			};
+			min_projection = std::min(min_projection, projection);
+			max_projection = std::max(max_projection, projection);
+		}
+
+		const float axis_length_squared{axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]};
+		for (int c{0}; c < 3; ++c) {
+			max_color[c] = mean[c] + axis[c] * max_projection / axis_length_squared;
+			min_color[c] = mean[c] + axis[c] * min_projection / axis_length_squared;
+		}
+	}
+
+	int colorDistance(const std::uint8_t* texel, const int color[3]) {
+		const int r{texel[0] - color[0]};
+		const int g{texel[1] - color[1]};
+		const int b{texel[2] - color[2]};
+		return r * r + g * g + b * b;
+	}
+
+	void writeLittleEndian16(std::uint8_t* destination, std::uint16_t value) {
+		destination[0] = static_cast<std::uint8_t>(value & 0xff);
+		destination[1] = static_cast<std::uint8_t>(value >> 8);
+	}
+
+	void extractBlock(const std::uint8_t* rgba, int width, int height, int block_x, int block_y, std::uint8_t block[64]) {
+		for (int y{0}; y < 4; ++y) {
+			const int source_y{std::min(4 * block_y + y, height - 1)};
+			for (int x{0}; x < 4; ++x) {
+				const int source_x{std::min(4 * block_x + x, width - 1)};
+				std::memcpy(block + 4 * (4 * y + x), rgba + 4 * (static_cast<std::size_t>(source_y) * width + source_x), 4);
+			}
+		}
+	}
+
+	template <typename CompressBlock>
+	std::vector<std::uint8_t> compressImage(const std::uint8_t* rgba, int width, int height,
+			std::size_t block_size, CompressBlock compress_block) {
+		const int blocks_x{std::max(1, (width + 3) / 4)};
+		const int blocks_y{std::max(1, (height + 3) / 4)};
+		std::vector<std::uint8_t> compressed(static_cast<std::size_t>(blocks_x) * blocks_y * block_size);
+		std::uint8_t block[64];
+		for (int y{0}; y < blocks_y; ++y) {
+			for (int x{0}; x < blocks_x; ++x) {
+				extractBlock(rgba, width, height, x, y, block);
+				compress_block(block, compressed.data() + (static_cast<std::size_t>(y) * blocks_x + x) * block_size);
+			}
+		}
+		return compressed;
+	}
+
+} // namespace
+
+void block_compression::compressBC1Block(const std::uint8_t rgba[64], std::uint8_t block[BC1_BLOCK_SIZE]) {
+	float max_color[3];
+	float min_color[3];
+	findColorEndpoints(rgba, max_color, min_color);
+
+	std::uint16_t color0{packRGB565(max_color)};
+	std::uint16_t color1{packRGB565(min_color)};
+	if (color0 < color1) {
+		std::swap(color0, color1);
+	}
+	writeLittleEndian16(block, color0);
+	writeLittleEndian16(block + 2, color1);
+
+	if (color0 == color1) {
+		// A single color block, every texel uses the first endpoint
+		std::memset(block + 4, 0, 4);
+		return;
+	}
+
+	// Four color mode, which requires color0 > color1
+	int palette[4][3];
+	unpackRGB565(color0, palette[0]);
+	unpackRGB565(color1, palette[1]);
+	for (int c{0}; c < 3; ++c) {
+		palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+		palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+	}
+
+	std::uint32_t indices{0};
+	for (int i{0}; i < 16; ++i) {
+		int best_index{0};
+		int best_distance{std::numeric_limits<int>::max()};
+		for (int p{0}; p < 4; ++p) {
+			const int distance{colorDistance(rgba + 4 * i, palette[p])};
+			if (distance < best_distance) {
+				best_distance = distance;
+				best_index = p;
+			}
+		}
+		indices |= static_cast<std::uint32_t>(best_index) << (2 * i);
+	}
+	for (int i{0}; i < 4; ++i) {
+		block[4 + i] = static_cast<std::uint8_t>(indices >> (8 * i));
+	}
+}
+
+void block_compression::compressBC4Block(const std::uint8_t values[16], std::uint8_t block[BC4_BLOCK_SIZE]) {
+	const std::uint8_t max_value{*std::max_element(values, values + 16)};
+	const std::uint8_t min_value{*std::min_element(values, values + 16)};
+	block[0] = max_value;
+	block[1] = min_value;
+
+	// Eight value mode, which requires the first endpoint to be greater
+	int palette[8];
+	palette[0] = max_value;
+	palette[1] = min_value;
+	for (int i{1}; i < 7; ++i) {
+		palette[i + 1] = ((7 - i) * max_value + i * min_value) / 7;
+	}
+
+	std::uint64_t indices{0};
+	for (int i{0}; i < 16; ++i) {
+		int best_index{0};
+		int best_distance{std::numeric_limits<int>::max()};
+		for (int p{0}; p < 8; ++p) {
+			const int distance{std::abs(values[i] - palette[p])};
+			if (distance < best_distance) {
+				best_distance = distance;
+				best_index = p;
+			}
+		}
+		indices |= static_cast<std::uint64_t>(best_index) << (3 * i);
+	}
+	for (int i{0}; i < 6; ++i) {
+		block[2 + i] = static_cast<std::uint8_t>(indices >> (8 * i));
+	}
+}
+
+void block_compression::compressBC3Block(const std::uint8_t rgba[64], std::uint8_t block[BC3_BLOCK_SIZE]) {
+	std::uint8_t alpha[16];
+	for (int i{0}; i < 16; ++i) {
+		alpha[i] = rgba[4 * i + 3];
+	}
+	// The alpha block is encoded like a BC4 block, followed by a four color BC1 block
+	compressBC4Block(alpha, block);
+	compressBC1Block(rgba, block + 8);
+}
+
+std::vector<std::uint8_t> block_compression::compressBC1Image(const std::uint8_t* rgba, int width, int height) {
+	return compressImage(rgba, width, height, BC1_BLOCK_SIZE, compressBC1Block);
+}
+
+std::vector<std::uint8_t> block_compression::compressBC3Image(const std::uint8_t* rgba, int width, int height) {
+	return compressImage(rgba, width, height, BC3_BLOCK_SIZE, compressBC3Block);
+}
+
+std::vector<std::uint8_t> block_compression::compressBC4Image(const std::uint8_t* rgba, int width, int height) {
+	return compressImage(rgba, width, height, BC4_BLOCK_SIZE, [](const std::uint8_t block_rgba[64], std::uint8_t* block) {
+		std::uint8_t red[16];
+		for (int i{0}; i < 16; ++i) {
+			red[i] = block_rgba[4 * i];
+		}
+		compressBC4Block(red, block);
+	});
+}
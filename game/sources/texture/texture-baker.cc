@@ -0,0 +1,120 @@
+#include "game/headers/texture/texture-baker.hh"
+
+#include "game/headers/texture/block-compression.hh"
+
+#include "external/stb/stb_image.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+	struct Image {
+		int width;
+		int height;
+		// Always four components per texel
+		std::vector<std::uint8_t> rgba;
+	};
+
+	// Box filter, odd dimensions fold their last row or column into the previous one
+	Image downsample(const Image& image) {
+		Image half;
+		half.width = std::max(1, image.width / 2);
+		half.height = std::max(1, image.height / 2);
+		half.rgba.resize(static_cast<std::size_t>(half.width) * half.height * 4);
+
+		for (int y{0}; y < half.height; ++y) {
+			const int y0{std::min(2 * y, image.height - 1)};
+			const int y1{std::min(2 * y + 1, image.height - 1)};
+			for (int x{0}; x < half.width; ++x) {
+				const int x0{std::min(2 * x, image.width - 1)};
+				const int x1{std::min(2 * x + 1, image.width - 1)};
+				for (int c{0}; c < 4; ++c) {
+					const int sum{
+						image.rgba[(static_cast<std::size_t>(y0) * image.width + x0) * 4 + c]
+							+ image.rgba[(static_cast<std::size_t>(y0) * image.width + x1) * 4 + c]
+							+ image.rgba[(static_cast<std::size_t>(y1) * image.width + x0) * 4 + c]
+							+ image.rgba[(static_cast<std::size_t>(y1) * image.width + x1) * 4 + c]
+					};
+					half.rgba[(static_cast<std::size_t>(y) * half.width + x) * 4 + c] = static_cast<std::uint8_t>((sum + 2) / 4);
+				}
+			}
+		}
+		return half;
+	}
+
+	// Weights stb_image uses when it loads an image as a single channel
+	void storeLuminance(Image& image) {
+		for (std::size_t i{0}; i < image.rgba.size(); i += 4) {
+			image.rgba[i] = static_cast<std::uint8_t>(
+				(image.rgba[i] * 77 + image.rgba[i + 1] * 150 + image.rgba[i + 2] * 29) >> 8
+			);
+		}
+	}
+
+	std::vector<std::uint8_t> compress(const Image& image, BakedTextureFormat format) {
+		switch (format) {
+			case BakedTextureFormat::BC1:
+				return block_compression::compressBC1Image(image.rgba.data(), image.width, image.height);
+			case BakedTextureFormat::BC3:
+				return block_compression::compressBC3Image(image.rgba.data(), image.width, image.height);
+			case BakedTextureFormat::BC4:
+				return block_compression::compressBC4Image(image.rgba.data(), image.width, image.height);
+		}
+		throw std::runtime_error("unknown baked texture format");
+	}
+
+} // namespace
+
+BakedTextureFormat texture_baker::chooseFormat(int channels, bool has_transparency) {
+	if (channels == 1) {
+		return BakedTextureFormat::BC4;
+	}
+	return has_transparency ? BakedTextureFormat::BC3 : BakedTextureFormat::BC1;
+}
+
+void texture_baker::bake(
+	const std::string& source_path,
+	const std::string& baked_path,
+	std::optional<BakedTextureFormat> format
+) {
+	int width, height, channels;
+	std::unique_ptr<stbi_uc, void(*)(void*)> data{
+		stbi_load(source_path.c_str(), &width, &height, &channels, 4),
+		stbi_image_free
+	};
+	if (!data) {
+		throw std::runtime_error("cannot load an image: " + source_path);
+	}
+
+	Image image{width, height, std::vector<std::uint8_t>(data.get(), data.get() + static_cast<std::size_t>(width) * height * 4)};
+	data.reset();
+
+	if (!format) {
+		bool has_transparency{false};
+		for (std::size_t i{3}; i < image.rgba.size(); i += 4) {
+			if (image.rgba[i] != 255) {
+				has_transparency = true;
+				break;
+			}
+		}
+		format = chooseFormat(channels, has_transparency);
+	}
+	// BC4 compresses the red channel only, which holds the luminance, whatever the source's channels
+	if (*format == BakedTextureFormat::BC4) {
+		storeLuminance(image);
+	}
+
+	// Every mip level down to a single texel
+	std::vector<std::vector<std::uint8_t>> mip_levels;
+	mip_levels.push_back(compress(image, *format));
+	while (image.width > 1 || image.height > 1) {
+		image = downsample(image);
+		mip_levels.push_back(compress(image, *format));
+	}
+
+	BakedTexture::write(baked_path, *format, width, height, mip_levels);
+}
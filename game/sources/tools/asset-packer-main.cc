@@ -0,0 +1,91 @@
+#include "game/headers/utility/asset-archive.hh"
+#include "game/headers/utility/virtual-file-system.hh"
+
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+/**
+ * Usage: asset-packer [--compress] <archive> <file or directory>...
+ * Packs the files, and everything under the directories, into an archive.
+ * Run it from the game's directory, entries are looked up by their paths relative to it.
+ */
+int main(int argc, char* argv[]) {
+	bool allow_compression{false};
+	std::string archive_path;
+	std::vector<std::string> inputs;
+
+	for (int i{1}; i < argc; ++i) {
+		const std::string argument{argv[i]};
+		if (argument == "--compress") {
+			allow_compression = true;
+		} else if (archive_path.empty()) {
+			archive_path = argument;
+		} else {
+			inputs.push_back(argument);
+		}
+	}
+	if (archive_path.empty() || inputs.empty()) {
+		std::cerr << "Usage: " << argv[0] << " [--compress] <archive> <file or directory>..." << std::endl;
+		return 1;
+	}
+
+	try {
+		const VirtualFileSystem file_system;
+		const std::string normal_archive_path{file_system.normalizePath(fs::absolute(archive_path).string())};
+
+		std::vector<AssetArchiveSource> sources;
+		const auto addFile = [&](const fs::path& path) {
+			const std::string entry_path{file_system.normalizePath(fs::absolute(path).string())};
+			if (entry_path != normal_archive_path) {
+				sources.push_back({entry_path, path.string()});
+			}
+		};
+		for (const std::string& input : inputs) {
+			if (fs::is_directory(input)) {
+				for (const fs::directory_entry& entry : fs::recursive_directory_iterator(input)) {
+					if (entry.is_regular_file()) {
+						addFile(entry.path());
+					}
+				}
+			} else if (fs::is_regular_file(input)) {
+				addFile(input);
+			} else {
+				std::cerr << "Error: no such file or directory: " << input << std::endl;
+				return 1;
+			}
+		}
+
+		// Sorted, so packing the same files always produces the same archive
+		std::sort(sources.begin(), sources.end(), [](const AssetArchiveSource& a, const AssetArchiveSource& b) {
+			return a.path < b.path;
+		});
+		sources.erase(
+			std::unique(sources.begin(), sources.end(), [](const AssetArchiveSource& a, const AssetArchiveSource& b) {
+				return a.path == b.path;
+			}),
+			sources.end()
+		);
+
+		AssetArchive::write(archive_path, sources, allow_compression);
+
+		const AssetArchive archive{archive_path};
+		std::size_t compressed_count{0u};
+		std::uint64_t total_size{0u};
+		for (const AssetEntry& entry : archive.getEntries()) {
+			compressed_count += entry.compression != AssetCompression::None ? 1u : 0u;
+			total_size += entry.size;
+		}
+		std::clog << "Info: packed " << archive.getEntries().size() << " files, " << compressed_count << " compressed, "
+			<< total_size << " bytes into " << archive.getFile()->size() << " bytes: " << archive_path << std::endl;
+	} catch (const std::exception& e) {
+		std::cerr << "Error: " << e.what() << std::endl;
+		return 1;
+	}
+	return 0;
+}
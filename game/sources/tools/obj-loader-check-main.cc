@@ -0,0 +1,190 @@
+#include "game/headers/model/assimp/assimp-model-loader.hh"
+#include "game/headers/model/obj/obj-model-loader.hh"
+#include "game/headers/model/obj/obj-parser.hh"
+#include "game/headers/service-locator.hh"
+#include "game/headers/utility/mapped-file.hh"
+
+#include "external/assimp/include/assimp/postprocess.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+	using Clock = std::chrono::steady_clock;
+
+	// Both parsers round decimal numbers slightly differently
+	bool isNearlyEqual(float first, float second) {
+		const float scale{std::max({1.0f, std::fabs(first), std::fabs(second)})};
+		return std::fabs(first - second) <= 1e-5f * scale;
+	}
+
+	bool isNearlyEqual(const glm::vec3& first, const glm::vec3& second) {
+		return isNearlyEqual(first.x, second.x) && isNearlyEqual(first.y, second.y) && isNearlyEqual(first.z, second.z);
+	}
+
+	bool isNearlyEqual(const glm::vec2& first, const glm::vec2& second) {
+		return isNearlyEqual(first.x, second.x) && isNearlyEqual(first.y, second.y);
+	}
+
+	// Returns the first difference between the meshes, or an empty string
+	std::string compareMeshes(const Mesh& native, const Mesh& assimp) {
+		if (native.vertices_.size() != assimp.vertices_.size()) {
+			return "vertex count " + std::to_string(native.vertices_.size()) + " != " + std::to_string(assimp.vertices_.size());
+		}
+		for (std::size_t i{0u}; i < native.vertices_.size(); ++i) {
+			const Vertex& first{native.vertices_[i]};
+			const Vertex& second{assimp.vertices_[i]};
+			if (!isNearlyEqual(first.position, second.position)
+					|| !isNearlyEqual(first.normal, second.normal)
+					|| !isNearlyEqual(first.tex_coords, second.tex_coords)) {
+				return "vertex " + std::to_string(i);
+			}
+		}
+		if (native.indices_ != assimp.indices_) {
+			return "indices";
+		}
+		if (native.lods_.size() != assimp.lods_.size()) {
+			return "level of detail count";
+		}
+		for (std::size_t i{0u}; i < native.lods_.size(); ++i) {
+			if (native.lods_[i].indices != assimp.lods_[i].indices) {
+				return "level of detail " + std::to_string(i + 1u);
+			}
+		}
+
+		const Material& first{native.material_};
+		const Material& second{assimp.material_};
+		if (!isNearlyEqual(first.color_ambient, second.color_ambient)
+				|| !isNearlyEqual(first.color_diffuse, second.color_diffuse)
+				|| !isNearlyEqual(first.color_specular, second.color_specular)
+				|| !isNearlyEqual(first.shininess, second.shininess)) {
+			return "material";
+		}
+		if (native.textures_.size() != assimp.textures_.size()) {
+			return "texture count";
+		}
+		for (std::size_t i{0u}; i < native.textures_.size(); ++i) {
+			if (native.textures_[i].type != assimp.textures_[i].type || native.textures_[i].path != assimp.textures_[i].path) {
+				return "texture " + native.textures_[i].path + " != " + assimp.textures_[i].path;
+			}
+		}
+		return {};
+	}
+
+	// Returns the number of differences, which are printed
+	std::size_t compareModels(const Model& native, const Model& assimp) {
+		std::size_t difference_count{0u};
+		const auto report{[&difference_count](const std::string& difference) {
+			std::cerr << "Error: " << difference << std::endl;
+			++difference_count;
+		}};
+
+		if (native.transforms_.getNodeCount() != assimp.transforms_.getNodeCount()) {
+			report(
+				"node count " + std::to_string(native.transforms_.getNodeCount())
+					+ " != " + std::to_string(assimp.transforms_.getNodeCount())
+			);
+		}
+		if (native.mesh_nodes_ != assimp.mesh_nodes_) {
+			report("mesh nodes");
+		}
+		if (native.meshes_.size() != assimp.meshes_.size()) {
+			report("mesh count " + std::to_string(native.meshes_.size()) + " != " + std::to_string(assimp.meshes_.size()));
+			return difference_count;
+		}
+		for (std::size_t i{0u}; i < native.meshes_.size(); ++i) {
+			const std::string difference{compareMeshes(*native.meshes_[i], *assimp.meshes_[i])};
+			if (!difference.empty()) {
+				report("mesh " + std::to_string(i) + ": " + difference);
+			}
+		}
+		return difference_count;
+	}
+
+	// Best time of the runs, in seconds
+	double measure(int run_count, const std::function<void()>& run) {
+		double best{std::numeric_limits<double>::max()};
+		for (int i{0}; i < run_count; ++i) {
+			const Clock::time_point start{Clock::now()};
+			run();
+			best = std::min(best, std::chrono::duration<double>(Clock::now() - start).count());
+		}
+		return best;
+	}
+
+	std::string formatThroughput(std::size_t size, double seconds) {
+		std::ostringstream text;
+		text << seconds * 1000.0 << " ms, " << size / (1024.0 * 1024.0) / seconds << " MB/s";
+		return text.str();
+	}
+
+} // namespace
+
+/**
+ * Usage: obj-loader-check [--runs <count>] <model.obj>...
+ * Loads every model with both the native OBJ loader, and Assimp, without the mesh cache, and reports
+ * any difference between the models. Then reports the throughput of both parsers, which is the best
+ * of the runs, and leaves out the mesh processing the loaders share.
+ */
+int main(int argc, char* argv[]) {
+	int run_count{5};
+	std::size_t checked_count{0u};
+	std::size_t difference_count{0u};
+
+	for (int i{1}; i < argc; ++i) {
+		const std::string argument{argv[i]};
+		if (argument == "--runs" && i + 1 < argc) {
+			run_count = std::max(1, std::stoi(argv[++i]));
+			continue;
+		}
+
+		try {
+			AssimpModelLoader assimp_loader{false};
+			ObjModelLoader obj_loader{nullptr, false};
+			const std::shared_ptr<Model> native_model{obj_loader.loadModel(argument)};
+			const std::shared_ptr<Model> assimp_model{assimp_loader.loadModel(argument)};
+			const std::size_t model_difference_count{compareModels(*native_model, *assimp_model)};
+			difference_count += model_difference_count;
+			std::clog << "Info: " << argument << ": " << native_model->meshes_.size() << " meshes, "
+				<< (model_difference_count == 0u ? "same as Assimp" : "differs from Assimp") << std::endl;
+
+			const std::size_t size{MappedFile(argument).size()};
+			const double native_seconds{measure(run_count, [&argument]() {
+				const MappedFile file{argument};
+				obj_parser::parse(
+					reinterpret_cast<const char*>(file.data()),
+					file.size(),
+					ServiceLocator::getInstance().getThreadPool()
+				);
+			})};
+			const double assimp_seconds{measure(run_count, [&argument]() {
+				Assimp::Importer importer;
+				if (importer.ReadFile(argument, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_GenNormals) == nullptr) {
+					throw std::runtime_error(std::string("cannot load model file: ") + importer.GetErrorString());
+				}
+			})};
+			std::clog << "Info: native parser: " << formatThroughput(size, native_seconds) << std::endl;
+			std::clog << "Info: Assimp importer: " << formatThroughput(size, assimp_seconds) << std::endl;
+			++checked_count;
+		} catch (const std::exception& e) {
+			std::cerr << "Error: " << argument << ": " << e.what() << std::endl;
+			return 1;
+		}
+	}
+
+	if (checked_count == 0u) {
+		std::cerr << "Usage: " << argv[0] << " [--runs <count>] <model.obj>..." << std::endl;
+		return 1;
+	}
+	return difference_count == 0u ? 0 : 1;
+}
@@ -0,0 +1,141 @@
+#include "game/headers/model/obj/obj-model-loader.hh"
+#include "game/headers/model/scene-generator.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+	using Clock = std::chrono::steady_clock;
+
+	double getMilliseconds(Clock::time_point start) {
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	std::size_t getTriangleCount(const Model& model) {
+		std::size_t triangle_count{0u};
+		for (const std::shared_ptr<Mesh>& mesh : model.meshes_) {
+			triangle_count += mesh->indices_.size() / 3u;
+		}
+		return triangle_count;
+	}
+
+	/**
+	 * Generates, writes, and loads back one scene, printing a line of comma separated values.
+	 */
+	void measureScene(const SceneGeneratorSettings& settings, bool load) {
+		Clock::time_point start{Clock::now()};
+		const GeneratedScene scene{scene_generator::generate(settings)};
+		const double generate_ms{getMilliseconds(start)};
+
+		start = Clock::now();
+		const std::string model_path{scene_generator::write(scene, settings)};
+		const double write_ms{getMilliseconds(start)};
+
+		double load_ms{0.0};
+		if (load) {
+			// Without the mesh cache, so every load parses, and processes the meshes
+			ObjModelLoader loader{nullptr, false};
+			start = Clock::now();
+			loader.loadModel(model_path);
+			load_ms = getMilliseconds(start);
+		}
+
+		std::cout << scene.model->meshes_.size() << ',' << getTriangleCount(*scene.model) << ','
+			<< scene.textures.size() << ',' << scene.instances.size() << ','
+			<< std::filesystem::file_size(model_path) << ','
+			<< generate_ms << ',' << write_ms << ',' << load_ms << std::endl;
+	}
+
+} // namespace
+
+/**
+ * Usage: scene-gen [options] <directory>
+ *   --meshes <count> --triangles <per mesh> --textures <count> --materials <count>
+ *   --lights <count> --instances <count> --extent <size> --seed <number> --name <name>
+ *   --sweep    also generates every power of ten meshes below the count, for scaling curves
+ *   --no-load  skips loading the written scenes back
+ * Writes the scenes as OBJ models, with their textures, and instance lists, and prints
+ * their sizes, and generation, writing, and loading times as comma separated values.
+ */
+int main(int argc, char* argv[]) {
+	SceneGeneratorSettings settings;
+	settings.directory.clear();
+	bool sweep{false};
+	bool load{true};
+
+	try {
+		for (int i{1}; i < argc; ++i) {
+			const std::string argument{argv[i]};
+			const bool has_value{i + 1 < argc};
+			if (argument == "--meshes" && has_value) {
+				settings.mesh_count = std::stoul(argv[++i]);
+			} else if (argument == "--triangles" && has_value) {
+				settings.triangles_per_mesh = std::stoul(argv[++i]);
+			} else if (argument == "--textures" && has_value) {
+				settings.texture_count = std::stoul(argv[++i]);
+			} else if (argument == "--materials" && has_value) {
+				settings.material_count = std::stoul(argv[++i]);
+			} else if (argument == "--lights" && has_value) {
+				settings.light_count = std::stoul(argv[++i]);
+			} else if (argument == "--instances" && has_value) {
+				settings.instance_count = std::stoul(argv[++i]);
+			} else if (argument == "--extent" && has_value) {
+				settings.extent = std::stof(argv[++i]);
+			} else if (argument == "--seed" && has_value) {
+				settings.seed = static_cast<std::uint32_t>(std::stoul(argv[++i]));
+			} else if (argument == "--name" && has_value) {
+				settings.name = argv[++i];
+			} else if (argument == "--sweep") {
+				sweep = true;
+			} else if (argument == "--no-load") {
+				load = false;
+			} else if (settings.directory.empty() && argument.rfind("--", 0) != 0) {
+				settings.directory = argument;
+			} else {
+				throw std::invalid_argument("unknown argument: " + argument);
+			}
+		}
+	} catch (const std::exception& e) {
+		std::cerr << "Error: " << e.what() << std::endl;
+		return 1;
+	}
+	if (settings.directory.empty()) {
+		std::cerr << "Usage: " << argv[0] << " [--meshes <count>] [--triangles <per mesh>] [--textures <count>]"
+			<< " [--materials <count>] [--lights <count>] [--instances <count>] [--extent <size>] [--seed <number>]"
+			<< " [--name <name>] [--sweep] [--no-load] <directory>" << std::endl;
+		return 1;
+	}
+
+	std::vector<std::size_t> mesh_counts{settings.mesh_count};
+	if (sweep) {
+		mesh_counts.clear();
+		for (std::size_t count{1u}; count < settings.mesh_count; count *= 10u) {
+			mesh_counts.push_back(count);
+		}
+		mesh_counts.push_back(settings.mesh_count);
+	}
+
+	std::cout << "meshes,triangles,textures,instances,file_bytes,generate_ms,write_ms,load_ms" << std::endl;
+	try {
+		const std::string name{settings.name};
+		for (std::size_t mesh_count : mesh_counts) {
+			settings.mesh_count = mesh_count;
+			if (sweep) {
+				settings.name = name + "-" + std::to_string(mesh_count);
+			}
+			measureScene(settings, load);
+		}
+	} catch (const std::exception& e) {
+		std::cerr << "Error: " << e.what() << std::endl;
+		return 1;
+	}
+	return 0;
+}
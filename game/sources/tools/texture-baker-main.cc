@@ -0,0 +1,51 @@
+#include "game/headers/texture/texture-baker.hh"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "external/stb/stb_image.h"
+
+#include <exception>
+#include <iostream>
+#include <optional>
+#include <string>
+
+/**
+ * Usage: texture-baker [--format bc1|bc3|bc4] <image>...
+ * Writes every image's baked texture next to it. Bitmap fonts must be baked as bc4.
+ */
+int main(int argc, char* argv[]) {
+	std::optional<BakedTextureFormat> format;
+	int baked_count{0};
+
+	for (int i{1}; i < argc; ++i) {
+		const std::string argument{argv[i]};
+		if (argument == "--format" && i + 1 < argc) {
+			const std::string format_name{argv[++i]};
+			if (format_name == "bc1") {
+				format = BakedTextureFormat::BC1;
+			} else if (format_name == "bc3") {
+				format = BakedTextureFormat::BC3;
+			} else if (format_name == "bc4") {
+				format = BakedTextureFormat::BC4;
+			} else {
+				std::cerr << "Error: unknown format: " << format_name << std::endl;
+				return 1;
+			}
+			continue;
+		}
+
+		try {
+			texture_baker::bake(argument, BakedTexture::getBakedPath(argument), format);
+			std::clog << "Info: baked " << argument << std::endl;
+			++baked_count;
+		} catch (const std::exception& e) {
+			std::cerr << "Error: " << e.what() << std::endl;
+			return 1;
+		}
+	}
+
+	if (baked_count == 0) {
+		std::cerr << "Usage: " << argv[0] << " [--format bc1|bc3|bc4] <image>..." << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,179 @@
+#include "game/headers/utility/asset-archive.hh"
+
+#include "game/headers/utility/binary-stream.hh"
+#include "game/headers/utility/lz4.hh"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+	constexpr char ARCHIVE_MAGIC[8]{'F', 'P', 'S', 'P', 'A', 'C', 'K', '\0'};
+	constexpr std::uint32_t ARCHIVE_VERSION{1u};
+	// Entries start on page boundaries, so uncompressed ones map straight into their consumers
+	constexpr std::uint64_t ENTRY_ALIGNMENT{4096u};
+	// Compressed entries are kept only if they save at least an eighth
+	constexpr std::uint64_t MIN_COMPRESSION_SAVING_DIVISOR{8u};
+
+	struct ArchiveHeader {
+		char magic[8];
+		std::uint32_t version;
+		std::uint32_t entry_count;
+		std::uint64_t table_offset;
+		std::uint64_t table_size;
+	};
+
+	struct EntryRecord {
+		std::uint64_t offset;
+		std::uint64_t stored_size;
+		std::uint64_t size;
+		std::uint32_t compression;
+		std::uint32_t padding;
+		std::int64_t modification_time;
+	};
+
+	void writePadding(std::ofstream& file, std::uint64_t& offset) {
+		static const char ZEROS[ENTRY_ALIGNMENT]{};
+		const std::uint64_t padding{(ENTRY_ALIGNMENT - offset % ENTRY_ALIGNMENT) % ENTRY_ALIGNMENT};
+		file.write(ZEROS, static_cast<std::streamsize>(padding));
+		offset += padding;
+	}
+
+} // namespace
+
+AssetArchive::AssetArchive(const std::string& path):
+		path_{path}, file_{std::make_shared<const MappedFile>(path)} {
+	try {
+		BinaryReader header_reader{file_->data(), file_->size()};
+		const ArchiveHeader header{header_reader.read<ArchiveHeader>()};
+		if (std::memcmp(header.magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0) {
+			throw std::runtime_error("not an asset archive");
+		}
+		if (header.version != ARCHIVE_VERSION) {
+			throw std::runtime_error("unsupported asset archive version");
+		}
+		if (header.table_offset > file_->size() || header.table_size > file_->size() - header.table_offset) {
+			throw std::runtime_error("table of contents exceeds the file");
+		}
+
+		BinaryReader reader{file_->data() + header.table_offset, static_cast<std::size_t>(header.table_size)};
+		entries_.reserve(header.entry_count);
+		for (std::uint32_t i{0u}; i < header.entry_count; ++i) {
+			std::string entry_path{reader.readString()};
+			const EntryRecord record{reader.read<EntryRecord>()};
+			if (record.offset > file_->size() || record.stored_size > file_->size() - record.offset) {
+				throw std::runtime_error("entry exceeds the file: " + entry_path);
+			}
+			const AssetCompression compression{static_cast<AssetCompression>(record.compression)};
+			if (compression != AssetCompression::None && compression != AssetCompression::LZ4) {
+				throw std::runtime_error("unknown compression of an entry: " + entry_path);
+			}
+			if (compression == AssetCompression::None && record.stored_size != record.size) {
+				throw std::runtime_error("size mismatch of an entry: " + entry_path);
+			}
+			entries_.push_back({
+				std::move(entry_path),
+				record.offset,
+				record.stored_size,
+				record.size,
+				compression,
+				record.modification_time
+			});
+		}
+	} catch (const std::out_of_range&) {
+		throw std::runtime_error("truncated asset archive: " + path);
+	} catch (const std::runtime_error& e) {
+		throw std::runtime_error(std::string(e.what()) + ": " + path);
+	}
+
+	entry_indices_.reserve(entries_.size());
+	for (std::size_t i{0u}; i < entries_.size(); ++i) {
+		entry_indices_.emplace(entries_[i].path, i);
+	}
+}
+
+const std::string& AssetArchive::getPath() const {
+	return path_;
+}
+
+const AssetEntry* AssetArchive::find(std::string_view path) const {
+	const auto it{entry_indices_.find(path)};
+	return it != entry_indices_.end() ? &entries_[it->second] : nullptr;
+}
+
+const std::vector<AssetEntry>& AssetArchive::getEntries() const {
+	return entries_;
+}
+
+const std::shared_ptr<const MappedFile>& AssetArchive::getFile() const {
+	return file_;
+}
+
+void AssetArchive::write(const std::string& path, const std::vector<AssetArchiveSource>& sources, bool allow_compression) {
+	// Write to a temporary file first, so a running game never maps a partially written archive
+	const std::string temporary_path{path + ".tmp"};
+	{
+		std::ofstream file{temporary_path, std::ios::binary | std::ios::trunc};
+		if (!file) {
+			throw std::runtime_error("cannot create an asset archive: " + temporary_path);
+		}
+
+		// The header is rewritten once the table's position is known
+		ArchiveHeader header{};
+		std::memcpy(header.magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+		header.version = ARCHIVE_VERSION;
+		header.entry_count = static_cast<std::uint32_t>(sources.size());
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		std::uint64_t offset{sizeof(header)};
+
+		BinaryWriter table;
+		for (const AssetArchiveSource& source : sources) {
+			const MappedFile source_file{source.file_path};
+			EntryRecord record{};
+			record.size = source_file.size();
+			record.modification_time = static_cast<std::int64_t>(
+				fs::last_write_time(source.file_path).time_since_epoch().count()
+			);
+
+			std::vector<unsigned char> compressed;
+			if (allow_compression && source_file.size() > 0u) {
+				compressed = lz4::compress(source_file.data(), source_file.size());
+				if (compressed.size() > source_file.size() - source_file.size() / MIN_COMPRESSION_SAVING_DIVISOR) {
+					compressed.clear();
+				}
+			}
+			const unsigned char* data{source_file.data()};
+			record.stored_size = source_file.size();
+			record.compression = static_cast<std::uint32_t>(AssetCompression::None);
+			if (!compressed.empty()) {
+				data = compressed.data();
+				record.stored_size = compressed.size();
+				record.compression = static_cast<std::uint32_t>(AssetCompression::LZ4);
+			}
+
+			writePadding(file, offset);
+			record.offset = offset;
+			file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(record.stored_size));
+			offset += record.stored_size;
+
+			table.writeString(source.path);
+			table.write(record);
+		}
+
+		header.table_offset = offset;
+		header.table_size = table.size();
+		const std::vector<unsigned char>& table_buffer{table.getBuffer()};
+		file.write(reinterpret_cast<const char*>(table_buffer.data()), static_cast<std::streamsize>(table_buffer.size()));
+		file.seekp(0);
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		if (!file) {
+			throw std::runtime_error("cannot write an asset archive: " + temporary_path);
+		}
+	}
+	fs::rename(temporary_path, path);
+}
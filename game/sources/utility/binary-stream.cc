@@ -0,0 +1,57 @@
+#include "game/headers/utility/binary-stream.hh"
+
+#include <stdexcept>
+
+void BinaryWriter::writeString(std::string_view str) {
+	write(static_cast<std::uint32_t>(str.size()));
+	writeArray(str.data(), str.size());
+}
+
+void BinaryWriter::align(std::size_t alignment) {
+	const std::size_t remainder{buffer_.size() % alignment};
+	if (remainder != 0) {
+		buffer_.resize(buffer_.size() + alignment - remainder, 0);
+	}
+}
+
+std::size_t BinaryWriter::size() const {
+	return buffer_.size();
+}
+
+const std::vector<unsigned char>& BinaryWriter::getBuffer() const {
+	return buffer_;
+}
+
+BinaryReader::BinaryReader(const unsigned char* data, std::size_t size):
+	data_{data}, size_{size} {
+}
+
+std::string BinaryReader::readString() {
+	const std::uint32_t length{read<std::uint32_t>()};
+	const char* chars{reinterpret_cast<const char*>(skip(length))};
+	return std::string(chars, length);
+}
+
+void BinaryReader::align(std::size_t alignment) {
+	const std::size_t remainder{position_ % alignment};
+	if (remainder != 0) {
+		skip(alignment - remainder);
+	}
+}
+
+const unsigned char* BinaryReader::skip(std::size_t bytes) {
+	if (bytes > size_ - position_) {
+		throw std::out_of_range("read past the end of the binary data");
+	}
+	const unsigned char* current{data_ + position_};
+	position_ += bytes;
+	return current;
+}
+
+std::size_t BinaryReader::getPosition() const {
+	return position_;
+}
+
+bool BinaryReader::isAtEnd() const {
+	return position_ == size_;
+}
@@ -0,0 +1,43 @@
+#include "game/headers/utility/binary-stream.hh"
+
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+template <typename T>
+void BinaryWriter::write(const T& value) {
+	writeArray(&value, 1);
+}
+
+template <typename T>
+void BinaryWriter::writeArray(const T* values, std::size_t count) {
+	static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable types can be written");
+	const unsigned char* bytes{reinterpret_cast<const unsigned char*>(values)};
+	buffer_.insert(buffer_.end(), bytes, bytes + count * sizeof(T));
+}
+
+template <typename T>
+void BinaryWriter::writeVector(const std::vector<T>& values) {
+	write(static_cast<std::uint64_t>(values.size()));
+	writeArray(values.data(), values.size());
+}
+
+template <typename T>
+T BinaryReader::read() {
+	static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable types can be read");
+	T value;
+	std::memcpy(&value, skip(sizeof(T)), sizeof(T));
+	return value;
+}
+
+template <typename T>
+std::vector<T> BinaryReader::readVector() {
+	static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable types can be read");
+	const std::uint64_t count{read<std::uint64_t>()};
+	if (count > (size_ - position_) / sizeof(T)) {
+		throw std::out_of_range("array exceeds the binary data");
+	}
+	std::vector<T> values(static_cast<std::size_t>(count));
+	std::memcpy(values.data(), skip(values.size() * sizeof(T)), values.size() * sizeof(T));
+	return values;
+}
@@ -0,0 +1,197 @@
+#include "game/headers/utility/lz4.hh"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+	constexpr std::size_t MIN_MATCH{4u};
+	// The format requires the last literals, and the last match's distance from the block's end
+	constexpr std::size_t LAST_LITERALS{5u};
+	constexpr std::size_t MATCH_FIND_LIMIT{12u};
+	constexpr std::size_t MAX_OFFSET{65535u};
+	constexpr unsigned int HASH_BITS{16u};
+	// Every this many misses in a row, the search steps one more byte, so incompressible data is skipped quickly
+	constexpr unsigned int SKIP_TRIGGER{6u};
+
+	std::uint32_t read32(const unsigned char* data) {
+		std::uint32_t value;
+		std::memcpy(&value, data, sizeof(value));
+		return value;
+	}
+
+	std::uint32_t hash(std::uint32_t sequence) {
+		return (sequence * 2654435761u) >> (32u - HASH_BITS);
+	}
+
+	void writeLength(std::vector<unsigned char>& output, std::size_t length) {
+		for (; length >= 255u; length -= 255u) {
+			output.push_back(255u);
+		}
+		output.push_back(static_cast<unsigned char>(length));
+	}
+
+	void writeSequence(
+		std::vector<unsigned char>& output,
+		const unsigned char* literals,
+		std::size_t literal_length,
+		std::size_t offset,
+		std::size_t match_length
+	) {
+		const std::size_t match_code{match_length - MIN_MATCH};
+		output.push_back(static_cast<unsigned char>(
+			(literal_length < 15u ? literal_length : 15u) << 4u | (match_code < 15u ? match_code : 15u)
+		));
+		if (literal_length >= 15u) {
+			writeLength(output, literal_length - 15u);
+		}
+		output.insert(output.end(), literals, literals + literal_length);
+		output.push_back(static_cast<unsigned char>(offset & 0xffu));
+		output.push_back(static_cast<unsigned char>(offset >> 8u));
+		if (match_code >= 15u) {
+			writeLength(output, match_code - 15u);
+		}
+	}
+
+	void writeLastLiterals(std::vector<unsigned char>& output, const unsigned char* literals, std::size_t literal_length) {
+		output.push_back(static_cast<unsigned char>((literal_length < 15u ? literal_length : 15u) << 4u));
+		if (literal_length >= 15u) {
+			writeLength(output, literal_length - 15u);
+		}
+		output.insert(output.end(), literals, literals + literal_length);
+	}
+
+	std::size_t readLength(const unsigned char*& source, const unsigned char* source_end) {
+		std::size_t length{0u};
+		unsigned char byte;
+		do {
+			if (source == source_end) {
+				throw std::runtime_error("truncated LZ4 block");
+			}
+			byte = *source++;
+			length += byte;
+		} while (byte == 255u);
+		return length;
+	}
+
+} // namespace
+
+std::vector<unsigned char> lz4::compress(const unsigned char* source, std::size_t size) {
+	std::vector<unsigned char> output;
+	output.reserve(size + size / 255u + 16u);
+
+	std::size_t anchor{0u};
+	if (size > MATCH_FIND_LIMIT) {
+		// Positions are stored plus one, zero marks an empty slot
+		std::vector<std::uint32_t> table(std::size_t{1u} << HASH_BITS, 0u);
+		const std::size_t match_find_limit{size - MATCH_FIND_LIMIT};
+		const std::size_t match_limit{size - LAST_LITERALS};
+
+		std::size_t position{0u};
+		unsigned int misses{0u};
+		while (position < match_find_limit) {
+			const std::uint32_t sequence{read32(source + position)};
+			std::uint32_t& slot{table[hash(sequence)]};
+			const std::size_t candidate{slot};
+			slot = static_cast<std::uint32_t>(position + 1u);
+
+			if (candidate == 0u || position - (candidate - 1u) > MAX_OFFSET || read32(source + candidate - 1u) != sequence) {
+				position += 1u + (misses++ >> SKIP_TRIGGER);
+				continue;
+			}
+			misses = 0u;
+
+			std::size_t match{candidate - 1u};
+			// Extending the match backwards over pending literals
+			while (position > anchor && match > 0u && source[position - 1u] == source[match - 1u]) {
+				--position;
+				--match;
+			}
+			std::size_t length{MIN_MATCH};
+			while (position + length < match_limit && source[match + length] == source[position + length]) {
+				++length;
+			}
+
+			writeSequence(output, source + anchor, position - anchor, position - match, length);
+			position += length;
+			anchor = position;
+
+			// Making the positions inside the match findable too, at least the one before its end
+			if (position < match_find_limit) {
+				table[hash(read32(source + position - 2u))] = static_cast<std::uint32_t>(position - 1u);
+			}
+		}
+	}
+
+	writeLastLiterals(output, source + anchor, size - anchor);
+	return output;
+}
+
+void lz4::decompress(
+	const unsigned char* source,
+	std::size_t source_size,
+	unsigned char* destination,
+	std::size_t destination_size
+) {
+	const unsigned char* const source_end{source + source_size};
+	std::size_t position{0u};
+
+	while (true) {
+		if (source == source_end) {
+			throw std::runtime_error("truncated LZ4 block");
+		}
+		const unsigned char token{*source++};
+
+		std::size_t literal_length{static_cast<std::size_t>(token >> 4u)};
+		if (literal_length == 15u) {
+			literal_length += readLength(source, source_end);
+		}
+		if (literal_length > static_cast<std::size_t>(source_end - source) || literal_length > destination_size - position) {
+			throw std::runtime_error("LZ4 literals exceed the block");
+		}
+		if (literal_length > 0u) {
+			std::memcpy(destination + position, source, literal_length);
+		}
+		source += literal_length;
+		position += literal_length;
+
+		// The last sequence has literals only
+		if (source == source_end) {
+			break;
+		}
+
+		if (source_end - source < 2) {
+			throw std::runtime_error("truncated LZ4 block");
+		}
+		const std::size_t offset{static_cast<std::size_t>(source[0]) | static_cast<std::size_t>(source[1]) << 8u};
+		source += 2;
+		if (offset == 0u || offset > position) {
+			throw std::runtime_error("LZ4 match offset is out of range");
+		}
+
+		std::size_t match_length{static_cast<std::size_t>(token & 0x0fu)};
+		if (match_length == 15u) {
+			match_length += readLength(source, source_end);
+		}
+		match_length += MIN_MATCH;
+		if (match_length > destination_size - position) {
+			throw std::runtime_error("LZ4 match exceeds the block");
+		}
+
+		const unsigned char* match{destination + position - offset};
+		if (offset >= match_length) {
+			std::memcpy(destination + position, match, match_length);
+		} else {
+			// Overlapping matches repeat the bytes just written
+			for (std::size_t i{0u}; i < match_length; ++i) {
+				destination[position + i] = match[i];
+			}
+		}
+		position += match_length;
+	}
+
+	if (position != destination_size) {
+		throw std::runtime_error("LZ4 block decompresses into an unexpected size");
+	}
+}
@@ -0,0 +1,159 @@
+#include "game/headers/utility/mapped-file.hh"
+
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& path) {
+	file_handle_ = CreateFileA(
+		path.c_str(),
+		GENERIC_READ,
+		FILE_SHARE_READ,
+		NULL,
+		OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+		NULL
+	);
+	if (file_handle_ == INVALID_HANDLE_VALUE) {
+		file_handle_ = nullptr;
+		throw std::runtime_error("cannot open a file for mapping: " + path);
+	}
+
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(file_handle_, &file_size)) {
+		unmap();
+		throw std::runtime_error("cannot get a file's size: " + path);
+	}
+	size_ = static_cast<std::size_t>(file_size.QuadPart);
+	if (size_ == 0) {
+		// Empty files cannot be mapped
+		return;
+	}
+
+	mapping_handle_ = CreateFileMappingA(file_handle_, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping_handle_ == NULL) {
+		mapping_handle_ = nullptr;
+		unmap();
+		throw std::runtime_error("cannot map a file: " + path);
+	}
+
+	data_ = static_cast<const unsigned char*>(MapViewOfFile(mapping_handle_, FILE_MAP_READ, 0, 0, 0));
+	if (data_ == nullptr) {
+		unmap();
+		throw std::runtime_error("cannot map a file: " + path);
+	}
+}
+
+void MappedFile::unmap() {
+	if (data_ != nullptr) {
+		UnmapViewOfFile(data_);
+	}
+	if (mapping_handle_ != nullptr) {
+		CloseHandle(mapping_handle_);
+	}
+	if (file_handle_ != nullptr) {
+		CloseHandle(file_handle_);
+	}
+	data_ = nullptr;
+	size_ = 0;
+	mapping_handle_ = nullptr;
+	file_handle_ = nullptr;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept:
+	data_{std::exchange(other.data_, nullptr)},
+	size_{std::exchange(other.size_, 0)},
+	file_handle_{std::exchange(other.file_handle_, nullptr)},
+	mapping_handle_{std::exchange(other.mapping_handle_, nullptr)} {
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+	if (this != &other) {
+		unmap();
+		data_ = std::exchange(other.data_, nullptr);
+		size_ = std::exchange(other.size_, 0);
+		file_handle_ = std::exchange(other.file_handle_, nullptr);
+		mapping_handle_ = std::exchange(other.mapping_handle_, nullptr);
+	}
+	return *this;
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path) {
+	file_descriptor_ = open(path.c_str(), O_RDONLY);
+	if (file_descriptor_ < 0) {
+		throw std::runtime_error("cannot open a file for mapping: " + path);
+	}
+
+	struct stat file_stat;
+	if (fstat(file_descriptor_, &file_stat) != 0) {
+		unmap();
+		throw std::runtime_error("cannot get a file's size: " + path);
+	}
+	size_ = static_cast<std::size_t>(file_stat.st_size);
+	if (size_ == 0) {
+		// Empty files cannot be mapped
+		return;
+	}
+
+	void* address{mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file_descriptor_, 0)};
+	if (address == MAP_FAILED) {
+		unmap();
+		throw std::runtime_error("cannot map a file: " + path);
+	}
+	data_ = static_cast<const unsigned char*>(address);
+	madvise(address, size_, MADV_SEQUENTIAL);
+}
+
+void MappedFile::unmap() {
+	if (data_ != nullptr) {
+		munmap(const_cast<unsigned char*>(data_), size_);
+	}
+	if (file_descriptor_ >= 0) {
+		close(file_descriptor_);
+	}
+	data_ = nullptr;
+	size_ = 0;
+	file_descriptor_ = -1;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept:
+	data_{std::exchange(other.data_, nullptr)},
+	size_{std::exchange(other.size_, 0)},
+	file_descriptor_{std::exchange(other.file_descriptor_, -1)} {
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+	if (this != &other) {
+		unmap();
+		data_ = std::exchange(other.data_, nullptr);
+		size_ = std::exchange(other.size_, 0);
+		file_descriptor_ = std::exchange(other.file_descriptor_, -1);
+	}
+	return *this;
+}
+
+#endif
+
+MappedFile::~MappedFile() {
+	unmap();
+}
+
+const unsigned char* MappedFile::data() const {
+	return data_;
+}
+
+std::size_t MappedFile::size() const {
+	return size_;
+}
@@ -0,0 +1,103 @@
+#include "game/headers/utility/memory-tracker.hh"
+
+#include "game/headers/service-locator.hh"
+
+#include <utility>
+
+namespace {
+
+	constexpr const char* CATEGORY_NAMES[MEMORY_CATEGORY_COUNT]{
+		"vertices",
+		"indices",
+		"textures",
+		"instances",
+		"scene",
+		"staging",
+		"collision",
+		"animation"
+	};
+
+} // namespace
+
+const char* getMemoryCategoryName(MemoryCategory category) {
+	return CATEGORY_NAMES[static_cast<std::size_t>(category)];
+}
+
+std::size_t MemoryUsage::get(MemoryDomain domain, MemoryCategory category) const {
+	return bytes[static_cast<std::size_t>(domain)][static_cast<std::size_t>(category)];
+}
+
+std::size_t MemoryUsage::getTotal(MemoryDomain domain) const {
+	std::size_t total{0u};
+	for (std::size_t category_bytes : bytes[static_cast<std::size_t>(domain)]) {
+		total += category_bytes;
+	}
+	return total;
+}
+
+MemoryUsage& MemoryUsage::operator+=(const MemoryUsage& other) {
+	for (std::size_t domain{0u}; domain < MEMORY_DOMAIN_COUNT; ++domain) {
+		for (std::size_t category{0u}; category < MEMORY_CATEGORY_COUNT; ++category) {
+			bytes[domain][category] += other.bytes[domain][category];
+		}
+	}
+	return *this;
+}
+
+void MemoryTracker::add(MemoryDomain domain, MemoryCategory category, std::int64_t bytes) {
+	bytes_[static_cast<std::size_t>(domain)][static_cast<std::size_t>(category)].fetch_add(bytes, std::memory_order_relaxed);
+}
+
+MemoryUsage MemoryTracker::getUsage() const {
+	MemoryUsage usage;
+	for (std::size_t domain{0u}; domain < MEMORY_DOMAIN_COUNT; ++domain) {
+		for (std::size_t category{0u}; category < MEMORY_CATEGORY_COUNT; ++category) {
+			const std::int64_t bytes{bytes_[domain][category].load(std::memory_order_relaxed)};
+			usage.bytes[domain][category] = bytes > 0 ? static_cast<std::size_t>(bytes) : 0u;
+		}
+	}
+	return usage;
+}
+
+MemoryRecord::~MemoryRecord() {
+	clear();
+}
+
+MemoryRecord::MemoryRecord(MemoryRecord&& other) noexcept:
+		usage_{other.usage_} {
+	other.usage_ = MemoryUsage{};
+}
+
+MemoryRecord& MemoryRecord::operator=(MemoryRecord&& other) noexcept {
+	if (this != &other) {
+		clear();
+		usage_ = other.usage_;
+		other.usage_ = MemoryUsage{};
+	}
+	return *this;
+}
+
+void MemoryRecord::set(MemoryDomain domain, MemoryCategory category, std::size_t bytes) {
+	std::size_t& recorded{usage_.bytes[static_cast<std::size_t>(domain)][static_cast<std::size_t>(category)]};
+	if (recorded == bytes) {
+		return;
+	}
+	ServiceLocator::getInstance().getMemoryTracker().add(
+		domain,
+		category,
+		static_cast<std::int64_t>(bytes) - static_cast<std::int64_t>(recorded)
+	);
+	recorded = bytes;
+}
+
+void MemoryRecord::clear() {
+	for (std::size_t domain{0u}; domain < MEMORY_DOMAIN_COUNT; ++domain) {
+		for (std::size_t category{0u}; category < MEMORY_CATEGORY_COUNT; ++category) {
+			set(static_cast<MemoryDomain>(domain), static_cast<MemoryCategory>(category), 0u);
+		}
+	}
+}
+
+const MemoryUsage& MemoryRecord::getUsage() const {
+	return usage_;
+}
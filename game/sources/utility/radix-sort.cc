@@ -0,0 +1,52 @@
+#include "game/headers/utility/radix-sort.hh"
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+namespace {
+
+	constexpr unsigned int DIGIT_BITS{8u};
+	constexpr std::size_t DIGIT_COUNT{sizeof(std::uint64_t) * 8u / DIGIT_BITS};
+	constexpr std::size_t BUCKET_COUNT{std::size_t{1u} << DIGIT_BITS};
+
+	std::size_t getDigit(std::uint64_t key, std::size_t digit) {
+		return static_cast<std::size_t>((key >> (digit * DIGIT_BITS)) & (BUCKET_COUNT - 1u));
+	}
+
+} // namespace
+
+void radix_sort::sort(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch) {
+	const std::size_t count{entries.size()};
+	if (count < 2u) {
+		return;
+	}
+
+	// Counting every digit's buckets in one pass over the keys
+	std::array<std::array<std::size_t, BUCKET_COUNT>, DIGIT_COUNT> histograms{};
+	for (const SortEntry& entry : entries) {
+		for (std::size_t digit{0u}; digit < DIGIT_COUNT; ++digit) {
+			++histograms[digit][getDigit(entry.key, digit)];
+		}
+	}
+
+	scratch.resize(count);
+	for (std::size_t digit{0u}; digit < DIGIT_COUNT; ++digit) {
+		std::array<std::size_t, BUCKET_COUNT>& buckets{histograms[digit]};
+		// Every key has the same digit, the pass would not move anything
+		if (buckets[getDigit(entries.front().key, digit)] == count) {
+			continue;
+		}
+
+		std::size_t offset{0u};
+		for (std::size_t& bucket : buckets) {
+			const std::size_t bucket_count{bucket};
+			bucket = offset;
+			offset += bucket_count;
+		}
+		for (const SortEntry& entry : entries) {
+			scratch[buckets[getDigit(entry.key, digit)]++] = entry;
+		}
+		entries.swap(scratch);
+	}
+}
@@ -0,0 +1,55 @@
+#include "game/headers/utility/thread-pool.hh"
+
+#include <utility>
+
+ThreadPool::ThreadPool(std::size_t thread_count) {
+	workers_.reserve(thread_count);
+	for (std::size_t i{0}; i < thread_count; ++i) {
+		workers_.emplace_back(&ThreadPool::workerLoop, this);
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		stopping_ = true;
+	}
+	condition_.notify_all();
+	for (std::thread& worker : workers_) {
+		worker.join();
+	}
+}
+
+std::size_t ThreadPool::getThreadCount() const {
+	return workers_.size();
+}
+
+void ThreadPool::enqueue(std::function<void()> task) {
+	// Without workers nothing would ever run the task, and its future would never be ready
+	if (workers_.empty()) {
+		task();
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		tasks_.push_back(std::move(task));
+	}
+	condition_.notify_one();
+}
+
+void ThreadPool::workerLoop() {
+	while (true) {
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock{mutex_};
+			condition_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+			if (tasks_.empty()) {
+				// Stopping, and there is no more work left
+				return;
+			}
+			task = std::move(tasks_.front());
+			tasks_.pop_front();
+		}
+		task();
+	}
+}
@@ -0,0 +1,74 @@
+#include "game/headers/utility/thread-pool.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <utility>
+
+template <typename F>
+std::future<std::invoke_result_t<F>> ThreadPool::submit(F&& task) {
+	using Result = std::invoke_result_t<F>;
+	// std::function requires a copyable callable, so the task is shared
+	auto packaged_task{std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task))};
+	std::future<Result> result{packaged_task->get_future()};
+	enqueue([packaged_task]() { (*packaged_task)(); });
+	return result;
+}
+
+template <typename F>
+void ThreadPool::parallelFor(std::size_t count, F&& func) {
+	if (count == 0) {
+		return;
+	}
+
+	struct State {
+		std::atomic<std::size_t> next{0};
+		std::size_t finished{0};
+		std::exception_ptr exception;
+		std::mutex mutex;
+		std::condition_variable condition;
+	};
+	// Helpers may start after the loop is done, so the state must outlive this call
+	auto state{std::make_shared<State>()};
+	auto* func_ptr{&func};
+
+	// Every thread claims indices until the whole range is claimed
+	auto process{[state, func_ptr, count]() {
+		std::size_t processed{0};
+		std::exception_ptr exception;
+		for (std::size_t i{state->next++}; i < count; i = state->next++) {
+			try {
+				(*func_ptr)(i);
+			} catch (...) {
+				if (!exception) {
+					exception = std::current_exception();
+				}
+			}
+			++processed;
+		}
+		if (processed == 0) {
+			return;
+		}
+		std::lock_guard<std::mutex> lock{state->mutex};
+		if (exception && !state->exception) {
+			state->exception = exception;
+		}
+		state->finished += processed;
+		if (state->finished == count) {
+			state->condition.notify_all();
+		}
+	}};
+
+	const std::size_t helper_count{std::min(workers_.size(), count - 1)};
+	for (std::size_t i{0}; i < helper_count; ++i) {
+		enqueue(process);
+	}
+	process();
+
+	std::unique_lock<std::mutex> lock{state->mutex};
+	state->condition.wait(lock, [&state, count]() { return state->finished == count; });
+	if (state->exception) {
+		std::rethrow_exception(state->exception);
+	}
+}
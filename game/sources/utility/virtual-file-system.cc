@@ -0,0 +1,117 @@
+#include "game/headers/utility/virtual-file-system.hh"
+
+#include "game/headers/utility/lz4.hh"
+
+#include <stdexcept>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+const unsigned char* AssetFile::data() const {
+	return data_;
+}
+
+std::size_t AssetFile::size() const {
+	return size_;
+}
+
+std::string_view AssetFile::getText() const {
+	return {reinterpret_cast<const char*>(data_), size_};
+}
+
+VirtualFileSystem::VirtualFileSystem() {
+	std::error_code error;
+	working_directory_ = fs::current_path(error);
+}
+
+void VirtualFileSystem::mount(const std::string& archive_path) {
+	archives_.push_back(std::make_unique<AssetArchive>(archive_path));
+}
+
+bool VirtualFileSystem::exists(const std::string& path) const {
+	const AssetArchive* archive;
+	if (find(path, archive) != nullptr) {
+		return true;
+	}
+	std::error_code error;
+	return fs::is_regular_file(path, error);
+}
+
+AssetFile VirtualFileSystem::open(const std::string& path) const {
+	AssetFile file;
+
+	const AssetArchive* archive;
+	const AssetEntry* entry{find(path, archive)};
+	if (entry == nullptr) {
+		file.mapping_ = std::make_shared<const MappedFile>(path);
+		file.data_ = file.mapping_->data();
+		file.size_ = file.mapping_->size();
+		return file;
+	}
+
+	const unsigned char* stored{archive->getFile()->data() + entry->offset};
+	if (entry->compression == AssetCompression::None) {
+		file.mapping_ = archive->getFile();
+		file.data_ = stored;
+		file.size_ = static_cast<std::size_t>(entry->size);
+		return file;
+	}
+
+	file.buffer_.resize(static_cast<std::size_t>(entry->size));
+	try {
+		lz4::decompress(stored, static_cast<std::size_t>(entry->stored_size), file.buffer_.data(), file.buffer_.size());
+	} catch (const std::runtime_error& e) {
+		throw std::runtime_error(std::string(e.what()) + ": " + path + " in " + archive->getPath());
+	}
+	file.data_ = file.buffer_.data();
+	file.size_ = file.buffer_.size();
+	return file;
+}
+
+bool VirtualFileSystem::stat(const std::string& path, AssetStatus& status) const {
+	const AssetArchive* archive;
+	if (const AssetEntry* entry{find(path, archive)}) {
+		status = {entry->size, entry->modification_time};
+		return true;
+	}
+
+	std::error_code error;
+	const std::uintmax_t size{fs::file_size(path, error)};
+	if (error) {
+		return false;
+	}
+	const fs::file_time_type modification_time{fs::last_write_time(path, error)};
+	if (error) {
+		return false;
+	}
+	status = {
+		static_cast<std::uint64_t>(size),
+		static_cast<std::int64_t>(modification_time.time_since_epoch().count())
+	};
+	return true;
+}
+
+std::string VirtualFileSystem::normalizePath(const std::string& path) const {
+	fs::path normal{fs::path(path).lexically_normal()};
+	if (normal.is_absolute() && !working_directory_.empty()) {
+		const fs::path relative{normal.lexically_relative(working_directory_)};
+		if (!relative.empty() && *relative.begin() != "..") {
+			normal = relative;
+		}
+	}
+	return normal.generic_string();
+}
+
+const AssetEntry* VirtualFileSystem::find(const std::string& path, const AssetArchive*& archive) const {
+	if (archives_.empty()) {
+		return nullptr;
+	}
+	const std::string normal_path{normalizePath(path)};
+	for (auto it{archives_.rbegin()}; it != archives_.rend(); ++it) {
+		if (const AssetEntry* entry{(*it)->find(normal_path)}) {
+			archive = it->get();
+			return entry;
+		}
+	}
+	return nullptr;
+}
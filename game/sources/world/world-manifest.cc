@@ -0,0 +1,95 @@
+#include "game/headers/world/world-manifest.hh"
+
+#include "game/headers/service-locator.hh"
+
+#include <filesystem>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+WorldManifest WorldManifest::load(const std::string& path) {
+	AssetFile manifest_file;
+	try {
+		manifest_file = ServiceLocator::getInstance().getFileSystem().open(path);
+	} catch (const std::runtime_error&) {
+		throw std::runtime_error("cannot open a world manifest: " + path);
+	}
+	std::istringstream file{std::string(manifest_file.getText())};
+	const std::filesystem::path directory{std::filesystem::path(path).parent_path()};
+
+	WorldManifest manifest;
+	std::string line;
+	std::size_t line_number{0u};
+	while (std::getline(file, line)) {
+		++line_number;
+		const std::string error_location{path + ":" + std::to_string(line_number)};
+
+		line = line.substr(0u, line.find('#'));
+		std::istringstream entry{line};
+		std::string keyword;
+		if (!(entry >> keyword)) {
+			continue;
+		}
+
+		if (keyword == "chunk_size") {
+			if (!(entry >> manifest.chunk_size_) || manifest.chunk_size_ <= 0.0f) {
+				throw std::runtime_error("invalid chunk size in a world manifest: " + error_location);
+			}
+		} else if (keyword == "origin") {
+			if (!(entry >> manifest.origin_.x >> manifest.origin_.y)) {
+				throw std::runtime_error("invalid origin in a world manifest: " + error_location);
+			}
+		} else if (keyword == "chunk") {
+			WorldChunk chunk;
+			std::string model_path;
+			if (!(entry >> chunk.x >> chunk.z >> model_path)) {
+				throw std::runtime_error("invalid chunk in a world manifest: " + error_location);
+			}
+			chunk.model_path = (directory / model_path).lexically_normal().string();
+			if (!manifest.chunk_cells_.emplace(getCellKey(chunk.x, chunk.z), manifest.chunks_.size()).second) {
+				throw std::runtime_error("duplicate chunk in a world manifest: " + error_location);
+			}
+			manifest.chunks_.push_back(std::move(chunk));
+		} else {
+			throw std::runtime_error("unknown entry in a world manifest: " + error_location);
+		}
+	}
+
+	if (manifest.chunk_size_ <= 0.0f) {
+		throw std::runtime_error("a world manifest does not set its chunk size: " + path);
+	}
+	return manifest;
+}
+
+float WorldManifest::getChunkSize() const {
+	return chunk_size_;
+}
+
+glm::vec2 WorldManifest::getOrigin() const {
+	return origin_;
+}
+
+const std::vector<WorldChunk>& WorldManifest::getChunks() const {
+	return chunks_;
+}
+
+bool WorldManifest::findChunk(int x, int z, std::size_t& index) const {
+	const auto it{chunk_cells_.find(getCellKey(x, z))};
+	if (it == chunk_cells_.end()) {
+		return false;
+	}
+	index = it->second;
+	return true;
+}
+
+glm::vec2 WorldManifest::getCellMin(int x, int z) const {
+	return origin_ + chunk_size_ * glm::vec2(static_cast<float>(x), static_cast<float>(z));
+}
+
+glm::vec2 WorldManifest::getCellMax(int x, int z) const {
+	return getCellMin(x, z) + glm::vec2(chunk_size_);
+}
+
+std::uint64_t WorldManifest::getCellKey(int x, int z) {
+	return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32u) | static_cast<std::uint32_t>(z);
+}
@@ -0,0 +1,213 @@
+#include "game/headers/world/world-streamer.hh"
+
+#include "game/headers/service-locator.hh"
+#include "game/headers/utility/memory-tracker.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <string>
+#include <utility>
+
+namespace {
+	// Textures are left out, as the cache keeps those still used by other chunks
+	std::size_t getGpuBufferBytes(const MemoryUsage& usage) {
+		return usage.getTotal(MemoryDomain::Gpu) - usage.get(MemoryDomain::Gpu, MemoryCategory::Textures);
+	}
+}
+
+WorldStreamer::WorldStreamer(
+	WorldManifest manifest,
+	ModelLoader& loader,
+	ModelRenderer& renderer,
+	WorldStreamerSettings settings
+):
+		manifest_{std::move(manifest)},
+		loader_{loader},
+		renderer_{renderer},
+		settings_{settings},
+		chunks_(manifest_.getChunks().size()) {
+	settings_.unload_radius = std::max(settings_.unload_radius, settings_.load_radius);
+}
+
+WorldStreamer::~WorldStreamer() {
+	for (std::size_t chunk : pending_chunks_) {
+		chunks_[chunk].model.wait();
+	}
+}
+
+void WorldStreamer::update(const Camera& camera) {
+	const glm::vec2 camera_pos{camera.pos.x, camera.pos.z};
+	glm::vec2 view_direction{camera.lookAt.x, camera.lookAt.z};
+	const float view_length{glm::length(view_direction)};
+	// Looking straight up, or down, every direction is as good
+	view_direction = view_length > 0.0f ? view_direction / view_length : glm::vec2(0.0f);
+
+	finishLoads(camera_pos);
+	removeDistantChunks(camera_pos);
+	startLoads(camera_pos, view_direction);
+}
+
+std::size_t WorldStreamer::getLoadedChunkCount() const {
+	return loaded_chunks_.size();
+}
+
+std::size_t WorldStreamer::getPendingChunkCount() const {
+	return pending_chunks_.size();
+}
+
+void WorldStreamer::finishLoads(const glm::vec2& camera_pos) {
+	std::size_t added_count{0u};
+	for (auto it{pending_chunks_.begin()}; it != pending_chunks_.end();) {
+		ChunkState& state{chunks_[*it]};
+		if (state.model.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+			++it;
+			continue;
+		}
+
+		// The camera left while the chunk was loading
+		if (getDistance(*it, camera_pos) > settings_.unload_radius) {
+			state.model.wait();
+			state.model = {};
+			state.stage = ChunkStage::Unloaded;
+			it = pending_chunks_.erase(it);
+			continue;
+		}
+
+		// The rest waits for the next frame
+		if (added_count == settings_.max_adds_per_frame) {
+			++it;
+			continue;
+		}
+
+		try {
+			const std::shared_ptr<Model> model{state.model.get()};
+			state.instance = renderer_.addInstance(model, glm::mat4(1.0f));
+			state.loaded_model = model;
+			state.stage = ChunkStage::Loaded;
+			loaded_chunks_.push_back(*it);
+			++added_count;
+		} catch (const std::exception& e) {
+			ServiceLocator::getInstance().getLogger()->Error(
+				"cannot load a world chunk: " + manifest_.getChunks()[*it].model_path + ": " + e.what()
+			);
+			state.stage = ChunkStage::Failed;
+		}
+		state.model = {};
+		it = pending_chunks_.erase(it);
+	}
+}
+
+void WorldStreamer::removeDistantChunks(const glm::vec2& camera_pos) {
+	std::size_t removed_count{0u};
+	for (auto it{loaded_chunks_.begin()}; it != loaded_chunks_.end() && removed_count < settings_.max_removals_per_frame;) {
+		if (getDistance(*it, camera_pos) <= settings_.unload_radius) {
+			++it;
+			continue;
+		}
+		unloadChunk(*it);
+		++removed_count;
+		it = loaded_chunks_.erase(it);
+	}
+}
+
+void WorldStreamer::startLoads(const glm::vec2& camera_pos, const glm::vec2& view_direction) {
+	if (pending_chunks_.size() >= settings_.max_pending_loads) {
+		return;
+	}
+
+	// Only the cells within the load radius are visited, however large the world is
+	struct Candidate {
+		std::size_t chunk;
+		float priority;
+	};
+	std::vector<Candidate> candidates;
+
+	const float chunk_size{manifest_.getChunkSize()};
+	const glm::vec2 origin{manifest_.getOrigin()};
+	const glm::vec2 first_cell{glm::floor((camera_pos - origin - settings_.load_radius) / chunk_size)};
+	const glm::vec2 last_cell{glm::floor((camera_pos - origin + settings_.load_radius) / chunk_size)};
+	for (int z{static_cast<int>(first_cell.y)}; z <= static_cast<int>(last_cell.y); ++z) {
+		for (int x{static_cast<int>(first_cell.x)}; x <= static_cast<int>(last_cell.x); ++x) {
+			std::size_t chunk;
+			if (!manifest_.findChunk(x, z, chunk) || chunks_[chunk].stage != ChunkStage::Unloaded) {
+				continue;
+			}
+			const float distance{getDistance(chunk, camera_pos)};
+			if (distance > settings_.load_radius) {
+				continue;
+			}
+
+			// Chunks behind the camera seem farther, by up to the behind scale
+			const glm::vec2 to_center{0.5f * (manifest_.getCellMin(x, z) + manifest_.getCellMax(x, z)) - camera_pos};
+			const float center_distance{glm::length(to_center)};
+			const float facing{center_distance > 0.0f ? glm::dot(to_center / center_distance, view_direction) : 1.0f};
+			const float scale{1.0f + 0.5f * (1.0f - facing) * (settings_.behind_distance_scale - 1.0f)};
+			candidates.push_back({chunk, distance * scale});
+		}
+	}
+
+	const std::size_t load_count{std::min({
+		candidates.size(),
+		settings_.max_loads_per_frame,
+		settings_.max_pending_loads - pending_chunks_.size()
+	})};
+	std::partial_sort(
+		candidates.begin(), candidates.begin() + load_count, candidates.end(),
+		[](const Candidate& first, const Candidate& second) {
+			return first.priority < second.priority;
+		}
+	);
+
+	for (std::size_t i{0u}; i < load_count; ++i) {
+		const std::size_t chunk{candidates[i].chunk};
+		// Chunk models are kept in RAM only as collision copies once they are uploaded,
+		// and their meshes are batched by material, as chunks never move
+		ModelLoadOptions options;
+		options.is_collision_source = true;
+		options.is_static = true;
+		chunks_[chunk].model = loader_.loadModelAsync(manifest_.getChunks()[chunk].model_path, options);
+		chunks_[chunk].stage = ChunkStage::Loading;
+		pending_chunks_.push_back(chunk);
+	}
+}
+
+void WorldStreamer::unloadChunk(std::size_t chunk) {
+	ChunkState& state{chunks_[chunk]};
+	if (!settings_.validate_gpu_memory) {
+		renderer_.removeInstance(state.instance);
+		state.loaded_model.reset();
+		state.stage = ChunkStage::Unloaded;
+		return;
+	}
+
+	// Every byte the chunk's drawable holds must leave the tracker with it, or each reload
+	// of the chunk adds to the GPU memory in use
+	std::size_t chunk_bytes{0u};
+	if (const std::shared_ptr<Model> model{state.loaded_model.lock()}) {
+		chunk_bytes = getGpuBufferBytes(renderer_.getMemoryUsage(*model));
+	}
+	const MemoryTracker& tracker{ServiceLocator::getInstance().getMemoryTracker()};
+	const std::size_t bytes_before{getGpuBufferBytes(tracker.getUsage())};
+	renderer_.removeInstance(state.instance);
+	state.loaded_model.reset();
+	state.stage = ChunkStage::Unloaded;
+	const std::size_t bytes_after{getGpuBufferBytes(tracker.getUsage())};
+
+	const std::size_t released_bytes{bytes_before > bytes_after ? bytes_before - bytes_after : 0u};
+	if (released_bytes < chunk_bytes) {
+		ServiceLocator::getInstance().getLogger()->Warning(
+			"an unloaded world chunk kept " + std::to_string(chunk_bytes - released_bytes) + " of its "
+			+ std::to_string(chunk_bytes) + " bytes of GPU buffers: " + manifest_.getChunks()[chunk].model_path
+		);
+	}
+}
+
+float WorldStreamer::getDistance(std::size_t chunk, const glm::vec2& pos) const {
+	const WorldChunk& cell{manifest_.getChunks()[chunk]};
+	const glm::vec2 min{manifest_.getCellMin(cell.x, cell.z)};
+	const glm::vec2 max{manifest_.getCellMax(cell.x, cell.z)};
+	const glm::vec2 outside{glm::max(glm::max(min - pos, pos - max), glm::vec2(0.0f))};
+	return glm::length(outside);
+}